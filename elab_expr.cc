@@ -1370,6 +1370,31 @@ unsigned PECallFunction::test_width_method_(Design*des, NetScope*scope,
 	    return expr_width_;
       }
 
+	// The sum() and product() reduction methods return a value of
+	// the element type. Only integral elements are supported.
+      if (use_darray && (method_name == "sum" || method_name == "product")) {
+	    switch (use_darray->element_base_type()) {
+		case IVL_VT_LOGIC:
+		case IVL_VT_BOOL:
+		  break;
+		default:
+		  return 0;
+	    }
+
+	    if (debug_elaborate) {
+		  cerr << get_fileline() << ": PECallFunction::test_width_method_: "
+		       << "Detected " << method_name << " method"
+		       << " of dynamic arrays." << endl;
+	    }
+
+	    expr_type_  = use_darray->element_base_type();
+	    expr_width_ = use_darray->element_width();
+	    min_width_  = expr_width_;
+	    signed_flag_= use_darray->get_signed();
+
+	    return expr_width_;
+      }
+
       if (use_darray && (method_name == "pop_back" || method_name=="pop_front")) {
 	    if (debug_elaborate) {
 		  cerr << get_fileline() << ": PECallFunction::test_width_method_: "
@@ -2683,6 +2708,39 @@ NetExpr* PECallFunction::elaborate_expr_method_(Design*des, NetScope*scope,
 		  sys_expr->parm(0, arg);
 		  return sys_expr;
 	    }
+
+	    if (method_name == "sum" || method_name == "product") {
+		  const netdarray_t*darray = net->darray_type();
+		  switch (darray->element_base_type()) {
+		      case IVL_VT_LOGIC:
+		      case IVL_VT_BOOL:
+			break;
+		      default:
+			cerr << get_fileline() << ": sorry: " << method_name
+			     << "() method is only supported for arrays of"
+			     << " integral types." << endl;
+			des->errors += 1;
+			return 0;
+		  }
+		  if (parms_.size() != 0) {
+			cerr << get_fileline() << ": error: " << method_name
+			     << "() method takes no arguments" << endl;
+			des->errors += 1;
+		  }
+		  const char*name = method_name == "sum"
+			? "$ivl_array_method$sum"
+			: "$ivl_array_method$product";
+		  NetESFunc*sys_expr = new NetESFunc(name, expr_type_,
+						     expr_width_, 1);
+		  sys_expr->cast_signed(signed_flag_);
+		  sys_expr->set_line(*this);
+
+		  NetESignal*arg = new NetESignal(net);
+		  arg->set_line(*net);
+
+		  sys_expr->parm(0, arg);
+		  return sys_expr;
+	    }
       }
 
       if (net->queue_type()) {
@@ -3611,6 +3611,33 @@ NetProc* PCallTask::elaborate_sys_task_method_(Design*des, NetScope*scope,
 	    }
       }
 
+      if (method_name == "sort" || method_name == "rsort" ||
+          method_name == "reverse") {
+	    if (nparms > 0) {
+		  cerr << get_fileline() << ": error: " << method_name
+		       << "() method takes no arguments." << endl;
+		  des->errors += 1;
+	    }
+      }
+
+	// The run time can only order elements that have a value, so
+	// arrays of class objects and the like cannot be sorted.
+      if (method_name == "sort" || method_name == "rsort") {
+	    switch (net->darray_type()->element_base_type()) {
+		case IVL_VT_BOOL:
+		case IVL_VT_LOGIC:
+		case IVL_VT_REAL:
+		case IVL_VT_STRING:
+		  break;
+		default:
+		  cerr << get_fileline() << ": sorry: " << method_name
+		       << "() method is not supported for arrays of this "
+		       << "element type." << endl;
+		  des->errors += 1;
+		  break;
+	    }
+      }
+
       for (unsigned idx = 0 ; idx < nparms ; idx += 1) {
 	    PExpr*ex = parms_[idx];
 	    if (ex != 0) {
@@ -3738,6 +3765,19 @@ NetProc* PCallTask::elaborate_method_(Design*des, NetScope*scope,
 					      "$ivl_darray_method$delete");
       }
 
+	// The ordering methods work on dynamic arrays and queues.
+      if (net->darray_type()) {
+	    if (method_name == "sort")
+		  return elaborate_sys_task_method_(des, scope, net, method_name,
+						    "$ivl_array_method$sort");
+	    else if (method_name == "rsort")
+		  return elaborate_sys_task_method_(des, scope, net, method_name,
+						    "$ivl_array_method$rsort");
+	    else if (method_name == "reverse")
+		  return elaborate_sys_task_method_(des, scope, net, method_name,
+						    "$ivl_array_method$reverse");
+      }
+
       if (net->queue_type()) {
 	    if (method_name == "push_back")
 		  return elaborate_queue_method_(des, scope, net, method_name,
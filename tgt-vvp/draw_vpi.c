@@ -502,6 +502,52 @@ void draw_vpi_task_call(ivl_statement_t tnet)
       }
 }
 
+/*
+ * A few simple system functions have native opcodes, so that calls in
+ * hot loops skip the %vpi_func call and its argument handling. The
+ * magic time functions use the same scoped handles that they get as
+ * %vpi_call arguments. These return true if the function was drawn
+ * natively, or false if the caller needs to draw a %vpi_func.
+ */
+int draw_native_func_call(ivl_expr_t fnet)
+{
+      const char*name = ivl_expr_name(fnet);
+      unsigned parm_count = ivl_expr_parms(fnet);
+
+      if (parm_count == 0 && is_magic_sfunc(name)
+	  && strcmp(name, "$realtime") != 0) {
+	    fprintf(vvp_out, "    %%pushtime/vec4 %s, %u;\n",
+		    name, ivl_expr_width(fnet));
+	    return 1;
+      }
+
+      if (parm_count == 1 && strcmp(name, "$clog2") == 0) {
+	    ivl_expr_t arg = ivl_expr_parm(fnet, 0);
+	    switch (ivl_expr_value(arg)) {
+		case IVL_VT_LOGIC:
+		case IVL_VT_BOOL:
+		  draw_eval_vec4(arg);
+		  fprintf(vvp_out, "    %%clog2 %u;\n", ivl_expr_width(fnet));
+		  return 1;
+		default:
+		  break;
+	    }
+      }
+
+      return 0;
+}
+
+int draw_native_rfunc_call(ivl_expr_t fnet)
+{
+      if (ivl_expr_parms(fnet) == 0
+	  && strcmp(ivl_expr_name(fnet), "$realtime") == 0) {
+	    fprintf(vvp_out, "    %%pushtime/real $realtime;\n");
+	    return 1;
+      }
+
+      return 0;
+}
+
 void draw_vpi_func_call(ivl_expr_t fnet)
 {
       char call_string[1024];
@@ -1012,10 +1012,28 @@ static void draw_darray_pop(ivl_expr_t expr)
                        ivl_expr_width(expr));
 }
 
+/*
+ * This function handles the reduction methods of dynamic arrays and
+ * queues, $ivl_array_method$sum and $ivl_array_method$product. The
+ * only argument is the array signal. Generate a %sum/dar or
+ * %product/dar instruction, which pushes the result to the vec4 stack.
+ */
+static void draw_darray_reduce(ivl_expr_t expr, const char*op)
+{
+      ivl_expr_t arg = ivl_expr_parm(expr, 0);
+      assert(ivl_expr_type(arg) == IVL_EX_SIGNAL);
+
+      fprintf(vvp_out, "    %%%s/dar v%p_0, %u;\n", op, ivl_expr_signal(arg),
+                       ivl_expr_width(expr));
+}
+
 static void draw_sfunc_vec4(ivl_expr_t expr)
 {
       unsigned parm_count = ivl_expr_parms(expr);
 
+      if (draw_native_func_call(expr))
+	    return;
+
 	/* Special case: If there are no arguments to print, then the
 	   %vpi_call statement is easy to draw. */
       if (parm_count == 0) {
@@ -1037,6 +1055,14 @@ static void draw_sfunc_vec4(ivl_expr_t expr)
 	    draw_darray_pop(expr);
 	    return;
       }
+      if (strcmp(ivl_expr_name(expr), "$ivl_array_method$sum")==0) {
+	    draw_darray_reduce(expr, "sum");
+	    return;
+      }
+      if (strcmp(ivl_expr_name(expr), "$ivl_array_method$product")==0) {
+	    draw_darray_reduce(expr, "product");
+	    return;
+      }
 
       draw_vpi_func_call(expr);
 }
@@ -135,6 +135,14 @@ extern void draw_vpi_func_call(ivl_expr_t expr);
 extern void draw_vpi_rfunc_call(ivl_expr_t expr);
 extern void draw_vpi_sfunc_call(ivl_expr_t expr);
 
+/*
+ * Draw a system function call with a native opcode if there is one,
+ * and return true, or return false so that the caller can use one of
+ * the draw_vpi_*_call functions.
+ */
+extern int draw_native_func_call(ivl_expr_t expr);
+extern int draw_native_rfunc_call(ivl_expr_t expr);
+
 extern void draw_class_in_scope(ivl_type_t classtype);
 
 /*
@@ -1767,6 +1767,39 @@ static int show_delete_method(ivl_statement_t net)
       return 0;
 }
 
+/*
+ * The sort(), rsort() and reverse() methods of dynamic arrays and
+ * queues reorder the array in place. The sort opcode takes flags:
+ * bit 0 selects descending order, and bit 1 compares vector elements
+ * as signed values, since the runtime array does not know that.
+ */
+static int show_sort_method(ivl_statement_t net, const char*method)
+{
+      show_stmt_file_line(net, "Array ordering method");
+
+      if (ivl_stmt_parm_count(net) != 1)
+	    return 1;
+
+      ivl_expr_t parm = ivl_stmt_parm(net, 0);
+      assert(ivl_expr_type(parm) == IVL_EX_SIGNAL);
+      ivl_signal_t var = ivl_expr_signal(parm);
+
+      if (strcmp(method, "reverse") == 0) {
+	    fprintf(vvp_out, "    %%reverse/dar v%p_0;\n", var);
+	    return 0;
+      }
+
+      ivl_type_t element_type = ivl_type_element(ivl_signal_net_type(var));
+      unsigned flags = 0;
+      if (strcmp(method, "rsort") == 0)
+	    flags |= 1;
+      if (ivl_type_signed(element_type))
+	    flags |= 2;
+
+      fprintf(vvp_out, "    %%sort/dar v%p_0, %u;\n", var, flags);
+      return 0;
+}
+
 static int show_insert_method(ivl_statement_t net)
 {
       show_stmt_file_line(net, "queue: insert");
@@ -1872,6 +1905,15 @@ static int show_system_task_call(ivl_statement_t net)
       if (strcmp(stmt_name,"$ivl_darray_method$delete") == 0)
 	    return show_delete_method(net);
 
+      if (strcmp(stmt_name,"$ivl_array_method$sort") == 0)
+	    return show_sort_method(net, "sort");
+
+      if (strcmp(stmt_name,"$ivl_array_method$rsort") == 0)
+	    return show_sort_method(net, "rsort");
+
+      if (strcmp(stmt_name,"$ivl_array_method$reverse") == 0)
+	    return show_sort_method(net, "reverse");
+
       if (strcmp(stmt_name,"$ivl_queue_method$insert") == 0)
 	    return show_insert_method(net);
 
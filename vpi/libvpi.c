@@ -284,6 +284,45 @@ void vpip_set_return_value(int value)
       assert(vpip_routines);
       vpip_routines->set_return_value(value);
 }
+PLI_INT32 vpip_trace_register(vpip_trace_handler_t func, void*data)
+{
+      assert(vpip_routines);
+      return vpip_routines->trace_register(func, data);
+}
+void vpip_trace_unregister(PLI_INT32 tracer)
+{
+      assert(vpip_routines);
+      vpip_routines->trace_unregister(tracer);
+}
+PLI_INT32 vpip_trace_add(PLI_INT32 tracer, vpiHandle ref, void*user_data)
+{
+      assert(vpip_routines);
+      return vpip_routines->trace_add(tracer, ref, user_data);
+}
+PLI_INT32 vpip_get_values(const vpiHandle*refs, PLI_UINT32 count,
+                          PLI_INT32 format, void*buf)
+{
+      assert(vpip_routines);
+      return vpip_routines->get_values(refs, count, format, buf);
+}
+PLI_INT32 vpip_put_values(const vpiHandle*refs, PLI_UINT32 count,
+                          PLI_INT32 format, const void*buf)
+{
+      assert(vpip_routines);
+      return vpip_routines->put_values(refs, count, format, buf);
+}
+PLI_INT32 vpip_put_array_words(vpiHandle ref, PLI_INT32 addr, PLI_INT32 incr,
+                               PLI_UINT32 count, const s_vpi_vecval*buf)
+{
+      assert(vpip_routines);
+      return vpip_routines->put_array_words(ref, addr, incr, count, buf);
+}
+PLI_INT32 vpip_get_array_words(vpiHandle ref, PLI_INT32 addr, PLI_INT32 incr,
+                               PLI_UINT32 count, s_vpi_vecval*buf)
+{
+      assert(vpip_routines);
+      return vpip_routines->get_array_words(ref, addr, incr, count, buf);
+}
 
 DLLEXPORT PLI_UINT32 vpip_set_callback(vpip_routines_s*routines, PLI_UINT32 version)
 {
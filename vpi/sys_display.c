@@ -82,6 +82,8 @@ static void my_mcd_rawwrite(PLI_UINT32 mcd, const char*buf, size_t count)
 
 struct timeformat_info_s timeformat_info = { 0, 0, 0, 20 };
 
+struct format_ops;
+
 struct strobe_cb_info {
       const char*name;
       char*filename;
@@ -91,6 +93,10 @@ struct strobe_cb_info {
       vpiHandle*items;
       unsigned nitems;
       unsigned fd_mcd;
+	/* If not nil, the vpiType of each item and the compiled format
+	   of the items that are string constants. */
+      const PLI_INT32*types;
+      struct format_ops*const*formats;
 };
 
 /*
@@ -878,52 +884,143 @@ static unsigned int get_format_char(char **rtn, int ljust, int plus,
   return size - 1;
 }
 
-/* We can't use the normal str functions on the return value since
- * %u and %z can insert NULL characters into the stream. */
-static unsigned int get_format(char **rtn, char *fmt,
-                               const struct strobe_cb_info *info, unsigned int *idx)
+/* Make sure the display result has room for need characters. The
+ * buffer grows geometrically so that a line built from many items is
+ * not copied over and over again. */
+static char *display_grow(char *rtn, unsigned int *cap, unsigned int need)
 {
-  char *cp = fmt;
-  unsigned int size;
+  if (need > *cap) {
+    while (need > *cap) *cap *= 2;
+    rtn = realloc(rtn, *cap*sizeof(char));
+  }
+  return rtn;
+}
 
-  *rtn = strdup("");
-  size = 1;
+/*
+ * A format string is parsed into a list of literal text and
+ * conversions. The format of a string constant argument is parsed
+ * once when the call is compiled (see display_call_get) and only the
+ * list is run when the task is called.
+ */
+struct format_op {
+	/* The literal text, or nil for a conversion. */
+      const char*text;
+      unsigned len;
+      int ljust, plus, ld_zero, width, prec;
+      char fmt;
+};
+
+struct format_ops {
+	/* The literal text points into this copy of the format. */
+      char*str;
+      unsigned nops;
+      struct format_op*ops;
+};
+
+static struct format_ops *format_compile(const char *fmt)
+{
+  struct format_ops *fops = malloc(sizeof(struct format_ops));
+  unsigned int cap = 0;
+  char *cp;
+
+  fops->str = strdup(fmt);
+  fops->nops = 0;
+  fops->ops = 0;
+  cp = fops->str;
   while (*cp) {
     size_t cnt = strcspn(cp, "%");
+    struct format_op *op;
+
+    if (fops->nops == cap) {
+      cap = cap ? 2*cap : 8;
+      fops->ops = realloc(fops->ops, cap*sizeof(struct format_op));
+    }
+    op = fops->ops + fops->nops;
+    fops->nops += 1;
 
     if (cnt > 0) {
-      *rtn = realloc(*rtn, (size+cnt)*sizeof(char));
-      memcpy(*rtn+size-1, cp, cnt);
-      size += cnt;
+      op->text = cp;
+      op->len = cnt;
       cp += cnt;
     } else {
-      int ljust = 0, plus = 0, ld_zero = 0, width = -1, prec = -1;
-      char *result;
+      op->text = 0;
+      op->len = 0;
+      op->ljust = 0;
+      op->plus = 0;
+      op->ld_zero = 0;
+      op->width = -1;
+      op->prec = -1;
 
       cp += 1;
       while ((*cp == '-') || (*cp == '+')) {
-        if (*cp == '-') ljust = 1;
-        else plus = 1;
+        if (*cp == '-') op->ljust = 1;
+        else op->plus = 1;
         cp += 1;
       }
       if (*cp == '0') {
-        ld_zero = 1;
+        op->ld_zero = 1;
         cp += 1;
       }
-      if (isdigit((int)*cp)) width = strtoul(cp, &cp, 10);
+      if (isdigit((int)*cp)) op->width = strtoul(cp, &cp, 10);
       if (*cp == '.') {
         cp += 1;
-        prec = strtoul(cp, &cp, 10);
+        op->prec = strtoul(cp, &cp, 10);
       }
-      cnt = get_format_char(&result, ljust, plus, ld_zero, width, prec, *cp,
-                            info, idx);
-      *rtn = realloc(*rtn, (size+cnt)*sizeof(char));
-      memcpy(*rtn+size-1, result, cnt);
-      free(result);
-      size += cnt;
+      op->fmt = *cp;
       if (*cp) cp += 1;
     }
   }
+
+  return fops;
+}
+
+static void format_free(struct format_ops *fops)
+{
+  if (fops == 0) return;
+  free(fops->str);
+  free(fops->ops);
+  free(fops);
+}
+
+/* Run a compiled format, appending the result to the buffer at *rtn,
+ * which holds *size-1 characters and has room for *cap. */
+static void format_run(char **rtn, unsigned int *size, unsigned int *cap,
+                       const struct format_ops *fops,
+                       const struct strobe_cb_info *info, unsigned int *idx)
+{
+  unsigned int opx;
+
+  for (opx = 0; opx < fops->nops; opx += 1) {
+    const struct format_op *op = fops->ops + opx;
+
+    if (op->text) {
+      *rtn = display_grow(*rtn, cap, *size+op->len);
+      memcpy(*rtn+*size-1, op->text, op->len);
+      *size += op->len;
+    } else {
+      char *result;
+      unsigned int cnt = get_format_char(&result, op->ljust, op->plus,
+                                         op->ld_zero, op->width, op->prec,
+                                         op->fmt, info, idx);
+      *rtn = display_grow(*rtn, cap, *size+cnt);
+      memcpy(*rtn+*size-1, result, cnt);
+      free(result);
+      *size += cnt;
+    }
+  }
+}
+
+/* We can't use the normal str functions on the return value since
+ * %u and %z can insert NULL characters into the stream. */
+static unsigned int get_format(char **rtn, char *fmt,
+                               const struct strobe_cb_info *info, unsigned int *idx)
+{
+  struct format_ops *fops = format_compile(fmt);
+  unsigned int size = 1, cap = 256;
+
+  *rtn = malloc(cap*sizeof(char));
+  format_run(rtn, &size, &cap, fops, info, idx);
+  format_free(fops);
   *(*rtn+size-1) = '\0';
   return size - 1;
 }
@@ -962,19 +1059,25 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
   char *result, *fmt, *rtn, *func_name;
   const char *cresult;
   s_vpi_value value;
-  unsigned int idx, size, width;
+  unsigned int idx, size, width, cap;
   char buf[256];
 
-  rtn = strdup("");
+  cap = 256;
+  rtn = malloc(cap*sizeof(char));
   size = 1;
   for  (idx = 0; idx < info->nitems; idx += 1) {
     vpiHandle item = info->items[idx];
 
-    switch (vpi_get(vpiType, item)) {
+    switch (info->types ? info->types[idx] : vpi_get(vpiType, item)) {
 
       case vpiConstant:
       case vpiParameter:
-        if (vpi_get(vpiConstType, item) == vpiStringConst) {
+        if (info->formats && info->formats[idx]) {
+            /* A precompiled format appends directly to the result. */
+          format_run(&rtn, &size, &cap, info->formats[idx], info, &idx);
+          width = 0;
+          break;
+        } else if (vpi_get(vpiConstType, item) == vpiStringConst) {
           value.format = vpiStringVal;
           vpi_get_value(item, &value);
           fmt = strdup(value.value.str);
@@ -1000,7 +1103,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
         } else {
           width = get_numeric(&result, info, item);
         }
-        rtn = realloc(rtn, (size+width)*sizeof(char));
+        rtn = display_grow(rtn, &cap, size+width);
         memcpy(rtn+size-1, result, width);
         free(result);
         break;
@@ -1016,7 +1119,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
       case vpiMemoryWord:
       case vpiPartSelect:
         width = get_numeric(&result, info, item);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
+        rtn = display_grow(rtn, &cap, size+width);
         memcpy(rtn+size-1, result, width);
         free(result);
         break;
@@ -1031,7 +1134,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
                  vpi_get(vpiTimeUnit, info->scope));
         width = strlen(buf);
         if (width  < timeformat_info.width) width = timeformat_info.width;
-        rtn = realloc(rtn, (size+width)*sizeof(char));
+        rtn = display_grow(rtn, &cap, size+width);
         sprintf(rtn+size-1, "%*s", width, buf);
         break;
 
@@ -1052,7 +1155,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
         sprintf(buf, compatible_flag ? "%g" : "%#g", value.value.real);
 #endif
         width = strlen(buf);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
+        rtn = display_grow(rtn, &cap, size+width);
         memcpy(rtn+size-1, buf, width);
         break;
 
@@ -1064,7 +1167,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
 	fmt = strdup(value.value.str);
 	width = get_format(&result, fmt, info, &idx);
 	free(fmt);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
+        rtn = display_grow(rtn, &cap, size+width);
         memcpy(rtn+size-1, result, width);
         free(result);
 	break;
@@ -1076,7 +1179,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           vpi_get_value(item, &value);
           width = strlen(value.value.str);
           if (width  < 20) width = 20;
-          rtn = realloc(rtn, (size+width)*sizeof(char));
+          rtn = display_grow(rtn, &cap, size+width);
           sprintf(rtn+size-1, "%*s", width, value.value.str);
 
         } else if (strcmp(func_name, "$stime") == 0) {
@@ -1084,7 +1187,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           vpi_get_value(item, &value);
           width = strlen(value.value.str);
           if (width  < 10) width = 10;
-          rtn = realloc(rtn, (size+width)*sizeof(char));
+          rtn = display_grow(rtn, &cap, size+width);
           sprintf(rtn+size-1, "%*s", width, value.value.str);
 
         } else if (strcmp(func_name, "$simtime") == 0) {
@@ -1092,7 +1195,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           vpi_get_value(item, &value);
           width = strlen(value.value.str);
           if (width  < 20) width = 20;
-          rtn = realloc(rtn, (size+width)*sizeof(char));
+          rtn = display_grow(rtn, &cap, size+width);
           sprintf(rtn+size-1, "%*s", width, value.value.str);
 
         } else if (strcmp(func_name, "$realtime") == 0) {
@@ -1104,7 +1207,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
           vpi_get_value(item, &value);
           sprintf(buf, "%.*f", use_prec, value.value.real);
           width = strlen(buf);
-          rtn = realloc(rtn, (size+width)*sizeof(char));
+          rtn = display_grow(rtn, &cap, size+width);
           sprintf(rtn+size-1, "%*s", width, buf);
 
         } else {
@@ -1112,7 +1215,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
                      info->filename, info->lineno, info->name, func_name);
           strcpy(buf, "<?>");
           width = strlen(buf);
-          rtn = realloc(rtn, (size+width)*sizeof(char));
+          rtn = display_grow(rtn, &cap, size+width);
           memcpy(rtn+size-1, buf, width);
         }
         break;
@@ -1123,7 +1226,7 @@ static char *get_display(unsigned int *rtnsz, const struct strobe_cb_info *info)
                    info->name);
         cresult = "<?>";
         width = strlen(cresult);
-        rtn = realloc(rtn, (size+width)*sizeof(char));
+        rtn = display_grow(rtn, &cap, size+width);
         memcpy(rtn+size-1, cresult, width);
         break;
     }
@@ -1225,6 +1328,130 @@ static int sys_check_args(vpiHandle callh, vpiHandle argv, const PLI_BYTE8*name,
       return ret;
 }
 
+/*
+ * The per call information for the $display, $swrite and $sformat
+ * based tasks is gathered once, when the call is compiled, and kept
+ * in the user data of the call. The type of each argument is saved
+ * and the format of each string constant argument is compiled so the
+ * calltf only needs to fetch the argument values.
+ */
+struct display_call {
+      char*filename;
+      int lineno;
+      int default_format;
+      vpiHandle scope;
+	/* The file descriptor/MCD or the destination variable. */
+      vpiHandle dest;
+	/* The $sformat format argument and its compiled format. */
+      vpiHandle fmt_item;
+      struct format_ops*fmt;
+      vpiHandle*items;
+      unsigned nitems;
+      PLI_INT32*types;
+      struct format_ops**formats;
+      struct display_call*next;
+};
+
+static struct display_call*display_call_list = 0;
+
+static struct format_ops* compile_string_const(vpiHandle item, PLI_INT32 type)
+{
+      s_vpi_value val;
+
+      if (type != vpiConstant && type != vpiParameter) return 0;
+      if (vpi_get(vpiConstType, item) != vpiStringConst) return 0;
+
+      val.format = vpiStringVal;
+      vpi_get_value(item, &val);
+      return format_compile(val.value.str);
+}
+
+static struct display_call* display_call_get(vpiHandle callh,
+                                             const char*name,
+                                             int has_dest, int has_fmt)
+{
+      struct display_call*call = vpi_get_userdata(callh);
+      struct strobe_cb_info info;
+      vpiHandle argv;
+      unsigned idx;
+
+      if (call) return call;
+
+      call = calloc(1, sizeof(struct display_call));
+      call->filename = strdup(vpi_get_str(vpiFile, callh));
+      call->lineno = (int)vpi_get(vpiLineNo, callh);
+      call->default_format = get_default_format(name);
+      call->scope = vpi_handle(vpiScope, callh);
+      assert(call->scope);
+
+      argv = vpi_iterate(vpiArgument, callh);
+      if (argv && has_dest) {
+	    call->dest = vpi_scan(argv);
+	    if (call->dest == 0) argv = 0;
+      }
+      if (argv && has_fmt) {
+	    call->fmt_item = vpi_scan(argv);
+	    if (call->fmt_item == 0) {
+		  argv = 0;
+	    } else {
+		  call->fmt = compile_string_const(call->fmt_item,
+		                                 vpi_get(vpiType, call->fmt_item));
+	    }
+      }
+      array_from_iterator(&info, argv);
+      call->items = info.items;
+      call->nitems = info.nitems;
+
+      if (call->nitems > 0) {
+	    call->types = malloc(call->nitems*sizeof(PLI_INT32));
+	    call->formats = malloc(call->nitems*sizeof(struct format_ops*));
+      }
+      for (idx = 0 ;  idx < call->nitems ;  idx += 1) {
+	    call->types[idx] = vpi_get(vpiType, call->items[idx]);
+	    call->formats[idx] = compile_string_const(call->items[idx],
+	                                              call->types[idx]);
+      }
+
+      call->next = display_call_list;
+      display_call_list = call;
+      vpi_put_userdata(callh, call);
+      return call;
+}
+
+static void display_call_info(struct strobe_cb_info*info,
+                              const struct display_call*call,
+                              const char*name)
+{
+      info->name = name;
+      info->filename = call->filename;
+      info->lineno = call->lineno;
+      info->default_format = call->default_format;
+      info->scope = call->scope;
+      info->items = call->items;
+      info->nitems = call->nitems;
+      info->fd_mcd = 0;
+      info->types = call->types;
+      info->formats = call->formats;
+}
+
+static void display_call_delete_all(void)
+{
+      while (display_call_list) {
+	    struct display_call*call = display_call_list;
+	    unsigned idx;
+	    display_call_list = call->next;
+
+	    for (idx = 0 ;  idx < call->nitems ;  idx += 1)
+		  format_free(call->formats[idx]);
+	    format_free(call->fmt);
+	    free(call->formats);
+	    free(call->types);
+	    free(call->items);
+	    free(call->filename);
+	    free(call);
+      }
+}
+
 /* Common compiletf routine. */
 static PLI_INT32 sys_common_compiletf(ICARUS_VPI_CONST PLI_BYTE8*name, int no_auto,
                                       int is_monitor)
@@ -1263,15 +1490,20 @@ static PLI_INT32 sys_common_compiletf(ICARUS_VPI_CONST PLI_BYTE8*name, int no_au
 /* Check the $display, $write, $fdisplay and $fwrite based tasks. */
 static PLI_INT32 sys_display_compiletf(ICARUS_VPI_CONST PLI_BYTE8*name)
 {
+      vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
+
 	/* These tasks can have automatic variables and are not monitor. */
-      return sys_common_compiletf(name, 0, 0);
+      sys_common_compiletf(name, 0, 0);
+      display_call_get(callh, name, name[1] == 'f', 0);
+      return 0;
 }
 
 /* This implements the $sformatf, $display/$fdisplay
  * and the $write/$fwrite based tasks. */
 static PLI_INT32 sys_display_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, scope;
+      vpiHandle callh;
+      struct display_call*call;
       struct strobe_cb_info info;
       char* result;
       unsigned int size;
@@ -1279,13 +1511,14 @@ static PLI_INT32 sys_display_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       s_vpi_value val;
 
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
+	/* The call information was built and cached by the compiletf
+	 * (including for $sformatf), so this only finds that entry. */
+      call = display_call_get(callh, name, name[1] == 'f', 0);
 
 	/* Get the file/MC descriptor and verify it is valid. */
       if (name[1] == 'f') {
-	    vpiHandle fd = vpi_scan(argv);
-	    if (get_fd_mcd_from_arg(&fd_mcd, fd, callh, name)) {
-		  vpi_free_object(argv);
+	    if (call->dest == 0 ||
+	        get_fd_mcd_from_arg(&fd_mcd, call->dest, callh, name)) {
 		  return 0;
 	    }
       } else if (strncmp(name, "$sformatf", 9) == 0) {
@@ -1296,25 +1529,20 @@ static PLI_INT32 sys_display_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 	    fd_mcd = 1;
       }
 
-      scope = vpi_handle(vpiScope, callh);
-      assert(scope);
 	/* We could use vpi_get_str(vpiName, callh) to get the task name,
 	 * but name is already defined. */
-      info.name = name;
-      info.filename = strdup(vpi_get_str(vpiFile, callh));
-      info.lineno = (int)vpi_get(vpiLineNo, callh);
-      info.default_format = get_default_format(name);
-      info.scope = scope;
-      array_from_iterator(&info, argv);
+      display_call_info(&info, call, name);
 
 	/* Because %u and %z may put embedded NULL characters into the
 	 * returned string strlen() may not match the real size! */
       result = get_display(&size, &info);
 
       if (fd_mcd > 0) {
-	     my_mcd_rawwrite(fd_mcd, result, size);
+	       /* The result always has room for the trailing NULL, so
+	        * the newline can replace it and go out in one write. */
 	     if ((strncmp(name,"$display",8) == 0) ||
-	         (strncmp(name,"$fdisplay",9) == 0)) my_mcd_rawwrite(fd_mcd, "\n", 1);
+	         (strncmp(name,"$fdisplay",9) == 0)) result[size++] = '\n';
+	     my_mcd_rawwrite(fd_mcd, result, size);
       } else {
 	       /* Return as a string ($sformatf) */
 	     val.format = vpiStringVal;
@@ -1323,8 +1551,6 @@ static PLI_INT32 sys_display_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       }
 
       free(result);
-      free(info.filename);
-      free(info.items);
       return 0;
 }
 
@@ -1348,8 +1574,8 @@ static PLI_INT32 strobe_cb(p_cb_data cb)
 	      /* Because %u and %z may put embedded NULL characters into the
 	       * returned string strlen() may not match the real size! */
 	    result = get_display(&size, info);
+	    result[size++] = '\n';
 	    my_mcd_rawwrite(info->fd_mcd, result, size);
-	    my_mcd_rawwrite(info->fd_mcd, "\n", 1);
 	    free(result);
       }
 
@@ -1427,7 +1653,7 @@ static PLI_INT32 sys_strobe_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
  * though that monitor may be watching many variables).
  */
 
-static struct strobe_cb_info monitor_info = { 0, 0, 0, 0, 0, 0, 0, 0 };
+static struct strobe_cb_info monitor_info = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 static vpiHandle *monitor_callbacks = 0;
 static int monitor_scheduled = 0;
 static int monitor_enabled = 1;
@@ -1442,8 +1668,8 @@ static PLI_INT32 monitor_cb_2(p_cb_data cb)
 	/* Because %u and %z may put embedded NULL characters into the
 	 * returned string strlen() may not match the real size! */
       result = get_display(&size, &monitor_info);
+      result[size++] = '\n';
       my_mcd_rawwrite(monitor_info.fd_mcd, result, size);
-      my_mcd_rawwrite(monitor_info.fd_mcd, "\n", 1);
       monitor_scheduled = 0;
       free(result);
       return 0;
@@ -1621,44 +1847,36 @@ static PLI_INT32 sys_swrite_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
   }
 
   if (sys_check_args(callh, argv, name, 0, 0)) vpi_control(vpiFinish, 1);
+  display_call_get(callh, name, 1, 0);
   return 0;
 }
 
 static PLI_INT32 sys_swrite_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-  vpiHandle callh, argv, reg, scope;
+  vpiHandle callh;
+  struct display_call *call;
   struct strobe_cb_info info;
   s_vpi_value val;
   unsigned int size;
 
   callh = vpi_handle(vpiSysTfCall, 0);
-  argv = vpi_iterate(vpiArgument, callh);
-  reg = vpi_scan(argv);
+  call = display_call_get(callh, name, 1, 0);
 
-  scope = vpi_handle(vpiScope, callh);
-  assert(scope);
   /* We could use vpi_get_str(vpiName, callh) to get the task name, but
    * name is already defined. */
-  info.name = name;
-  info.filename = strdup(vpi_get_str(vpiFile, callh));
-  info.lineno = (int)vpi_get(vpiLineNo, callh);
-  info.default_format = get_default_format(name);
-  info.scope = scope;
-  array_from_iterator(&info, argv);
+  display_call_info(&info, call, name);
 
   /* Because %u and %z may put embedded NULL characters into the returned
    * string strlen() may not match the real size! */
   val.value.str = get_display(&size, &info);
   val.format = vpiStringVal;
-  vpi_put_value(reg, &val, 0, vpiNoDelay);
+  vpi_put_value(call->dest, &val, 0, vpiNoDelay);
   if (size != strlen(val.value.str)) {
     vpi_printf("WARNING: %s:%d: %s returned a value with an embedded NULL "
                "(see %%u/%%z).\n", info.filename, info.lineno, name);
   }
 
   free(val.value.str);
-  free(info.filename);
-  free(info.items);
   return 0;
 }
 
@@ -1710,37 +1928,41 @@ static PLI_INT32 sys_sformat_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
   }
 
   if (sys_check_args(callh, argv, name, 0, 0)) vpi_control(vpiFinish, 1);
+  display_call_get(callh, name, 1, 1);
   return 0;
 }
 
 static PLI_INT32 sys_sformat_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-  vpiHandle callh, argv, reg, scope;
+  vpiHandle callh;
+  struct display_call *call;
   struct strobe_cb_info info;
   s_vpi_value val;
-  char *result, *fmt;
+  char *result;
   unsigned int idx, size;
 
   callh = vpi_handle(vpiSysTfCall, 0);
-  argv = vpi_iterate(vpiArgument, callh);
-  reg = vpi_scan(argv);
-  val.format = vpiStringVal;
-  vpi_get_value(vpi_scan(argv), &val);
-  fmt = strdup(val.value.str);
+  call = display_call_get(callh, name, 1, 1);
 
-  scope = vpi_handle(vpiScope, callh);
-  assert(scope);
   /* We could use vpi_get_str(vpiName, callh) to get the task name, but
    * name is already defined. */
-  info.name = name;
-  info.filename = strdup(vpi_get_str(vpiFile, callh));
-  info.lineno = (int)vpi_get(vpiLineNo, callh);
-  info.default_format = get_default_format(name);
-  info.scope = scope;
-  array_from_iterator(&info, argv);
+  display_call_info(&info, call, name);
   idx = -1;
-  size = get_format(&result, fmt, &info, &idx);
-  free(fmt);
+  if (call->fmt) {
+    unsigned int cap = 256;
+    result = malloc(cap*sizeof(char));
+    size = 1;
+    format_run(&result, &size, &cap, call->fmt, &info, &idx);
+    result[size-1] = '\0';
+    size -= 1;
+  } else {
+    char *fmt;
+    val.format = vpiStringVal;
+    vpi_get_value(call->fmt_item, &val);
+    fmt = strdup(val.value.str);
+    size = get_format(&result, fmt, &info, &idx);
+    free(fmt);
+  }
 
   if (idx+1< info.nitems) {
     vpi_printf("WARNING: %s:%d: %s has %d extra argument(s).\n",
@@ -1750,15 +1972,13 @@ static PLI_INT32 sys_sformat_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
   val.value.str = result;
   val.format = vpiStringVal;
-  vpi_put_value(reg, &val, 0, vpiNoDelay);
+  vpi_put_value(call->dest, &val, 0, vpiNoDelay);
   if (size != strlen(val.value.str)) {
     vpi_printf("WARNING: %s:%d: %s returned a value with an embedded NULL "
                "(see %%u/%%z).\n", info.filename, info.lineno, name);
   }
 
   free(val.value.str);
-  free(info.filename);
-  free(info.items);
   return 0;
 }
 
@@ -1799,6 +2019,7 @@ static PLI_INT32 sys_sformatf_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
   }
 
   if (sys_check_args(callh, argv, name, 0, 0)) vpi_control(vpiFinish, 1);
+  display_call_get(callh, name, 0, 0);
   return 0;
 }
 
@@ -2097,6 +2318,8 @@ static PLI_INT32 sys_severity_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       info.default_format = vpiDecStrVal;
       info.scope = scope;
       array_from_iterator(&info, argv);
+      info.types = 0;
+      info.formats = 0;
 
       vpi_printf("%s: %s:%d: ", sstr, info.filename, info.lineno);
 
@@ -2148,6 +2371,8 @@ static PLI_INT32 sys_end_of_simulation(p_cb_data cb_data)
 
       free(timeformat_info.suff);
       timeformat_info.suff = 0;
+
+      display_call_delete_all();
       return 0;
 }
 
@@ -54,6 +54,8 @@ static PLI_UINT64 vcd_cur_time = 0;
 static int dump_is_off = 0;
 static long dump_limit = 0;
 static int dump_is_full = 0;
+  /* The native value change tracer, see vpip_trace_register(). */
+static PLI_INT32 fst_tracer = 0;
 static int finish_status = 0;
 
 
@@ -165,6 +167,21 @@ static PLI_INT32 variable_cb_2(p_cb_data cause)
       return 0;
 }
 
+/*
+ * Check if the dump file has grown past the $dumplimit. If it has then
+ * mark the dump as full and return true.
+ */
+static int dump_limit_exceeded(void)
+{
+      if ((dump_limit > 0) && fstWriterGetDumpSizeLimitReached(dump_file)) {
+            dump_is_full = 1;
+            vpi_printf("WARNING: Dump file limit (%ld bytes) "
+                               "exceeded.\n", dump_limit);
+            return 1;
+      }
+      return 0;
+}
+
 static PLI_INT32 variable_cb_1(p_cb_data cause)
 {
       struct t_cb_data cb;
@@ -175,12 +192,7 @@ static PLI_INT32 variable_cb_1(p_cb_data cause)
       if (dump_header_pending()) return 0;
       if (info->scheduled) return 0;
 
-      if ((dump_limit > 0) && fstWriterGetDumpSizeLimitReached(dump_file)) {
-            dump_is_full = 1;
-            vpi_printf("WARNING: Dump file limit (%ld bytes) "
-                               "exceeded.\n", dump_limit);
-            return 0;
-      }
+      if (dump_limit_exceeded()) return 0;
 
       if (!vcd_dmp_list) {
           cb = *cause;
@@ -197,6 +209,42 @@ static PLI_INT32 variable_cb_1(p_cb_data cause)
       return 0;
 }
 
+/*
+ * Signals that are traced natively by the run time (see vpip_trace_add)
+ * have their values delivered here as raw vecval words, once per time
+ * step, so they can be written without any vpi_get_value() formatting.
+ */
+static void variable_trace_cb(PLI_UINT64 now, const s_vpip_trace_rec*recs,
+                              unsigned count, void*data)
+{
+      unsigned idx;
+
+      (void)data; /* Parameter is not used. */
+
+      if (dump_is_full) return;
+      if (dump_is_off) return;
+      if (dump_header_pending()) return;
+	/* The $dumpvars checkpoint already has these values. */
+      if (now == dumpvars_time) return;
+
+      if (dump_limit_exceeded()) return;
+
+      if (now != vcd_cur_time) {
+	    fstWriterEmitTimeChange(dump_file, now);
+	    vcd_cur_time = now;
+      }
+
+      for (idx = 0 ;  idx < count ;  idx += 1) {
+	    const s_vpip_trace_rec*rec = recs + idx;
+	    struct vcd_info*info = (struct vcd_info*)rec->user_data;
+	    if (rec->size == 0)
+		  fstWriterEmitValueChange(dump_file, info->handle, &rec->real);
+	    else
+		  fstWriterEmitValueChange(dump_file, info->handle,
+		                           vcd_trace_rec_bits(rec));
+      }
+}
+
 static PLI_INT32 dumpvars_cb(p_cb_data cause)
 {
       if (dumpvars_status != 1) return 0;
@@ -225,6 +273,8 @@ static PLI_INT32 finish_cb(p_cb_data cause)
       if (finish_status != 0) return 0;
 
       finish_status = 1;
+      vpip_trace_unregister(fst_tracer);
+      fst_tracer = 0;
 
       dumpvars_time = timerec_to_time64(cause->time);
 
@@ -274,6 +324,8 @@ __inline__ static int install_dumpvars_callback(void)
 
       vpi_register_cb(&cb);
 
+      fst_tracer = vpip_trace_register(variable_trace_cb, 0);
+
       dumpvars_status = 1;
       return 0;
 }
@@ -656,7 +708,13 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 		  info->next  = vcd_list;
 		  vcd_list    = info;
 
-		  info->cb    = vpi_register_cb(&cb);
+		    /* Prefer the native run time trace, and only fall
+		     * back to a value change callback if the signal
+		     * cannot be traced that way. */
+		  if (vpip_trace_add(fst_tracer, item, info))
+			info->cb = 0;
+		  else
+			info->cb = vpi_register_cb(&cb);
 	    }
 
 	    break;
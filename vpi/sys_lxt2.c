@@ -112,6 +112,8 @@ static PLI_UINT64 vcd_cur_time = 0;
 static int dump_is_off = 0;
 static long dump_limit = 0;
 static int dump_is_full = 0;
+  /* The native value change tracer, see vpip_trace_register(). */
+static PLI_INT32 lxt2_tracer = 0;
 static int finish_status = 0;
 
 
@@ -285,6 +287,21 @@ static PLI_INT32 variable_cb_2(p_cb_data cause)
       return 0;
 }
 
+/*
+ * Check if the dump file has grown past the $dumplimit. If it has then
+ * mark the dump as full and return true.
+ */
+static int dump_limit_exceeded(void)
+{
+      if ((dump_limit > 0) && (ftell(dump_file->handle) > dump_limit)) {
+            dump_is_full = 1;
+            vpi_printf("WARNING: Dump file limit (%ld bytes) "
+                       "exceeded.\n", dump_limit);
+            return 1;
+      }
+      return 0;
+}
+
 static PLI_INT32 variable_cb_1(p_cb_data cause)
 {
       struct t_cb_data cb;
@@ -295,12 +312,7 @@ static PLI_INT32 variable_cb_1(p_cb_data cause)
       if (dump_header_pending()) return 0;
       if (info->dmp_next) return 0;
 
-      if ((dump_limit > 0) && (ftell(dump_file->handle) > dump_limit)) {
-            dump_is_full = 1;
-            vpi_printf("WARNING: Dump file limit (%ld bytes) "
-                       "exceeded.\n", dump_limit);
-            return 0;
-      }
+      if (dump_limit_exceeded()) return 0;
 
       if (vcd_dmp_list == VCD_INFO_ENDP) {
           cb = *cause;
@@ -316,6 +328,41 @@ static PLI_INT32 variable_cb_1(p_cb_data cause)
       return 0;
 }
 
+/*
+ * Signals that are traced natively by the run time (see vpip_trace_add)
+ * have their values delivered here as raw vecval words, once per time
+ * step, so they can be written without any vpi_get_value() formatting.
+ */
+static void variable_trace_cb(PLI_UINT64 now, const s_vpip_trace_rec*recs,
+                              unsigned count, void*data)
+{
+      unsigned idx;
+
+      (void)data; /* Parameter is not used. */
+
+      if (dump_is_full) return;
+      if (dump_is_off) return;
+      if (dump_header_pending()) return;
+	/* The $dumpvars checkpoint already has these values. */
+      if (now == dumpvars_time) return;
+
+      if (dump_limit_exceeded()) return;
+
+      if (now != vcd_cur_time) {
+	    vcd_work_set_time(now);
+	    vcd_cur_time = now;
+      }
+
+      for (idx = 0 ;  idx < count ;  idx += 1) {
+	    const s_vpip_trace_rec*rec = recs + idx;
+	    struct vcd_info*info = (struct vcd_info*)rec->user_data;
+	    if (rec->size == 0)
+		  vcd_work_emit_double(info->sym, rec->real);
+	    else
+		  vcd_work_emit_bits(info->sym, vcd_trace_rec_bits(rec));
+      }
+}
+
 static PLI_INT32 dumpvars_cb(p_cb_data cause)
 {
       if (dumpvars_status != 1) return 0;
@@ -338,6 +385,8 @@ static PLI_INT32 finish_cb(p_cb_data cause)
       if (finish_status != 0) return 0;
 
       finish_status = 1;
+      vpip_trace_unregister(lxt2_tracer);
+      lxt2_tracer = 0;
 
       dumpvars_time = timerec_to_time64(cause->time);
       if (!dump_is_off && !dump_is_full && dumpvars_time != vcd_cur_time) {
@@ -381,6 +430,8 @@ __inline__ static int install_dumpvars_callback(void)
 
       vpi_register_cb(&cb);
 
+      lxt2_tracer = vpip_trace_register(variable_trace_cb, 0);
+
       dumpvars_status = 1;
       return 0;
 }
@@ -664,7 +715,13 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 		  cb.reason    = cbValueChange;
 		  cb.cb_rtn    = variable_cb_1;
 
-		  info->cb    = vpi_register_cb(&cb);
+		    /* Prefer the native run time trace, and only fall
+		     * back to a value change callback if the signal
+		     * cannot be traced that way. */
+		  if (vpip_trace_add(lxt2_tracer, item, info))
+			info->cb = 0;
+		  else
+			info->cb = vpi_register_cb(&cb);
 
 	    } else {
 		  char *n = create_full_name(name);
@@ -700,7 +757,10 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 	    cb.reason    = cbValueChange;
 	    cb.cb_rtn    = variable_cb_1;
 
-	    info->cb    = vpi_register_cb(&cb);
+	    if (vpip_trace_add(lxt2_tracer, item, info))
+		  info->cb = 0;
+	    else
+		  info->cb = vpi_register_cb(&cb);
 
 	    break;
 
@@ -364,6 +364,43 @@ static double erlangian(long *seed, long k, long mean)
       return x;
 }
 
+/*
+ * The argument handles of a call are found the first time it is called
+ * and are kept in the user data of the call, so a call that is made
+ * many times does not need to scan its arguments each time. A missing
+ * argument is nil.
+ */
+struct rand_call {
+      vpiHandle args[3];
+      struct rand_call*next;
+};
+
+static struct rand_call*rand_call_list = 0;
+
+static const vpiHandle* rand_call_args(vpiHandle callh)
+{
+      struct rand_call*call = vpi_get_userdata(callh);
+
+      if (call == 0) {
+	    vpiHandle argv = vpi_iterate(vpiArgument, callh);
+	    unsigned idx;
+
+	    call = calloc(1, sizeof(struct rand_call));
+	    for (idx = 0 ;  argv && idx < 3 ;  idx += 1) {
+		  call->args[idx] = vpi_scan(argv);
+		    /* vpi_scan returning 0 (NULL) has freed argv. */
+		  if (call->args[idx] == 0) argv = 0;
+	    }
+	    if (argv) vpi_free_object(argv);
+
+	    call->next = rand_call_list;
+	    rand_call_list = call;
+	    vpi_put_userdata(callh, call);
+      }
+
+      return call->args;
+}
+
 /* A seed can only be an integer/time variable or a register. */
 static unsigned is_seed_obj(vpiHandle obj, vpiHandle callh, const char *name)
 {
@@ -522,7 +559,7 @@ PLI_INT32 sys_random_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
 static PLI_INT32 sys_random_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed = 0;
+      vpiHandle callh, seed;
       s_vpi_value val;
       static long i_seed = 0;
       long a_seed;
@@ -532,11 +569,9 @@ static PLI_INT32 sys_random_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Get the argument list and look for a seed. If it is there,
          get the value and reseed the random number generator. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
+      seed = rand_call_args(callh)[0];
       val.format = vpiIntVal;
-      if (argv) {
-            seed = vpi_scan(argv);
-            vpi_free_object(argv);
+      if (seed) {
             vpi_get_value(seed, &val);
             a_seed = val.value.integer;
       } else a_seed = i_seed;
@@ -587,38 +622,38 @@ static PLI_INT32 sys_urandom_range_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       return 0;
 }
 
+/* The seed used by $urandom and $urandom_fill when none is given. */
+static long urandom_seed = 0;
+
 /* From SystemVerilog. */
 static unsigned long urandom(long *seed, unsigned long max, unsigned long min)
 {
-      static long i_seed = 0;
       unsigned long result;
       long max_i, min_i;
 
       max_i =  max + INT_MIN;
       min_i =  min + INT_MIN;
-      if (seed != 0) i_seed = *seed;
-      result = rtl_dist_uniform(&i_seed, min_i, max_i) - INT_MIN;
-      if (seed != 0) *seed = i_seed;
+      if (seed != 0) urandom_seed = *seed;
+      result = rtl_dist_uniform(&urandom_seed, min_i, max_i) - INT_MIN;
+      if (seed != 0) *seed = urandom_seed;
       return result;
 }
 
 /* From SystemVerilog. */
 static PLI_INT32 sys_urandom_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed = 0;
+      vpiHandle callh, seed;
       s_vpi_value val;
-      long i_seed;
+      long i_seed = 0;
 
       (void)name; /* Parameter is not used. */
 
       /* Get the argument list and look for a seed. If it is there,
          get the value and reseed the random number generator. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
+      seed = rand_call_args(callh)[0];
       val.format = vpiIntVal;
-      if (argv) {
-            seed = vpi_scan(argv);
-            vpi_free_object(argv);
+      if (seed) {
             vpi_get_value(seed, &val);
             i_seed = val.value.integer;
       }
@@ -643,7 +678,8 @@ static PLI_INT32 sys_urandom_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 /* From SystemVerilog. */
 static PLI_INT32 sys_urandom_range_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, maxval, minval;
+      vpiHandle callh, maxval, minval;
+      const vpiHandle*args;
       s_vpi_value val;
       unsigned long i_maxval, i_minval;
 
@@ -651,9 +687,9 @@ static PLI_INT32 sys_urandom_range_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      maxval = vpi_scan(argv);
-      minval = vpi_scan(argv);
+      args = rand_call_args(callh);
+      maxval = args[0];
+      minval = args[1];
 
       val.format = vpiIntVal;
       vpi_get_value(maxval, &val);
@@ -663,7 +699,6 @@ static PLI_INT32 sys_urandom_range_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       if (minval) {
 	    vpi_get_value(minval, &val);
 	    i_minval = val.value.integer;
-	    vpi_free_object(argv);
       } else {
 	    i_minval = 0;
       }
@@ -681,9 +716,132 @@ static PLI_INT32 sys_urandom_range_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       return 0;
 }
 
+static PLI_INT32 sys_urandom_fill_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
+{
+      vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
+      vpiHandle argv = vpi_iterate(vpiArgument, callh);
+      vpiHandle mem, seed;
+
+      /* Check that there are arguments. */
+      if (argv == 0) {
+	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
+	               (int)vpi_get(vpiLineNo, callh));
+	    vpi_printf("%s requires one or two arguments.\n", name);
+	    vpi_control(vpiFinish, 1);
+	    return 0;
+      }
+
+      /* The first argument must be a memory. */
+      mem = vpi_scan(argv);  /* This should never be zero. */
+      if (vpi_get(vpiType, mem) != vpiMemory) {
+	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
+	               (int)vpi_get(vpiLineNo, callh));
+	    vpi_printf("%s's first argument must be a memory.\n", name);
+	    vpi_control(vpiFinish, 1);
+      }
+
+      /* The seed is optional. */
+      seed = vpi_scan(argv);
+      if (seed == 0) return 0;
+
+      /* The seed must be a time/integer variable or a register. */
+      if (! is_seed_obj(seed, callh, name)) return 0;
+
+      /* Check that there no extra arguments. */
+      check_for_extra_args(argv, callh, name, "two arguments", 1);
+
+      return 0;
+}
+
+/* The number of memory words filled with each bulk write. */
+# define FILL_RUN_WORDS 4096
+
+/*
+ * $urandom_fill(mem [, seed]) gives each word of the memory, from the
+ * lowest address to the highest, the values of successive $urandom
+ * calls, with the least significant 32 bits first. The values are the
+ * same as a loop calling $urandom would give, but the seed is only read
+ * and written once and the words are put into the memory in bulk.
+ */
+static PLI_INT32 sys_urandom_fill_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
+{
+      vpiHandle callh, mem, seed;
+      const vpiHandle*args;
+      s_vpi_value val;
+      long i_seed = 0;
+      int left_addr, right_addr, addr, last_addr;
+      unsigned wid, nvec, cnt, idx;
+      PLI_UINT32 mask;
+      s_vpi_vecval*buf;
+
+      (void)name; /* Parameter is not used. */
+
+      callh = vpi_handle(vpiSysTfCall, 0);
+      args = rand_call_args(callh);
+      mem = args[0];
+      seed = args[1];
+
+      val.format = vpiIntVal;
+      if (seed) {
+	    vpi_get_value(seed, &val);
+	    i_seed = val.value.integer;
+      }
+
+      vpi_get_value(vpi_handle(vpiLeftRange, mem), &val);
+      left_addr = val.value.integer;
+      vpi_get_value(vpi_handle(vpiRightRange, mem), &val);
+      right_addr = val.value.integer;
+      addr = left_addr < right_addr ? left_addr : right_addr;
+      last_addr = left_addr < right_addr ? right_addr : left_addr;
+
+      wid = vpi_get(vpiSize, vpi_handle_by_index(mem, addr));
+      nvec = (wid + 31) / 32;
+      mask = (wid % 32) ? UINT_MAX >> (32 - wid%32) : UINT_MAX;
+      buf = malloc(FILL_RUN_WORDS * nvec * sizeof(s_vpi_vecval));
+
+      while (addr <= last_addr) {
+	    if ((unsigned)(last_addr - addr) < FILL_RUN_WORDS)
+		  cnt = last_addr - addr + 1;
+	    else
+		  cnt = FILL_RUN_WORDS;
+
+	    for (idx = 0 ;  idx < cnt*nvec ;  idx += 1) {
+		  buf[idx].aval = urandom(seed ? &i_seed : 0, UINT_MAX, 0);
+		  buf[idx].bval = 0;
+		  if ((idx % nvec) == nvec-1) buf[idx].aval &= mask;
+	    }
+
+	      /* Put the words that the memory does not take in bulk
+	       * one at a time. */
+	    idx = vpip_put_array_words(mem, addr, 1, cnt, buf);
+	    for ( ;  idx < cnt ;  idx += 1) {
+		  s_vpi_value word_val;
+		  word_val.format = vpiVectorVal;
+		  word_val.value.vector = buf + idx*nvec;
+		  vpi_put_value(vpi_handle_by_index(mem, addr+idx),
+		                &word_val, 0, vpiNoDelay);
+	    }
+
+	    if (last_addr - addr < (int)cnt) break;
+	    addr += cnt;
+      }
+
+      free(buf);
+
+      /* If it exists send the updated seed back to seed parameter. */
+      if (seed) {
+	    val.format = vpiIntVal;
+	    val.value.integer = i_seed;
+	    vpi_put_value(seed, &val, 0, vpiNoDelay);
+      }
+
+      return 0;
+}
+
 static PLI_INT32 sys_dist_uniform_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, start, end;
+      vpiHandle callh, seed, start, end;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_start, i_end;
 
@@ -691,10 +849,10 @@ static PLI_INT32 sys_dist_uniform_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      start = vpi_scan(argv);
-      end = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      start = args[1];
+      end = args[2];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -713,14 +871,13 @@ static PLI_INT32 sys_dist_uniform_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
 static PLI_INT32 sys_dist_normal_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, mean, sd;
+      vpiHandle callh, seed, mean, sd;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_mean, i_sd;
 
@@ -728,10 +885,10 @@ static PLI_INT32 sys_dist_normal_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      mean = vpi_scan(argv);
-      sd = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      mean = args[1];
+      sd = args[2];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -750,14 +907,13 @@ static PLI_INT32 sys_dist_normal_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
 static PLI_INT32 sys_dist_exponential_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, mean;
+      vpiHandle callh, seed, mean;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_mean;
 
@@ -765,9 +921,9 @@ static PLI_INT32 sys_dist_exponential_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      mean = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      mean = args[1];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -783,14 +939,13 @@ static PLI_INT32 sys_dist_exponential_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
 static PLI_INT32 sys_dist_poisson_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, mean;
+      vpiHandle callh, seed, mean;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_mean;
 
@@ -798,9 +953,9 @@ static PLI_INT32 sys_dist_poisson_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      mean = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      mean = args[1];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -816,14 +971,13 @@ static PLI_INT32 sys_dist_poisson_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
 static PLI_INT32 sys_dist_chi_square_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, df;
+      vpiHandle callh, seed, df;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_df;
 
@@ -831,9 +985,9 @@ static PLI_INT32 sys_dist_chi_square_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      df = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      df = args[1];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -849,14 +1003,13 @@ static PLI_INT32 sys_dist_chi_square_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
 static PLI_INT32 sys_dist_t_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, df;
+      vpiHandle callh, seed, df;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_df;
 
@@ -864,9 +1017,9 @@ static PLI_INT32 sys_dist_t_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      df = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      df = args[1];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -882,14 +1035,13 @@ static PLI_INT32 sys_dist_t_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
 static PLI_INT32 sys_dist_erlang_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed, k, mean;
+      vpiHandle callh, seed, k, mean;
+      const vpiHandle*args;
       s_vpi_value val;
       long i_seed, i_k, i_mean;
 
@@ -897,10 +1049,10 @@ static PLI_INT32 sys_dist_erlang_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       /* Get the argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      seed = vpi_scan(argv);
-      k = vpi_scan(argv);
-      mean = vpi_scan(argv);
+      args = rand_call_args(callh);
+      seed = args[0];
+      k = args[1];
+      mean = args[2];
 
       val.format = vpiIntVal;
       vpi_get_value(seed, &val);
@@ -919,8 +1071,6 @@ static PLI_INT32 sys_dist_erlang_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       /* Return the seed. */
       val.value.integer = i_seed;
       vpi_put_value(seed, &val, 0, vpiNoDelay);
-
-      vpi_free_object(argv);
       return 0;
 }
 
@@ -930,9 +1080,23 @@ static PLI_INT32 sys_rand_func_sizetf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       return 32;
 }
 
+static PLI_INT32 sys_end_of_simulation(p_cb_data cb_data)
+{
+      (void)cb_data; /* Parameter is not used. */
+
+      while (rand_call_list) {
+	    struct rand_call*call = rand_call_list;
+	    rand_call_list = call->next;
+	    free(call);
+      }
+
+      return 0;
+}
+
 void sys_random_register(void)
 {
       s_vpi_systf_data tf_data;
+      s_cb_data cb_data;
       vpiHandle res;
 
       tf_data.type = vpiSysFunc;
@@ -967,6 +1131,15 @@ void sys_random_register(void)
       res = vpi_register_systf(&tf_data);
       vpip_make_systf_system_defined(res);
 
+      tf_data.type = vpiSysTask;
+      tf_data.tfname = "$urandom_fill";
+      tf_data.calltf = sys_urandom_fill_calltf;
+      tf_data.compiletf = sys_urandom_fill_compiletf;
+      tf_data.sizetf = 0;
+      tf_data.user_data = "$urandom_fill";
+      res = vpi_register_systf(&tf_data);
+      vpip_make_systf_system_defined(res);
+
       tf_data.type = vpiSysFunc;
       tf_data.sysfunctype = vpiSysFuncInt;
       tf_data.tfname = "$dist_uniform";
@@ -1036,4 +1209,11 @@ void sys_random_register(void)
       tf_data.user_data = "$dist_erlang";
       res = vpi_register_systf(&tf_data);
       vpip_make_systf_system_defined(res);
+
+      /* We need to clean up the call information. */
+      cb_data.reason = cbEndOfSimulation;
+      cb_data.time = 0;
+      cb_data.cb_rtn = sys_end_of_simulation;
+      cb_data.user_data = "system";
+      vpi_register_cb(&cb_data);
 }
@@ -23,8 +23,11 @@
 # include  <stdlib.h>
 # include  <stdio.h>
 # include  <assert.h>
-# include  "sys_readmem_lex.h"
 # include  <sys/stat.h>
+#if !defined(__MINGW32__) && !defined(__CYGWIN__)
+# include  <sys/mman.h>
+# define MEM_USE_MMAP 1
+#endif
 # include  "ivl_alloc.h"
 
 char **search_list = NULL;
@@ -258,17 +261,250 @@ static PLI_INT32 sys_mem_compiletf(ICARUS_VPI_CONST PLI_BYTE8*name)
       return 0;
 }
 
+/*
+ * The memory file is read through a hand written scanner that works
+ * from a large block buffer. It returns the same tokens the flex
+ * scanner did: addresses (@hex), words, and single invalid characters.
+ * Comments in either style and white space are skipped.
+ */
+# define MEM_ADDRESS 257
+# define MEM_WORD    258
+# define MEM_ERROR   259
+
+# define MEM_SCAN_BUF (64*1024)
+
+struct mem_scan {
+      FILE*fd;
+      int bin_flag;
+      size_t cur, end;
+      char buf[MEM_SCAN_BUF];
+	/* The text of the current token. */
+      char*tok;
+      size_t tok_len, tok_size;
+};
+
+static int scan_peekc(struct mem_scan*ms)
+{
+      if (ms->cur == ms->end) {
+	    ms->cur = 0;
+	    ms->end = fread(ms->buf, 1, sizeof(ms->buf), ms->fd);
+	    if (ms->end == 0) return EOF;
+      }
+      return (unsigned char)ms->buf[ms->cur];
+}
+
+static int scan_getc(struct mem_scan*ms)
+{
+      int ch = scan_peekc(ms);
+      if (ch != EOF) ms->cur += 1;
+      return ch;
+}
+
+static void scan_tok_add(struct mem_scan*ms, int ch)
+{
+      if (ms->tok_len+1 >= ms->tok_size) {
+	    ms->tok_size = ms->tok_size? 2*ms->tok_size : 256;
+	    ms->tok = (char*)realloc(ms->tok, ms->tok_size);
+      }
+      ms->tok[ms->tok_len++] = ch;
+      ms->tok[ms->tok_len] = 0;
+}
+
+static int is_word_char(int bin_flag, int ch)
+{
+      switch (ch) {
+	  case '0': case '1':
+	  case 'x': case 'X':
+	  case 'z': case 'Z':
+	  case '_':
+	    return 1;
+	  default:
+	    return !bin_flag && isxdigit(ch);
+      }
+}
+
+static int mem_scan_token(struct mem_scan*ms)
+{
+      int ch;
+
+      for (;;) {
+	    ms->tok_len = 0;
+	    ch = scan_getc(ms);
+	    switch (ch) {
+		case EOF:
+		  return 0;
+
+		case ' ': case '\t': case '\f': case '\n': case '\r':
+		  continue;
+
+		case '/':
+		  if (scan_peekc(ms) == '/') {
+			while ((ch = scan_peekc(ms)) != EOF && ch != '\n')
+			      ms->cur += 1;
+			continue;
+		  }
+		  if (scan_peekc(ms) == '*') {
+			ms->cur += 1;
+			while ((ch = scan_getc(ms)) != EOF) {
+			      if (ch != '*') continue;
+			      while ((ch = scan_peekc(ms)) == '*')
+				    ms->cur += 1;
+			      if (ch == '/') {
+				    ms->cur += 1;
+				    break;
+			      }
+			}
+			if (ch == EOF) return 0;
+			continue;
+		  }
+		  break;
+
+		case '@':
+		  if (scan_peekc(ms) == EOF || !isxdigit(scan_peekc(ms)))
+			break;
+		  while ((ch = scan_peekc(ms)) != EOF && isxdigit(ch)) {
+			scan_tok_add(ms, ch);
+			ms->cur += 1;
+		  }
+		  return MEM_ADDRESS;
+
+		default:
+		  if (! is_word_char(ms->bin_flag, ch))
+			break;
+		  scan_tok_add(ms, ch);
+		  while ((ch = scan_peekc(ms)) != EOF
+			 && is_word_char(ms->bin_flag, ch)) {
+			scan_tok_add(ms, ch);
+			ms->cur += 1;
+		  }
+		  return MEM_WORD;
+	    }
+
+	      /* Anything else is an invalid character. */
+	    ms->tok_len = 0;
+	    scan_tok_add(ms, ch);
+	    return MEM_ERROR;
+      }
+}
+
+/*
+ * Convert the text of a word into the wid bit vector at vec, and
+ * return the number of digits that did not fit. The digits are
+ * processed from the least significant end. The bits of vec past the
+ * word width may be set, but they are ignored when the word is put.
+ */
+static unsigned mem_word_value(const char*beg, size_t len, int bin_flag,
+			       unsigned wid, s_vpi_vecval*vec)
+{
+      const char*end = beg + len;
+      unsigned dbits = bin_flag? 1 : 4;
+      unsigned width = 0, extra = 0;
+      unsigned idx;
+
+      for (idx = 0 ;  idx < (wid+31)/32 ;  idx += 1) {
+	    vec[idx].aval = 0;
+	    vec[idx].bval = 0;
+      }
+
+      while (end > beg) {
+	    PLI_UINT32 aval = 0;
+	    PLI_UINT32 bval = 0;
+
+	    end -= 1;
+	    switch (*end) {
+		case '_':
+		  continue;
+		case 'x':
+		case 'X':
+		  aval = bin_flag? 1 : 15;
+		  bval = aval;
+		  break;
+		case 'z':
+		case 'Z':
+		  bval = bin_flag? 1 : 15;
+		  break;
+		default:
+		  if (*end <= '9') aval = *end - '0';
+		  else aval = (*end | 0x20) - 'a' + 10;
+		  break;
+	    }
+
+	    if (width >= wid) {
+		  extra += 1;
+		  continue;
+	    }
+	    vec[width/32].aval |= aval << width%32;
+	    vec[width/32].bval |= bval << width%32;
+	    width += dbits;
+      }
+
+      return extra;
+}
+
+/*
+ * Put cnt words from the buffer into the memory, starting at addr. The
+ * whole run goes in with one bulk write if the memory supports it.
+ */
+static void mem_put_words(vpiHandle mitem, int addr, int incr, unsigned cnt,
+			  s_vpi_vecval*buf, unsigned nvec)
+{
+      unsigned idx = 0;
+
+      if (cnt == 0) return;
+      idx = vpip_put_array_words(mitem, addr, incr, cnt, buf);
+
+      for ( ; idx < cnt ;  idx += 1) {
+	    s_vpi_value value;
+	    vpiHandle word_index = vpi_handle_by_index(mitem, addr+idx*incr);
+	    assert(word_index);
+	    value.format = vpiVectorVal;
+	    value.value.vector = buf + idx*nvec;
+	    vpi_put_value(word_index, &value, 0, vpiNoDelay);
+      }
+}
+
+/* The largest number of words collected before they are put. */
+# define MEM_RUN_WORDS 4096
+
+/*
+ * Open a memory file for reading. If it is not found and the name is
+ * relative then look for it in the $readmempath directories.
+ */
+static FILE* open_mem_file(const char*fname, const char*mode)
+{
+      FILE*file = fopen(fname, mode);
+
+	/* Check to see if we have other directories to look for this file. */
+      if (file == 0 && sl_count > 0 && fname[0] != '/') {
+	    unsigned idx;
+	    char path[4096];
+
+	    for (idx = 0; idx < sl_count; idx += 1) {
+		  snprintf(path, sizeof(path), "%s/%s",
+		           search_list[idx], fname);
+		  path[sizeof(path)-1] = 0;
+		  if ((file = fopen(path, mode))) break;
+	    }
+      }
+
+      return file;
+}
+
 static PLI_INT32 sys_readmem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 {
       int code, wwid, addr;
       FILE*file;
       char *fname = 0;
-      s_vpi_value value;
       vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
       vpiHandle argv = vpi_iterate(vpiArgument, callh);
       vpiHandle mitem = 0;
       vpiHandle start_item = 0;
       vpiHandle stop_item = 0;
+      struct mem_scan*ms;
+      s_vpi_vecval*run;
+      unsigned nvec, run_cnt, extra;
+      int run_addr, bin_flag;
+      int too_many_digits_warning = 0;
 
       /* start_addr and stop_addr are the parameters given to $readmem in the
 	 Verilog code. When not specified, start_addr is equal to the lower of
@@ -299,19 +535,7 @@ static PLI_INT32 sys_readmem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       }
 
 	/* Open the data file. */
-      file = fopen(fname, "r");
-	/* Check to see if we have other directories to look for this file. */
-      if (file == 0 && sl_count > 0 && fname[0] != '/') {
-	    unsigned idx;
-	    char path[4096];
-
-	    for (idx = 0; idx < sl_count; idx += 1) {
-		  snprintf(path, sizeof(path), "%s/%s",
-		           search_list[idx], fname);
-		  path[sizeof(path)-1] = 0;
-		  if ((file = fopen(path, "r"))) break;
-	    }
-      }
+      file = open_mem_file(fname, "r");
       if (file == 0) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -324,26 +548,36 @@ static PLI_INT32 sys_readmem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       word_count = max_addr-min_addr+1;
 
       wwid = vpi_get(vpiSize, vpi_handle_by_index(mitem, min_addr));
-
-      /* variable that will be used by the lexer to pass values
-	 back to this code */
-      value.format = vpiVectorVal;
-      value.value.vector = calloc((wwid+31)/32, sizeof(s_vpi_vecval));
-
-      /* Configure the readmem lexer */
-      if (strcmp(name,"$readmemb") == 0)
-	    sys_readmem_start_file(callh, file, 1, wwid, value.value.vector);
-      else
-	    sys_readmem_start_file(callh, file, 0, wwid, value.value.vector);
+      bin_flag = strcmp(name,"$readmemb") == 0;
+
+      /* Consecutive words are collected here, in vpiVectorVal form,
+	 and put into the memory a run at a time. */
+      nvec = (wwid+31)/32;
+      if (nvec == 0) nvec = 1;
+      run = malloc(MEM_RUN_WORDS*nvec*sizeof(s_vpi_vecval));
+      run_cnt = 0;
+      run_addr = start_addr;
+
+      ms = malloc(sizeof(struct mem_scan));
+      ms->fd = file;
+      ms->bin_flag = bin_flag;
+      ms->cur = 0;
+      ms->end = 0;
+      ms->tok = 0;
+      ms->tok_len = 0;
+      ms->tok_size = 0;
 
       /*======================================== Read memory file */
 
       /* Run through the input file and store the new contents in the memory */
       addr = start_addr;
-      while ((code = readmemlex()) != 0) {
+      while ((code = mem_scan_token(ms)) != 0) {
 	  switch (code) {
 	  case MEM_ADDRESS:
-	      addr = value.value.vector->aval;
+	      mem_put_words(mitem, run_addr, addr_incr, run_cnt, run, nvec);
+	      run_cnt = 0;
+	      addr = (int)strtoul(ms->tok, 0, 16);
+	      run_addr = addr;
 	      if (addr < min_addr || addr > max_addr) {
 		  vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 		             (int)vpi_get(vpiLineNo, callh));
@@ -360,11 +594,30 @@ static PLI_INT32 sys_readmem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 	      break;
 
 	  case MEM_WORD:
+	      extra = mem_word_value(ms->tok, ms->tok_len, bin_flag, wwid,
+	                             run + run_cnt*nvec);
+		/* If there are more text digits then needed to fill the
+		   memory word, print a warning message. Print that
+		   warning only once per call so that the user isn't
+		   flooded. */
+	      if (extra && too_many_digits_warning == 0) {
+		  vpi_printf("WARNING: %s:%d: Excess %s digits (%u of '%s') "
+		             "while reading %d-bit words.\n",
+		             vpi_get_str(vpiFile, callh),
+		             (int)vpi_get(vpiLineNo, callh),
+		             bin_flag? "binary" : "hex",
+		             extra, ms->tok, wwid);
+		  too_many_digits_warning += 1;
+	      }
+
 	      if (addr >= min_addr && addr <= max_addr) {
-		  vpiHandle word_index;
-		  word_index = vpi_handle_by_index(mitem, addr);
-		  assert(word_index);
-		  vpi_put_value(word_index, &value, 0, vpiNoDelay);
+		  run_cnt += 1;
+		  if (run_cnt == MEM_RUN_WORDS) {
+			mem_put_words(mitem, run_addr, addr_incr, run_cnt,
+			              run, nvec);
+			run_cnt = 0;
+			run_addr = addr + addr_incr;
+		  }
 
 		  if (word_count > 0) word_count -= 1;
 	      } else {
@@ -383,7 +636,7 @@ static PLI_INT32 sys_readmem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 	      vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	                 (int)vpi_get(vpiLineNo, callh));
 	      vpi_printf("%s(%s): Invalid input character: %s\n", name,
-	                 fname, readmem_error_token);
+	                 fname, ms->tok);
 	      goto bailout;
 	      break;
 
@@ -403,10 +656,168 @@ static PLI_INT32 sys_readmem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       }
 
  bailout:
-      free(value.value.vector);
+	/* The words read before an error are still loaded. */
+      mem_put_words(mitem, run_addr, addr_incr, run_cnt, run, nvec);
+      free(run);
+      free(ms->tok);
+      free(ms);
+      free(fname);
+      fclose(file);
+      return 0;
+}
+
+/*
+ * $readmemraw loads a memory from a raw binary image. Each memory word
+ * takes (width+7)/8 bytes of the file, least significant byte first,
+ * and the words are in the order they are loaded (start address to
+ * finish address). All the bits loaded are 0 or 1. Where possible the
+ * file is mapped into memory so that no copy of it is made, and only
+ * the pages that are needed are read.
+ */
+static PLI_INT32 sys_readmemraw_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
+{
+      FILE*file;
+      char *fname = 0;
+      vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
+      vpiHandle argv = vpi_iterate(vpiArgument, callh);
+      vpiHandle mitem = 0;
+      vpiHandle start_item = 0;
+      vpiHandle stop_item = 0;
+      struct stat sb;
+      const unsigned char*image = 0;
+      unsigned char*copy = 0;
+      size_t image_size, word_bytes;
+      unsigned long file_words, idx;
+      s_vpi_vecval*run;
+      unsigned wwid, nvec, run_cnt;
+      int addr, run_addr;
+
+      int start_addr, stop_addr, addr_incr;
+      int min_addr, max_addr;
+      unsigned long word_count;
+
+      /*======================================== Get parameters */
+
+      get_mem_params(argv, callh, name,
+                     &fname, &mitem, &start_item, &stop_item);
+      if (fname == 0) return 0;
+
+      /*======================================== Process parameters */
+
+      if (process_params(mitem, start_item, stop_item, callh, name,
+                         &start_addr, &stop_addr, &addr_incr,
+                         &min_addr, &max_addr)) {
+	    free(fname);
+	    return 0;
+      }
+
+      file = open_mem_file(fname, "rb");
+      if (file == 0 || fstat(fileno(file), &sb) != 0) {
+	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
+	               (int)vpi_get(vpiLineNo, callh));
+	    vpi_printf("%s: Unable to open %s for reading.\n", name, fname);
+	    if (file) fclose(file);
+	    free(fname);
+	    return 0;
+      }
+      image_size = sb.st_size;
+
+      word_count = (unsigned long)(max_addr-min_addr) + 1;
+      wwid = vpi_get(vpiSize, vpi_handle_by_index(mitem, min_addr));
+      word_bytes = (wwid+7)/8;
+      file_words = image_size / word_bytes;
+
+      if (image_size % word_bytes) {
+	    vpi_printf("WARNING: %s:%d: ", vpi_get_str(vpiFile, callh),
+	               (int)vpi_get(vpiLineNo, callh));
+	    vpi_printf("%s(%s): File size is not a multiple of the %u byte "
+	               "word size, the last %u bytes are ignored.\n",
+	               name, fname, (unsigned)word_bytes,
+	               (unsigned)(image_size % word_bytes));
+      }
+      if (file_words < word_count) {
+	    vpi_printf("WARNING: %s:%d: ", vpi_get_str(vpiFile, callh),
+	               (int)vpi_get(vpiLineNo, callh));
+	    vpi_printf("%s(%s): Not enough words in the file for the "
+		       "requested range [%d:%d].\n", name, fname,
+		       start_addr, stop_addr);
+	    word_count = file_words;
+      } else if (file_words > word_count) {
+	    vpi_printf("WARNING: %s:%d: ", vpi_get_str(vpiFile, callh),
+	               (int)vpi_get(vpiLineNo, callh));
+	    vpi_printf("%s(%s): Too many words in the file for the "
+	               "requested range [%d:%d].\n",
+		       name, fname, start_addr, stop_addr);
+      }
+      image_size = word_count * word_bytes;
+
+      if (image_size > 0) {
+#ifdef MEM_USE_MMAP
+	    void*map = mmap(0, image_size, PROT_READ, MAP_PRIVATE,
+	                    fileno(file), 0);
+	    if (map != MAP_FAILED) {
+# ifdef MADV_SEQUENTIAL
+		  madvise(map, image_size, MADV_SEQUENTIAL);
+# endif
+		  image = (const unsigned char*)map;
+	    }
+#endif
+	    if (image == 0) {
+		  copy = malloc(image_size);
+		  if (fread(copy, 1, image_size, file) != image_size) {
+			vpi_printf("ERROR: %s:%d: ",
+			           vpi_get_str(vpiFile, callh),
+			           (int)vpi_get(vpiLineNo, callh));
+			vpi_printf("%s(%s): Unable to read the file.\n",
+			           name, fname);
+			free(copy);
+			free(fname);
+			fclose(file);
+			return 0;
+		  }
+		  image = copy;
+	    }
+      }
+
+      /*======================================== Load memory */
+
+      nvec = (wwid+31)/32;
+      if (nvec == 0) nvec = 1;
+      run = malloc(MEM_RUN_WORDS*nvec*sizeof(s_vpi_vecval));
+      run_cnt = 0;
+      run_addr = start_addr;
+
+      addr = start_addr;
+      for (idx = 0 ;  idx < word_count ;  idx += 1) {
+	    const unsigned char*bp = image + idx*word_bytes;
+	    s_vpi_vecval*vec = run + run_cnt*nvec;
+	    unsigned bdx;
+
+	    for (bdx = 0 ;  bdx < nvec ;  bdx += 1) {
+		  vec[bdx].aval = 0;
+		  vec[bdx].bval = 0;
+	    }
+	    for (bdx = 0 ;  bdx < word_bytes ;  bdx += 1)
+		  vec[bdx/4].aval |= (PLI_UINT32)bp[bdx] << 8*(bdx%4);
+
+	    run_cnt += 1;
+	    if (run_cnt == MEM_RUN_WORDS) {
+		  mem_put_words(mitem, run_addr, addr_incr, run_cnt, run, nvec);
+		  run_cnt = 0;
+		  run_addr = addr + addr_incr;
+	    }
+	    addr += addr_incr;
+      }
+      mem_put_words(mitem, run_addr, addr_incr, run_cnt, run, nvec);
+
+      free(run);
+#ifdef MEM_USE_MMAP
+      if (image && image != copy)
+	    munmap((void*)image, image_size);
+#endif
+      free(copy);
       free(fname);
       fclose(file);
-      destroy_readmem_lexor();
       return 0;
 }
 
@@ -509,6 +920,41 @@ static PLI_INT32 sys_readmempath_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       return 0;
 }
 
+/*
+ * Format a wid bit memory word as hex or binary digits, the same way
+ * vpi_get_value() does for vpiHexStrVal and vpiBinStrVal.
+ */
+static void mem_word_format(char*buf, const s_vpi_vecval*vec, unsigned wid,
+			    int bin_flag)
+{
+      unsigned dbits = bin_flag? 1 : 4;
+      unsigned ndig = (wid + dbits - 1) / dbits;
+      unsigned idx;
+
+      buf[ndig] = 0;
+      for (idx = 0 ;  idx < ndig ;  idx += 1) {
+	    unsigned bit = idx * dbits;
+	    unsigned cnt = wid - bit < dbits? wid - bit : dbits;
+	    PLI_UINT32 mask = (1U << cnt) - 1;
+	    PLI_UINT32 aval = (vec[bit/32].aval >> bit%32) & mask;
+	    PLI_UINT32 bval = (vec[bit/32].bval >> bit%32) & mask;
+	    char ch;
+
+	    if (bval == 0)
+		  ch = "0123456789abcdef"[aval];
+	    else if ((bval & ~aval) == mask)
+		  ch = 'z';
+	    else if ((bval & aval) == mask)
+		  ch = 'x';
+	    else if ((bval & aval) == 0)
+		  ch = 'Z';
+	    else
+		  ch = 'X';
+
+	    buf[ndig-1-idx] = ch;
+      }
+}
+
 static PLI_INT32 sys_writemem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 {
       int addr;
@@ -521,6 +967,10 @@ static PLI_INT32 sys_writemem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       vpiHandle mitem = 0;
       vpiHandle start_item = 0;
       vpiHandle stop_item = 0;
+      s_vpi_vecval*run;
+      char*text;
+      unsigned wwid, nvec, run_cnt, idx;
+      int bin_flag;
 
       int start_addr, stop_addr, addr_incr;
       int min_addr, max_addr; // Not used in this routine.
@@ -551,23 +1001,54 @@ static PLI_INT32 sys_writemem_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 	    return 0;
       }
 
-      if (strcmp(name,"$writememb")==0) value.format = vpiBinStrVal;
+      bin_flag = strcmp(name,"$writememb") == 0;
+      if (bin_flag) value.format = vpiBinStrVal;
       else value.format = vpiHexStrVal;
 
+      /* The words are read from the memory a run at a time and
+	 formatted here. If the memory does not support bulk reads,
+	 fall back to getting each word as a string. */
+      wwid = vpi_get(vpiSize, vpi_handle_by_index(mitem, start_addr));
+      nvec = (wwid+31)/32;
+      if (nvec == 0) nvec = 1;
+      run = malloc(MEM_RUN_WORDS*nvec*sizeof(s_vpi_vecval));
+      text = malloc(wwid+2);
+      run_cnt = 0;
+      idx = 0;
+
       /*======================================== Write memory file */
 
       cnt = 0;
       for(addr=start_addr; addr!=stop_addr+addr_incr; addr+=addr_incr, ++cnt) {
-	  vpiHandle word_index;
-
 	  if (cnt%16 == 0) fprintf(file, "// 0x%08x\n", cnt);
 
-	  word_index = vpi_handle_by_index(mitem, addr);
-	  assert(word_index);
-	  vpi_get_value(word_index, &value);
-	  fprintf(file, "%s\n", value.value.str);
+	  if (idx == run_cnt && run != 0) {
+	      unsigned want = (stop_addr - addr) * addr_incr + 1;
+	      if (want > MEM_RUN_WORDS) want = MEM_RUN_WORDS;
+	      run_cnt = vpip_get_array_words(mitem, addr, addr_incr,
+	                                     want, run);
+	      idx = 0;
+	      if (run_cnt == 0) {
+		  free(run);
+		  run = 0;
+	      }
+	  }
+
+	  if (run) {
+	      mem_word_format(text, run + idx*nvec, wwid, bin_flag);
+	      idx += 1;
+	      fputs(text, file);
+	      fputc('\n', file);
+	  } else {
+	      vpiHandle word_index = vpi_handle_by_index(mitem, addr);
+	      assert(word_index);
+	      vpi_get_value(word_index, &value);
+	      fprintf(file, "%s\n", value.value.str);
+	  }
       }
 
+      free(run);
+      free(text);
       fclose(file);
       free(fname);
       return 0;
@@ -597,6 +1078,15 @@ void sys_readmem_register(void)
       res = vpi_register_systf(&tf_data);
       vpip_make_systf_system_defined(res);
 
+      tf_data.type      = vpiSysTask;
+      tf_data.tfname    = "$readmemraw";
+      tf_data.calltf    = sys_readmemraw_calltf;
+      tf_data.compiletf = sys_mem_compiletf;
+      tf_data.sizetf    = 0;
+      tf_data.user_data = "$readmemraw";
+      res = vpi_register_systf(&tf_data);
+      vpip_make_systf_system_defined(res);
+
       tf_data.type      = vpiSysTask;
       tf_data.tfname    = "$readmempath";
       tf_data.calltf    = sys_readmempath_calltf;
@@ -43,6 +43,22 @@ struct byte_source {
       FILE *fd;
 };
 
+/*
+ * A file is locked for the whole of a $fscanf call, so the bytes can
+ * be taken directly from the stdio buffer without locking the stream
+ * for each one. The stream is not read through a private buffer since
+ * the other file routines ($fgetc, $ftell, etc.) share it.
+ */
+#if defined(__MINGW32__)
+# define scan_lock_file(fd)
+# define scan_unlock_file(fd)
+# define scan_getc(fd) getc(fd)
+#else
+# define scan_lock_file(fd) flockfile(fd)
+# define scan_unlock_file(fd) funlockfile(fd)
+# define scan_getc(fd) getc_unlocked(fd)
+#endif
+
 /*
  * Wrapper routine to get a byte from either a string or a file descriptor.
  */
@@ -56,7 +72,7 @@ static int byte_getc(struct byte_source *src)
       }
 
       assert(src->fd);
-      return fgetc(src->fd);
+      return scan_getc(src->fd);
 }
 
 /*
@@ -76,6 +92,108 @@ static void byte_ungetc(struct byte_source *src, int ch)
       ungetc(ch, src->fd);
 }
 
+/*
+ * The characters of a match are collected in this buffer. It is
+ * reused by every match and released at the end of simulation.
+ */
+static struct {
+      char*str;
+      unsigned len;
+      unsigned cap;
+} scan_text = { 0, 0, 0 };
+
+static void scan_text_add(int ch)
+{
+	/* Always leave room for the trailing NULL. */
+      if (scan_text.len+1 >= scan_text.cap) {
+	    scan_text.cap = scan_text.cap ? 2*scan_text.cap : 256;
+	    scan_text.str = realloc(scan_text.str, scan_text.cap);
+      }
+      scan_text.str[scan_text.len++] = ch;
+}
+
+static char* scan_text_finish(void)
+{
+      scan_text_add(0);
+      scan_text.len -= 1;
+      return scan_text.str;
+}
+
+/*
+ * The per call information for $fscanf and $sscanf is gathered the
+ * first time the call is compiled or run and is kept in the user data
+ * of the call. A constant format string is compiled into a list of
+ * operations, and the type and size of each variable is saved.
+ */
+struct scan_op {
+	/* 'S' for white space, 'L' for a literal character or '%' for
+	 * a format code. */
+      char kind;
+	/* The literal character or the format code. */
+      char code;
+      unsigned suppress_flag;
+      unsigned max_width;
+};
+
+struct scan_call {
+	/* The file descriptor or source string. */
+      vpiHandle src;
+      vpiHandle fmt_item;
+	/* The compiled format, or nil if the format is not constant. */
+      struct scan_op*ops;
+      unsigned nops;
+      vpiHandle*items;
+      PLI_INT32*types;
+      PLI_INT32*sizes;
+      unsigned nitems;
+      struct scan_call*next;
+};
+
+static struct scan_call*scan_call_list = 0;
+
+/*
+ * The format code routines take the variables in order from this.
+ */
+struct scan_args {
+      const struct scan_call*call;
+      unsigned next;
+};
+
+static vpiHandle scan_next_arg(struct scan_args*args)
+{
+      if (args->next >= args->call->nitems) return 0;
+      args->next += 1;
+      return args->call->items[args->next-1];
+}
+
+/*
+ * Can the value for the last variable taken be built directly as a
+ * vector? The real and string variables need a converted value.
+ */
+static int scan_arg_is_vector(const struct scan_args*args)
+{
+      switch (args->call->types[args->next-1]) {
+	  case vpiReg:
+	  case vpiIntegerVar:
+	  case vpiBitVar:
+	  case vpiByteVar:
+	  case vpiShortIntVar:
+	  case vpiIntVar:
+	  case vpiLongIntVar:
+	  case vpiTimeVar:
+	  case vpiMemoryWord:
+	  case vpiPartSelect:
+	    return 1;
+	  default:
+	    return 0;
+      }
+}
+
+static PLI_INT32 scan_arg_size(const struct scan_args*args)
+{
+      return args->call->sizes[args->next-1];
+}
+
 
 /*
  * This function matches the input characters of a floating point
@@ -88,11 +206,13 @@ static void byte_ungetc(struct byte_source *src, int ch)
 static double get_float(struct byte_source *src, unsigned width, int *match)
 {
       char *endptr;
-      char *strval = malloc(1);
+      char *strval;
       unsigned len = 0;
       double result;
       int ch;
 
+      scan_text.len = 0;
+
 	/* Skip any leading space. */
       ch = byte_getc(src);
       while (isspace(ch)) ch = byte_getc(src);
@@ -100,7 +220,6 @@ static double get_float(struct byte_source *src, unsigned width, int *match)
 	/* If we are being asked for no digits then return a match fail. */
       if (width == 0) {
 	    byte_ungetc(src, ch);
-	    free(strval);
 	    *match = 0;
 	    return 0.0;
       }
@@ -111,71 +230,67 @@ static double get_float(struct byte_source *src, unsigned width, int *match)
 	       * one since we need a sign and a digit. */
 	    if (width == 1) {
 		  byte_ungetc(src, ch);
-		  free(strval);
 		  *match = 0;
 		  return 0.0;
 	    }
-	    strval = realloc(strval, len+2);
-	    strval[len++] = ch;
+	    scan_text_add(ch);
+	    len += 1;
 	    ch = byte_getc(src);
       }
 
 	/* Get any digits before the optional decimal point, but no more
 	 * than width. */
       while (isdigit(ch) && (len < width)) {
-	    strval = realloc(strval, len+2);
-	    strval[len++] = ch;
+	    scan_text_add(ch);
+	    len += 1;
 	    ch = byte_getc(src);
       }
 
 	/* Get the optional decimal point and any following digits, but
 	 * no more than width total characters are copied. */
       if ((ch == '.') && (len < width)) {
-	    strval = realloc(strval, len+2);
-	    strval[len++] = ch;
+	    scan_text_add(ch);
+	    len += 1;
 	    ch = byte_getc(src);
 	      /* Get any trailing digits. */
 	    while (isdigit(ch) && (len < width)) {
-		  strval = realloc(strval, len+2);
-		  strval[len++] = ch;
+		  scan_text_add(ch);
+		  len += 1;
 		  ch = byte_getc(src);
 	    }
       }
 
 	/* No leading digits were matched. */
       if ((len == 0) ||
-          ((len == 1) && ((strval[0] == '+') || (strval[0] == '-')))) {
+          ((len == 1) && ((scan_text.str[0] == '+') || (scan_text.str[0] == '-')))) {
 	    byte_ungetc(src, ch);
-	    free(strval);
 	    *match = 0;
 	    return 0.0;
       }
 
 	/* Match an exponent. */
       if (((ch == 'e') || (ch == 'E')) && (len < width)) {
-	    strval = realloc(strval, len+2);
-	    strval[len++] = ch;
+	    scan_text_add(ch);
+	    len += 1;
 	    ch = byte_getc(src);
 
 	      /* We must have enough space for at least one digit after
 	       * the exponent. */
 	    if (len == width) {
 		  byte_ungetc(src, ch);
-		  free(strval);
 		  *match = 0;
 		  return 0.0;
 	    }
 
 	      /* Check to see if the exponent has a sign. */
 	    if ((ch == '-') || (ch == '+')) {
-		  strval = realloc(strval, len+2);
-		  strval[len++] = ch;
+		  scan_text_add(ch);
+		  len += 1;
 		  ch = byte_getc(src);
 		    /* We must have enough space for at least one digit
 		     * after the exponent sign. */
 		  if (len == width) {
 			byte_ungetc(src, ch);
-			free(strval);
 			*match = 0;
 			return 0.0;
 		  }
@@ -184,7 +299,6 @@ static double get_float(struct byte_source *src, unsigned width, int *match)
 	      /* We must have at least one digit after the exponent/sign. */
 	    if (! isdigit(ch)) {
 		  byte_ungetc(src, ch);
-		  free(strval);
 		  *match = 0;
 		  return 0.0;
 	    }
@@ -192,12 +306,12 @@ static double get_float(struct byte_source *src, unsigned width, int *match)
 	      /* Get the exponent digits, but no more than width total
 	       * characters are copied. */
 	    while (isdigit(ch) && (len < width)) {
-		  strval = realloc(strval, len+2);
-		  strval[len++] = ch;
+		  scan_text_add(ch);
+		  len += 1;
 		  ch = byte_getc(src);
 	    }
       }
-      strval[len] = 0;
+      strval = scan_text_finish();
 
 	/* Put the last character back. */
       byte_ungetc(src, ch);
@@ -206,7 +320,6 @@ static double get_float(struct byte_source *src, unsigned width, int *match)
       result = strtod(strval, &endptr);
 	/* If this asserts then there is a bug in the code above.*/
       assert(*endptr == 0);
-      free(strval);
       *match = 1;
       return result;
 }
@@ -217,7 +330,7 @@ static double get_float(struct byte_source *src, unsigned width, int *match)
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_float(vpiHandle callh, vpiHandle argv,
+static int scan_format_float(vpiHandle callh, struct scan_args *args,
                              struct byte_source *src, unsigned width,
                              unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name,
                              char code)
@@ -238,7 +351,7 @@ static int scan_format_float(vpiHandle callh, vpiHandle argv,
       if (suppress_flag) return -1;
 
 	/* We must have a variable to put the double value into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -264,7 +377,7 @@ static int scan_format_float(vpiHandle callh, vpiHandle argv,
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_float_time(vpiHandle callh, vpiHandle argv,
+static int scan_format_float_time(vpiHandle callh, struct scan_args *args,
 				  struct byte_source*src, unsigned width,
                                   unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
@@ -304,7 +417,7 @@ static int scan_format_float_time(vpiHandle callh, vpiHandle argv,
       }
 
 	/* We must have a variable to put the double value into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -322,24 +435,164 @@ static int scan_format_float_time(vpiHandle callh, vpiHandle argv,
       return 1;
 }
 
+/*
+ * Put the binary, octal or hex digits collected in scan_text into a
+ * vector variable. The vector is built here the same way vvp converts
+ * a digit string: the value is truncated to the width of the variable
+ * and is padded with x or z when the most significant digit is x or
+ * z, otherwise it is padded with zero.
+ */
+static void put_base_vector(vpiHandle arg, PLI_INT32 wid, unsigned bits)
+{
+      unsigned words = (wid+31)/32;
+      unsigned dmask = (1U << bits) - 1;
+      p_vpi_vecval vec = calloc(words, sizeof(s_vpi_vecval));
+      s_vpi_value val;
+      unsigned idx, pos = 0;
+      PLI_UINT32 pad_aval = 0, pad_bval = 0;
+
+      for (idx = 0 ;  idx < scan_text.len ;  idx += 1) {
+	    if (scan_text.str[idx] == '_') continue;
+	    switch (scan_text.str[idx]) {
+		case 'x':
+		case 'X':
+		  pad_aval = UINT32_MAX;
+		  pad_bval = UINT32_MAX;
+		  break;
+		case 'z':
+		case 'Z':
+		  pad_bval = UINT32_MAX;
+		  break;
+	    }
+	    break;
+      }
+
+      for (idx = scan_text.len ;  idx > 0 && pos < (unsigned)wid ;  ) {
+	    PLI_UINT32 aval, bval = 0;
+	    unsigned off = pos % 32;
+	    int ch = scan_text.str[--idx];
+
+	    if (ch == '_') continue;
+	    switch (ch) {
+		case 'x':
+		case 'X':
+		  aval = dmask;
+		  bval = dmask;
+		  break;
+		case 'z':
+		case 'Z':
+		  aval = 0;
+		  bval = dmask;
+		  break;
+		default:
+		  if (isdigit(ch)) aval = ch - '0';
+		  else aval = tolower(ch) - 'a' + 10;
+		  break;
+	    }
+
+	    vec[pos/32].aval |= aval << off;
+	    vec[pos/32].bval |= bval << off;
+	      /* An octal digit may straddle two words. */
+	    if ((off + bits > 32) && (pos/32+1 < words)) {
+		  vec[pos/32+1].aval |= aval >> (32 - off);
+		  vec[pos/32+1].bval |= bval >> (32 - off);
+	    }
+	    pos += bits;
+      }
+
+      if (pad_bval) {
+	    for ( ;  pos < (unsigned)wid ;  pos += 1) {
+		  vec[pos/32].aval |= (pad_aval & 1) << (pos%32);
+		  vec[pos/32].bval |= (pad_bval & 1) << (pos%32);
+	    }
+      }
+
+      if (wid % 32) {
+	    PLI_UINT32 mask = UINT32_MAX >> (32 - wid%32);
+	    vec[words-1].aval &= mask;
+	    vec[words-1].bval &= mask;
+      }
+
+      val.format = vpiVectorVal;
+      val.value.vector = vec;
+      vpi_put_value(arg, &val, 0, vpiNoDelay);
+      free(vec);
+}
+
+/*
+ * Put the decimal value collected in scan_text into a vector variable.
+ * The value is built modulo the width of the variable, which matches
+ * how vvp converts a decimal string.
+ */
+static void put_decimal_vector(vpiHandle arg, PLI_INT32 wid)
+{
+      unsigned words = (wid+31)/32;
+      p_vpi_vecval vec = calloc(words, sizeof(s_vpi_vecval));
+      s_vpi_value val;
+      const char*cp = scan_text.str;
+      unsigned idx;
+
+      if (*cp == 'x' || *cp == 'z') {
+	    for (idx = 0 ;  idx < words ;  idx += 1) {
+		  vec[idx].aval = (*cp == 'x') ? UINT32_MAX : 0;
+		  vec[idx].bval = UINT32_MAX;
+	    }
+      } else {
+	    int negative = 0;
+	    if (*cp == '-') {
+		  negative = 1;
+		  cp += 1;
+	    }
+	    for ( ;  *cp ;  cp += 1) {
+		  PLI_UINT64 carry;
+		  if (*cp == '_') continue;
+		  carry = *cp - '0';
+		  for (idx = 0 ;  idx < words ;  idx += 1) {
+			carry += (PLI_UINT64)(PLI_UINT32)vec[idx].aval * 10;
+			vec[idx].aval = (PLI_UINT32)carry;
+			carry >>= 32;
+		  }
+	    }
+	    if (negative) {
+		  PLI_UINT64 carry = 1;
+		  for (idx = 0 ;  idx < words ;  idx += 1) {
+			carry += (PLI_UINT32)~vec[idx].aval;
+			vec[idx].aval = (PLI_UINT32)carry;
+			carry >>= 32;
+		  }
+	    }
+      }
+
+      if (wid % 32) {
+	    PLI_UINT32 mask = UINT32_MAX >> (32 - wid%32);
+	    vec[words-1].aval &= mask;
+	    vec[words-1].bval &= mask;
+      }
+
+      val.format = vpiVectorVal;
+      val.value.vector = vec;
+      vpi_put_value(arg, &val, 0, vpiNoDelay);
+      free(vec);
+}
+
 /*
  * Base routine for getting binary, octal and hex values.
  *
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_base(vpiHandle callh, vpiHandle argv,
+static int scan_format_base(vpiHandle callh, struct scan_args *args,
                             struct byte_source *src, unsigned width,
                             unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name,
                             const char *match, char code,
-                            PLI_INT32 type)
+                            PLI_INT32 type, unsigned bits)
 {
       vpiHandle arg;
-      char *strval = malloc(1);
-      unsigned len = 0;
       s_vpi_value val;
       int ch;
 
+      scan_text.len = 0;
+
 	/* Skip any leading space. */
       ch = byte_getc(src);
       while (isspace(ch)) ch = byte_getc(src);
@@ -348,54 +601,47 @@ static int scan_format_base(vpiHandle callh, vpiHandle argv,
 	 * an underscore then return a match fail. */
       if ((width == 0) || (ch == '_')) {
 	    byte_ungetc(src, ch);
-	    free(strval);
 	    return 0;
       }
 
 	/* Get all the digits, but no more than width. */
-      while (strchr(match , ch) && (len < width)) {
+      while ((ch > 0) && strchr(match , ch) && (scan_text.len < width)) {
 	    if (ch == '?') ch = 'x';
 
-	    strval = realloc(strval, len+2);
-	    strval[len++] = ch;
+	    scan_text_add(ch);
 
 	    ch = byte_getc(src);
       }
-      strval[len] = 0;
 
 	/* Put the last character back. */
       byte_ungetc(src, ch);
 
 	/* Nothing was matched. */
-      if (len == 0) {
-	    free(strval);
-	    return 0;
-      }
+      if (scan_text.len == 0) return 0;
 
 	/* If this match is being suppressed then return after consuming
 	 * the digits and report that no arguments were used. */
-      if (suppress_flag) {
-	    free(strval);
-	    return -1;
-      }
+      if (suppress_flag) return -1;
 
 	/* We must have a variable to put the binary value into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
 	    vpi_printf("%s() ran out of variables for %%%c format code.",
 	               name, code);
 	    vpi_control(vpiFinish, 1);
-	    free(strval);
 	    return 0;
       }
 
 	/* Put the value into the variable. */
-      val.format = type;
-      val.value.str = strval;
-      vpi_put_value(arg, &val, 0, vpiNoDelay);
-      free(strval);
+      if (scan_arg_is_vector(args)) {
+	    put_base_vector(arg, scan_arg_size(args), bits);
+      } else {
+	    val.format = type;
+	    val.value.str = scan_text_finish();
+	    vpi_put_value(arg, &val, 0, vpiNoDelay);
+      }
 
 	/* We always consume one variable if it is available. */
       return 1;
@@ -404,12 +650,12 @@ static int scan_format_base(vpiHandle callh, vpiHandle argv,
 /*
  * Routine to return a binary value (implements %b).
  */
-static int scan_format_binary(vpiHandle callh, vpiHandle argv,
+static int scan_format_binary(vpiHandle callh, struct scan_args *args,
                               struct byte_source *src, int width,
                               unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      return scan_format_base(callh, argv, src, width, suppress_flag, name,
-                              "01xzXZ?_", 'b', vpiBinStrVal);
+      return scan_format_base(callh, args, src, width, suppress_flag, name,
+                              "01xzXZ?_", 'b', vpiBinStrVal, 1);
 }
 
 /*
@@ -418,7 +664,7 @@ static int scan_format_binary(vpiHandle callh, vpiHandle argv,
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_char(vpiHandle callh, vpiHandle argv,
+static int scan_format_char(vpiHandle callh, struct scan_args *args,
                             struct byte_source *src, unsigned width,
                             unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
@@ -440,7 +686,7 @@ static int scan_format_char(vpiHandle callh, vpiHandle argv,
       if (suppress_flag) return -1;
 
 	/* We must have a variable to put the character value into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -464,15 +710,16 @@ static int scan_format_char(vpiHandle callh, vpiHandle argv,
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_decimal(vpiHandle callh, vpiHandle argv,
+static int scan_format_decimal(vpiHandle callh, struct scan_args *args,
                                struct byte_source *src, unsigned width,
                                unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       vpiHandle arg;
-      char *strval = malloc(1);
       s_vpi_value val;
       int ch;
 
+      scan_text.len = 0;
+
 	/* Skip any leading space. */
       ch = byte_getc(src);
       while (isspace(ch)) ch = byte_getc(src);
@@ -481,35 +728,24 @@ static int scan_format_decimal(vpiHandle callh, vpiHandle argv,
 	 * an underscore then return a match fail. */
       if ((width == 0) || (ch == '_')) {
 	    byte_ungetc(src, ch);
-	    free(strval);
 	    return 0;
       }
 
 	/* A decimal can match a single x/X, ? or z/Z character. */
-      if (strchr("xX?", ch)) {
-	    strval = realloc(strval, 2);
-	    strval[0] = 'x';
-	    strval[1] = 0;
-      } else if (strchr("zZ", ch)) {
-	    strval = realloc(strval, 2);
-	    strval[0] = 'z';
-	    strval[1] = 0;
+      if ((ch > 0) && strchr("xX?", ch)) {
+	    scan_text_add('x');
+      } else if ((ch > 0) && strchr("zZ", ch)) {
+	    scan_text_add('z');
       } else {
-	    unsigned len = 0;
-
 	      /* To match a + or - we must have a digit after it. */
 	    if (ch == '+') {
 		    /* If we have a '+' sign then the width must not be
 		     * one since we need a sign and a digit. */
-		  if (width == 1) {
-			free(strval);
-			return 0;
-		  }
+		  if (width == 1) return 0;
 
 		  ch = byte_getc(src);
 		  if (! isdigit(ch)) {
 			byte_ungetc(src, ch);
-			free(strval);
 			return 0;
 		  }
 		    /* The '+' used up a character. */
@@ -517,64 +753,54 @@ static int scan_format_decimal(vpiHandle callh, vpiHandle argv,
 	    } else if (ch == '-') {
 		    /* If we have a '-' sign then the width must not be
 		     * one since we need a sign and a digit. */
-		  if (width == 1) {
-			free(strval);
-			return 0;
-		  }
+		  if (width == 1) return 0;
 
 		  ch = byte_getc(src);
 		  if (isdigit(ch)) {
-			strval = realloc(strval, len+2);
-			strval[len++] = '-';
+			scan_text_add('-');
 		  } else {
 			byte_ungetc(src, ch);
-			free(strval);
 			return 0;
 		  }
 	    }
 
 	      /* Get all the characters, but no more than width. */
-	    while ((isdigit(ch) || ch == '_') && (len < width)) {
-		  strval = realloc(strval, len+2);
-		  strval[len++] = ch;
+	    while ((isdigit(ch) || ch == '_') && (scan_text.len < width)) {
+		  scan_text_add(ch);
 
 		  ch = byte_getc(src);
 	    }
-	    strval[len] = 0;
 
 	      /* Put the last character back. */
 	    byte_ungetc(src, ch);
 
 	      /* Nothing was matched. */
-	    if (len == 0) {
-		  free(strval);
-		  return 0;
-	    }
+	    if (scan_text.len == 0) return 0;
       }
 
 	/* If this match is being suppressed then return after consuming
 	 * the digits and report that no arguments were used. */
-      if (suppress_flag) {
-	    free(strval);
-	    return -1;
-      }
+      if (suppress_flag) return -1;
 
 	/* We must have a variable to put the decimal value into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
 	    vpi_printf("%s() ran out of variables for %%d format code.", name);
 	    vpi_control(vpiFinish, 1);
-	    free(strval);
 	    return 0;
       }
 
 	/* Put the decimal value into the variable. */
-      val.format = vpiDecStrVal;
-      val.value.str = strval;
-      vpi_put_value(arg, &val, 0, vpiNoDelay);
-      free(strval);
+      scan_text_finish();
+      if (scan_arg_is_vector(args)) {
+	    put_decimal_vector(arg, scan_arg_size(args));
+      } else {
+	    val.format = vpiDecStrVal;
+	    val.value.str = scan_text.str;
+	    vpi_put_value(arg, &val, 0, vpiNoDelay);
+      }
 
 	/* We always consume one variable if it is available. */
       return 1;
@@ -583,31 +809,31 @@ static int scan_format_decimal(vpiHandle callh, vpiHandle argv,
 /*
  * Routine to return a hex value (implements %h).
  */
-static int scan_format_hex(vpiHandle callh, vpiHandle argv,
+static int scan_format_hex(vpiHandle callh, struct scan_args *args,
                            struct byte_source *src, unsigned width,
                            unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      return scan_format_base(callh, argv, src, width, suppress_flag, name,
+      return scan_format_base(callh, args, src, width, suppress_flag, name,
                               "0123456789abcdefxzABCDEFXZ?_", 'h',
-                              vpiHexStrVal);
+                              vpiHexStrVal, 4);
 }
 
 /*
  * Routine to return an octal value (implements %o).
  */
-static int scan_format_octal(vpiHandle callh, vpiHandle argv,
+static int scan_format_octal(vpiHandle callh, struct scan_args *args,
                              struct byte_source *src, unsigned width,
                              unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      return scan_format_base(callh, argv, src, width, suppress_flag, name,
-                              "01234567xzXZ?_", 'o', vpiOctStrVal);
+      return scan_format_base(callh, args, src, width, suppress_flag, name,
+                              "01234567xzXZ?_", 'o', vpiOctStrVal, 3);
 }
 
 
 /*
  * Routine to return the current hierarchical path (implements %m).
  */
-static int scan_format_module_path(vpiHandle callh, vpiHandle argv,
+static int scan_format_module_path(vpiHandle callh, struct scan_args *args,
                                    unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       vpiHandle scope, arg;
@@ -619,7 +845,7 @@ static int scan_format_module_path(vpiHandle callh, vpiHandle argv,
       if (suppress_flag) return -1;
 
 	/* We must have a variable to put the hierarchical path into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -648,16 +874,16 @@ static int scan_format_module_path(vpiHandle callh, vpiHandle argv,
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_string(vpiHandle callh, vpiHandle argv,
+static int scan_format_string(vpiHandle callh, struct scan_args *args,
                               struct byte_source *src, unsigned width,
                               unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       vpiHandle arg;
-      char *strval = malloc(1);
-      unsigned len = 0;
       s_vpi_value val;
       int ch;
 
+      scan_text.len = 0;
+
 	/* Skip any leading space. */
       ch = byte_getc(src);
       while (isspace(ch)) ch = byte_getc(src);
@@ -665,25 +891,21 @@ static int scan_format_string(vpiHandle callh, vpiHandle argv,
 	/* If we are being asked for no digits then return a match fail. */
       if (width == 0) {
 	    byte_ungetc(src, ch);
-	    free(strval);
 	    return 0;
       }
 
 	/* Get all the non-space characters, but no more than width. */
-      while (! isspace(ch) && (len < width)) {
+      while (! isspace(ch) && (scan_text.len < width)) {
 	    if (ch == EOF) break;
 
-	    strval = realloc(strval, len+2);
-	    strval[len++] = ch;
+	    scan_text_add(ch);
 
 	    ch = byte_getc(src);
       }
-      strval[len] = 0;
 
 	/* Nothing was matched (this can only happen at EOF). */
-      if (len == 0) {
+      if (scan_text.len == 0) {
 	    assert(ch == EOF);
-	    free(strval);
 	    return 0;
       }
 
@@ -692,27 +914,22 @@ static int scan_format_string(vpiHandle callh, vpiHandle argv,
 
 	/* If this match is being suppressed then return after consuming
 	 * the string and report that no arguments were used. */
-      if (suppress_flag) {
-	    free(strval);
-	    return -1;
-      }
+      if (suppress_flag) return -1;
 
 	/* We must have a variable to put the string into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
 	    vpi_printf("%s() ran out of variables for %%s format code.", name);
 	    vpi_control(vpiFinish, 1);
-	    free(strval);
 	    return 0;
       }
 
 	/* Put the string into the variable. */
       val.format = vpiStringVal;
-      val.value.str = strval;
+      val.value.str = scan_text_finish();
       vpi_put_value(arg, &val, 0, vpiNoDelay);
-      free(strval);
 
 	/* We always consume one variable if it is available. */
       return 1;
@@ -727,7 +944,7 @@ static int scan_format_string(vpiHandle callh, vpiHandle argv,
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_two_state(vpiHandle callh, vpiHandle argv,
+static int scan_format_two_state(vpiHandle callh, struct scan_args *args,
                                  struct byte_source *src, unsigned width,
                                  unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
@@ -769,7 +986,7 @@ static int scan_format_two_state(vpiHandle callh, vpiHandle argv,
       }
 
 	/* We must have a variable to put the bits into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -780,7 +997,7 @@ static int scan_format_two_state(vpiHandle callh, vpiHandle argv,
 
 	/* Extract either the given number of word pairs or enough to fill
 	 * the variable. */
-      varlen = (vpi_get(vpiSize, arg)+31)/32;
+      varlen = (scan_arg_size(args)+31)/32;
       assert(varlen > 0);
       val_ptr = (p_vpi_vecval) malloc(varlen*sizeof(s_vpi_vecval));
       if (width == UINT_MAX) words = (unsigned)varlen;
@@ -866,7 +1083,7 @@ static int scan_format_two_state(vpiHandle callh, vpiHandle argv,
  * Return: 1 for a match, 0 for no match/variable and -1 for a
  *         suppressed match. No variable is fatal.
  */
-static int scan_format_four_state(vpiHandle callh, vpiHandle argv,
+static int scan_format_four_state(vpiHandle callh, struct scan_args *args,
                                   struct byte_source *src, unsigned width,
                                   unsigned suppress_flag, ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
@@ -908,7 +1125,7 @@ static int scan_format_four_state(vpiHandle callh, vpiHandle argv,
       }
 
 	/* We must have a variable to put the bits into. */
-      arg = vpi_scan(argv);
+      arg = scan_next_arg(args);
       if (! arg) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
 	               (int)vpi_get(vpiLineNo, callh));
@@ -919,7 +1136,7 @@ static int scan_format_four_state(vpiHandle callh, vpiHandle argv,
 
 	/* Extract either the given number of word pairs or enough to fill
 	 * the variable. */
-      varlen = (vpi_get(vpiSize, arg)+31)/32;
+      varlen = (scan_arg_size(args)+31)/32;
       assert(varlen > 0);
       val_ptr = (p_vpi_vecval) malloc(varlen*sizeof(s_vpi_vecval));
       if (width == UINT_MAX) words = (unsigned)varlen;
@@ -999,54 +1216,133 @@ static int scan_format_four_state(vpiHandle callh, vpiHandle argv,
       return 1;
 }
 
+/*
+ * Compile a format string into a list of scan operations. The list
+ * always has an entry for the end of the format so it is never nil.
+ */
+static struct scan_op* scan_format_compile(const char*fmt, unsigned*nops)
+{
+      unsigned cap = 8;
+      struct scan_op*ops = malloc(cap*sizeof(struct scan_op));
+      const char*fmtp = fmt;
+
+      *nops = 0;
+      while (*fmtp) {
+	    struct scan_op*op;
+
+	    if (*nops+1 >= cap) {
+		  cap *= 2;
+		  ops = realloc(ops, cap*sizeof(struct scan_op));
+	    }
+	    op = ops + *nops;
+	    *nops += 1;
+	    op->suppress_flag = 0;
+	    op->max_width = UINT_MAX;
+
+	    if (isspace((int)*fmtp)) {
+		    /* White space matches a string of white space in the
+		     * input. The number of spaces is not relevant, and
+		     * the match may be 0 or more spaces. */
+		  while (*fmtp && isspace((int)*fmtp)) fmtp += 1;
+		  op->kind = 'S';
+		  op->code = ' ';
+
+	    } else if (*fmtp != '%') {
+		    /* Characters other than % match themselves. */
+		  op->kind = 'L';
+		  op->code = *fmtp;
+		  fmtp += 1;
+
+	    } else {
+		    /* We are at a pattern character. The pattern has
+		     * the format %<N>x no matter what the x code, so
+		     * parse it generically first. */
+		  op->kind = '%';
+
+		    /* Look for the suppression character '*'. */
+		  fmtp += 1;
+		  if (*fmtp == '*') {
+			op->suppress_flag = 1;
+			fmtp += 1;
+		  }
+		    /* Look for the maximum match width. */
+		  if (isdigit((int)*fmtp)) {
+			op->max_width = 0;
+			while (isdigit((int)*fmtp)) {
+			      op->max_width *= 10;
+			      op->max_width += *fmtp - '0';
+			      fmtp += 1;
+			}
+		  }
+
+		    /* Get the format character. A format that ends in
+		     * the middle of a pattern gets an invalid code. */
+		  op->code = *fmtp;
+		  if (*fmtp) fmtp += 1;
+	    }
+      }
+
+      ops[*nops].kind = 0;
+      return ops;
+}
+
 /*
  * The $fscanf and $sscanf functions are the same except for the first
  * argument, which is the source. The wrapper functions below peel off
  * the first argument and make a byte_source object that then gets
  * passed to this function, which processes the rest of the function.
  */
-static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
+static int scan_format(vpiHandle callh, struct byte_source*src,
+                       const struct scan_call*call,
                        ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       s_vpi_value val;
-      vpiHandle item;
-      PLI_INT32 len, words, idx, mask;
-
-      char *fmt, *fmtp;
+      struct scan_args args;
+      const struct scan_op*ops = call->ops;
+      struct scan_op*tmp_ops = 0;
+      unsigned nops = call->nops, opx;
       int rc = 0;
       int ch;
 
       int match = 1;
 
-	/* Get the format string. */
-      item = vpi_scan(argv);
-      assert(item);
-	/* Look for an undefined bit (X/Z) in the format string. If one is
-	 * found just return EOF. */
-      len = vpi_get(vpiSize, item);
-      words = ((len + 31) / 32) - 1;
-      val.format = vpiVectorVal;
-      vpi_get_value(item, &val);
-	/* Check the full words for an undefined bit. */
-      for (idx = 0; idx < words; idx += 1) {
-	    if (val.value.vector[idx].bval) {
+      args.call = call;
+      args.next = 0;
+
+	/* A format that is not a constant must be checked and compiled
+	 * on every call. */
+      if (ops == 0) {
+	    vpiHandle item = call->fmt_item;
+	    PLI_INT32 len, words, idx, mask;
+
+	    assert(item);
+	      /* Look for an undefined bit (X/Z) in the format string. If
+	       * one is found just return EOF. */
+	    len = vpi_get(vpiSize, item);
+	    words = ((len + 31) / 32) - 1;
+	    val.format = vpiVectorVal;
+	    vpi_get_value(item, &val);
+	      /* Check the full words for an undefined bit. */
+	    for (idx = 0; idx < words; idx += 1) {
+		  if (val.value.vector[idx].bval) {
+			match = 0;
+			rc = EOF;
+			break;
+		  }
+	    }
+	      /* The mask is defined to be 32 bits. */
+	    mask = UINT32_MAX >> (32U - ((len - 1U) % 32U + 1U));
+	      /* Check the top word for an undefined bit. */
+	    if (match && (val.value.vector[words].bval & mask)) {
 		  match = 0;
 		  rc = EOF;
-		  break;
 	    }
-      }
-	/* The mask is defined to be 32 bits. */
-      mask = UINT32_MAX >> (32U - ((len - 1U) % 32U + 1U));
-	/* Check the top word for an undefined bit. */
-      if (match && (val.value.vector[words].bval & mask)) {
-	    match = 0;
-	    rc = EOF;
-      }
 
-	/* Now get the format as a string. */
-      val.format = vpiStringVal;
-      vpi_get_value(item, &val);
-      fmtp = fmt = strdup(val.value.str);
+	      /* Now get the format as a string. */
+	    val.format = vpiStringVal;
+	    vpi_get_value(item, &val);
+	    ops = tmp_ops = scan_format_compile(val.value.str, &nops);
+      }
 
 	/* See if we are at EOF before we even start. */
       ch = byte_getc(src);
@@ -1056,64 +1352,33 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
       }
       byte_ungetc(src, ch);
 
-      while ( fmtp && *fmtp != 0 && match) {
-
-	    if (isspace((int)*fmtp)) {
-		    /* White space matches a string of white space in the
-		     * input. The number of spaces is not relevant, and
-		     * the match may be 0 or more spaces. */
-		  while (*fmtp && isspace((int)*fmtp)) fmtp += 1;
+      for (opx = 0 ;  opx < nops && match ;  opx += 1) {
+	    const struct scan_op*op = ops + opx;
 
+	    if (op->kind == 'S') {
 		  ch = byte_getc(src);
 		  while (isspace(ch)) ch = byte_getc(src);
 
 		  byte_ungetc(src, ch);
 
-	    } else if (*fmtp != '%') {
-		    /* Characters other than % match themselves. */
+	    } else if (op->kind == 'L') {
 		  ch = byte_getc(src);
-		  if (ch != *fmtp) {
+		  if (ch != op->code) {
 			byte_ungetc(src, ch);
 			break;
 		  }
 
-		  fmtp += 1;
-
 	    } else {
-
-		    /* We are at a pattern character. The pattern has
-		     * the format %<N>x no matter what the x code, so
-		     * parse it generically first. */
-
-		  unsigned suppress_flag = 0;
-		  unsigned max_width = UINT_MAX;
-		  int code = 0;
-
-		    /* Look for the suppression character '*'. */
-		  fmtp += 1;
-		  if (*fmtp == '*') {
-			suppress_flag = 1;
-			fmtp += 1;
-		  }
-		    /* Look for the maximum match width. */
-		  if (isdigit((int)*fmtp)) {
-			max_width = 0;
-			while (isdigit((int)*fmtp)) {
-			      max_width *= 10;
-			      max_width += *fmtp - '0';
-			      fmtp += 1;
-			}
-		  }
-
-		    /* Get the format character. */
-		  code = *fmtp;
-		  fmtp += 1;
-
-		    /* The format string is parsed:
+		    /* The format code was parsed when it was compiled:
 		     *   - max_width is the width,
 		     *   - code is the format code character,
-		     *   - suppress_flag is true if the match is to be ignored.
+		     *   - suppress_flag is true if the match is to be
+		     *     ignored.
 		     * Now interpret the code. */
+		  unsigned suppress_flag = op->suppress_flag;
+		  unsigned max_width = op->max_width;
+		  int code = op->code;
+
 		  switch (code) {
 
 			  /* Read a '%' character from the input. */
@@ -1128,19 +1393,19 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
 			break;
 
 		      case 'b':
-			match = scan_format_binary(callh, argv, src, max_width,
+			match = scan_format_binary(callh, &args, src, max_width,
 			                           suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 'c':
-			match = scan_format_char(callh, argv, src, max_width,
+			match = scan_format_char(callh, &args, src, max_width,
 			                       suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 'd':
-			match = scan_format_decimal(callh, argv, src, max_width,
+			match = scan_format_decimal(callh, &args, src, max_width,
 			                            suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
@@ -1148,14 +1413,14 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
 		      case 'e':
 		      case 'f':
 		      case 'g':
-			match = scan_format_float(callh, argv, src, max_width,
+			match = scan_format_float(callh, &args, src, max_width,
 			                          suppress_flag, name, code);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 'h':
 		      case 'x':
-			match = scan_format_hex(callh, argv, src, max_width,
+			match = scan_format_hex(callh, &args, src, max_width,
 			                        suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
@@ -1163,32 +1428,32 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
 		      case 'm':
 			  /* Since this code does not consume any characters
 			   * the width makes no difference. */
-			match = scan_format_module_path(callh, argv,
+			match = scan_format_module_path(callh, &args,
 			                                suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 'o':
-			match = scan_format_octal(callh, argv, src, max_width,
+			match = scan_format_octal(callh, &args, src, max_width,
 			                          suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 's':
-			match = scan_format_string(callh, argv, src, max_width,
+			match = scan_format_string(callh, &args, src, max_width,
 			                           suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 't':
-			match = scan_format_float_time(callh, argv, src,
+			match = scan_format_float_time(callh, &args, src,
 			                               max_width,
 			                               suppress_flag, name);
 			if (match == 1) rc += 1;
 			break;
 
 		      case 'u':
-			match = scan_format_two_state(callh, argv, src,
+			match = scan_format_two_state(callh, &args, src,
 			                              max_width,
 			                              suppress_flag, name);
 			  /* If a binary match fails and it is the first item
@@ -1207,7 +1472,7 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
 			break;
 
 		      case 'z':
-			match = scan_format_four_state(callh, argv, src,
+			match = scan_format_four_state(callh, &args, src,
 			                               max_width,
 			                               suppress_flag, name);
 			  /* If a binary match fails and it is the first item
@@ -1229,8 +1494,7 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
       }
 
 	/* Clean up the allocated memory. */
-      free(fmt);
-      vpi_free_object(argv);
+      free(tmp_ops);
 
 	/* Return the number of successful matches. */
       val.format = vpiIntVal;
@@ -1240,6 +1504,57 @@ static int scan_format(vpiHandle callh, struct byte_source*src, vpiHandle argv,
       return 0;
 }
 
+/*
+ * Get the information for a call, building it if this is the first
+ * time the call is seen.
+ */
+static struct scan_call* scan_call_get(vpiHandle callh)
+{
+      struct scan_call*call = vpi_get_userdata(callh);
+      vpiHandle argv, item;
+      unsigned cap = 0;
+
+      if (call) return call;
+
+      call = calloc(1, sizeof(struct scan_call));
+      argv = vpi_iterate(vpiArgument, callh);
+      if (argv) call->src = vpi_scan(argv);
+      if (call->src) call->fmt_item = vpi_scan(argv);
+      if (call->fmt_item) {
+	    PLI_INT32 type = vpi_get(vpiType, call->fmt_item);
+	    if ((type == vpiConstant || type == vpiParameter) &&
+	        (vpi_get(vpiConstType, call->fmt_item) == vpiStringConst)) {
+		  s_vpi_value val;
+		  val.format = vpiStringVal;
+		  vpi_get_value(call->fmt_item, &val);
+		  call->ops = scan_format_compile(val.value.str, &call->nops);
+	    }
+
+	    for (item = vpi_scan(argv) ;  item ;  item = vpi_scan(argv)) {
+		  if (call->nitems == cap) {
+			cap = cap ? 2*cap : 8;
+			call->items = realloc(call->items,
+			                      cap*sizeof(vpiHandle));
+			call->types = realloc(call->types,
+			                      cap*sizeof(PLI_INT32));
+			call->sizes = realloc(call->sizes,
+			                      cap*sizeof(PLI_INT32));
+		  }
+		  call->items[call->nitems] = item;
+		  call->types[call->nitems] = vpi_get(vpiType, item);
+		  call->sizes[call->nitems] = vpi_get(vpiSize, item);
+		  call->nitems += 1;
+	    }
+      } else if (argv && call->src) {
+	    vpi_free_object(argv);
+      }
+
+      call->next = scan_call_list;
+      scan_call_list = call;
+      vpi_put_userdata(callh, call);
+      return call;
+}
+
 /*
  * Is the object a variable/register or a piece of one.
  */
@@ -1345,20 +1660,21 @@ static PLI_INT32 sys_fscanf_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       }
 
       if (sys_check_args(callh, argv, name)) vpi_control(vpiFinish, 1);
+      scan_call_get(callh);
       return 0;
 }
 
 static PLI_INT32 sys_fscanf_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
-      vpiHandle argv = vpi_iterate(vpiArgument, callh);
+      struct scan_call*call = scan_call_get(callh);
       s_vpi_value val;
       struct byte_source src;
       FILE *fd;
       errno = 0;
 
       val.format = vpiIntVal;
-      vpi_get_value(vpi_scan(argv), &val);
+      vpi_get_value(call->src, &val);
       fd = vpi_get_file(val.value.integer);
       if (!fd) {
 	    vpi_printf("ERROR: %s:%d: ", vpi_get_str(vpiFile, callh),
@@ -1369,13 +1685,14 @@ static PLI_INT32 sys_fscanf_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 	    val.format = vpiIntVal;
 	    val.value.integer = EOF;
 	    vpi_put_value(callh, &val, 0, vpiNoDelay);
-	    vpi_free_object(argv);
 	    return 0;
       }
 
       src.str = 0;
       src.fd = fd;
-      scan_format(callh, &src, argv, name);
+      scan_lock_file(fd);
+      scan_format(callh, &src, call, name);
+      scan_unlock_file(fd);
 
       return 0;
 }
@@ -1416,32 +1733,55 @@ static PLI_INT32 sys_sscanf_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       }
 
       if (sys_check_args(callh, argv, name)) vpi_control(vpiFinish, 1);
+      scan_call_get(callh);
       return 0;
 }
 
 static PLI_INT32 sys_sscanf_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
-      vpiHandle argv = vpi_iterate(vpiArgument, callh);
+      struct scan_call*call = scan_call_get(callh);
       s_vpi_value val;
       struct byte_source src;
       char *str;
 
       val.format = vpiStringVal;
-      vpi_get_value(vpi_scan(argv), &val);
+      vpi_get_value(call->src, &val);
 
       str = strdup(val.value.str);
       src.str = str;
       src.fd = 0;
-      scan_format(callh, &src, argv, name);
+      scan_format(callh, &src, call, name);
       free(str);
 
       return 0;
 }
 
+static PLI_INT32 sys_end_of_simulation(p_cb_data cb_data)
+{
+      (void)cb_data; /* Parameter is not used. */
+
+      while (scan_call_list) {
+	    struct scan_call*call = scan_call_list;
+	    scan_call_list = call->next;
+	    free(call->ops);
+	    free(call->items);
+	    free(call->types);
+	    free(call->sizes);
+	    free(call);
+      }
+
+      free(scan_text.str);
+      scan_text.str = 0;
+      scan_text.len = 0;
+      scan_text.cap = 0;
+      return 0;
+}
+
 void sys_scanf_register(void)
 {
       s_vpi_systf_data tf_data;
+      s_cb_data cb_data;
       vpiHandle res;
 
       /*============================== fscanf */
@@ -1465,4 +1805,11 @@ void sys_scanf_register(void)
       tf_data.user_data   = "$sscanf";
       res = vpi_register_systf(&tf_data);
       vpip_make_systf_system_defined(res);
+
+	/* We need to clean up the call information. */
+      cb_data.reason = cbEndOfSimulation;
+      cb_data.time = 0;
+      cb_data.cb_rtn = sys_end_of_simulation;
+      cb_data.user_data = "system";
+      vpi_register_cb(&cb_data);
 }
@@ -22,6 +22,7 @@
 # include  <stdlib.h>
 # include  <string.h>
 # include  <assert.h>
+# include  <time.h>
 
 /*
  * These are static context
@@ -37,23 +38,199 @@ static vpiHandle sdf_callh = 0;
   /* The cell in process. */
 static vpiHandle sdf_cur_cell;
 
-static vpiHandle find_scope(vpiHandle scope, const char*name)
+/*
+ * Statistics for -sdf-verbose.
+ */
+static unsigned sdf_cell_count, sdf_cell_missing;
+static unsigned sdf_iopath_count, sdf_iopath_missing;
+
+/*
+ * The child scopes of a scope are looked up by name through this hash
+ * table. The children of a scope are all entered the first time the
+ * scope is searched, so each scope is iterated at most once for each
+ * $sdf_annotate, no matter how many cells it holds. An entry with a
+ * nil name marks a scope whose children have been entered.
+ */
+struct sdf_scope_entry {
+      vpiHandle parent;
+      char*name;
+      vpiHandle scope;
+      struct sdf_scope_entry*next;
+};
+
+static struct sdf_scope_entry**scope_table = 0;
+static unsigned scope_table_size = 0;
+static unsigned scope_table_count = 0;
+
+static unsigned scope_hash(vpiHandle parent, const char*name)
 {
-      vpiHandle idx = vpi_iterate(vpiModule, scope);
-	/* If this scope has no modules then it can't have the one we
-	 * are looking for so just return 0. */
-      if (idx == 0) return 0;
+      size_t hash = (size_t)parent;
+      hash ^= hash >> 7;
+      if (name) while (*name) {
+	    hash = (hash * 31) + (unsigned char)*name;
+	    name += 1;
+      }
+      return hash % scope_table_size;
+}
 
-      vpiHandle cur;
-      while ( (cur = vpi_scan(idx)) ) {
+static struct sdf_scope_entry* scope_table_find(vpiHandle parent,
+						const char*name)
+{
+      struct sdf_scope_entry*cur;
 
-	    if ( strcmp(name, vpi_get_str(vpiName,cur)) == 0) {
-		  vpi_free_object(idx);
+      if (scope_table_size == 0)
+	    return 0;
+
+      for (cur = scope_table[scope_hash(parent, name)] ; cur ; cur = cur->next) {
+	    if (cur->parent != parent)
+		  continue;
+	    if (name == 0 ? cur->name == 0
+		: (cur->name && strcmp(cur->name, name) == 0))
 		  return cur;
+      }
+      return 0;
+}
+
+static void scope_table_add(vpiHandle parent, const char*name, vpiHandle scope)
+{
+      struct sdf_scope_entry*cur;
+      unsigned hash;
+
+	/* Grow the table to keep the chains short. */
+      if (scope_table_count >= scope_table_size) {
+	    struct sdf_scope_entry**old_table = scope_table;
+	    unsigned old_size = scope_table_size;
+	    unsigned idx;
+
+	    scope_table_size = old_size? 2*old_size : 1024;
+	    scope_table = calloc(scope_table_size, sizeof(*scope_table));
+	    for (idx = 0 ;  idx < old_size ;  idx += 1) {
+		  while ((cur = old_table[idx])) {
+			old_table[idx] = cur->next;
+			hash = scope_hash(cur->parent, cur->name);
+			cur->next = scope_table[hash];
+			scope_table[hash] = cur;
+		  }
 	    }
+	    free(old_table);
       }
 
-      return 0;
+      cur = malloc(sizeof(struct sdf_scope_entry));
+      cur->parent = parent;
+      cur->name = name? strdup(name) : 0;
+      cur->scope = scope;
+      hash = scope_hash(parent, name);
+      cur->next = scope_table[hash];
+      scope_table[hash] = cur;
+      scope_table_count += 1;
+}
+
+static void scope_table_delete(void)
+{
+      unsigned idx;
+
+      for (idx = 0 ;  idx < scope_table_size ;  idx += 1) {
+	    struct sdf_scope_entry*cur;
+	    while ((cur = scope_table[idx])) {
+		  scope_table[idx] = cur->next;
+		  free(cur->name);
+		  free(cur);
+	    }
+      }
+      free(scope_table);
+      scope_table = 0;
+      scope_table_size = 0;
+      scope_table_count = 0;
+}
+
+static vpiHandle find_scope(vpiHandle scope, const char*name)
+{
+      struct sdf_scope_entry*cur;
+
+      if (scope_table_find(scope, 0) == 0) {
+	    vpiHandle idx = vpi_iterate(vpiModule, scope);
+	    vpiHandle tmp;
+
+	    scope_table_add(scope, 0, 0);
+	      /* If there are several children with the same name, the
+	         first one is the one that is found. */
+	    if (idx) while ( (tmp = vpi_scan(idx)) ) {
+		  const char*tmp_name = vpi_get_str(vpiName, tmp);
+		  if (scope_table_find(scope, tmp_name) == 0)
+			scope_table_add(scope, tmp_name, tmp);
+	    }
+      }
+
+      cur = scope_table_find(scope, name);
+      return cur? cur->scope : 0;
+}
+
+/*
+ * The modpaths of the current cell, with the names and edge that the
+ * IOPATH entries are matched against. This is collected when the
+ * first IOPATH of the cell is processed.
+ */
+struct sdf_modpath {
+      char*src;
+      char*dst;
+      int edge;
+      vpiHandle path;
+};
+
+static struct sdf_modpath*cell_paths = 0;
+static unsigned cell_paths_count = 0;
+static vpiHandle cell_paths_cell = 0;
+
+static void cell_paths_clear(void)
+{
+      unsigned idx;
+
+      for (idx = 0 ;  idx < cell_paths_count ;  idx += 1) {
+	    free(cell_paths[idx].src);
+	    free(cell_paths[idx].dst);
+      }
+      free(cell_paths);
+      cell_paths = 0;
+      cell_paths_count = 0;
+      cell_paths_cell = 0;
+}
+
+static void cell_paths_collect(vpiHandle cell)
+{
+      vpiHandle iter, path;
+      unsigned size = 0;
+
+      cell_paths_clear();
+      cell_paths_cell = cell;
+
+      iter = vpi_iterate(vpiModPath, cell);
+      if (iter) while ( (path = vpi_scan(iter)) ) {
+	    struct sdf_modpath*cur;
+
+	    vpiHandle path_t_in = vpi_handle(vpiModPathIn,path);
+	    vpiHandle path_t_out = vpi_handle(vpiModPathOut,path);
+
+	    vpiHandle path_in = vpi_handle(vpiExpr,path_t_in);
+	    vpiHandle path_out = vpi_handle(vpiExpr,path_t_out);
+
+	      /* The expressions for the path terms must be signals,
+	         vpiNet or vpiReg. */
+	    assert(vpi_get(vpiType,path_in) == vpiNet);
+	    assert(vpi_get(vpiType,path_out) == vpiNet
+		   || vpi_get(vpiType,path_out) == vpiReg);
+
+	    if (cell_paths_count == size) {
+		  size = size? 2*size : 16;
+		  cell_paths = realloc(cell_paths,
+		                       size*sizeof(struct sdf_modpath));
+	    }
+	    cur = cell_paths + cell_paths_count;
+	    cur->src = strdup(vpi_get_str(vpiName,path_in));
+	    cur->dst = strdup(vpi_get_str(vpiName,path_out));
+	    cur->edge = vpi_get(vpiEdge,path_t_in);
+	    cur->path = path;
+	    cell_paths_count += 1;
+      }
 }
 
 /*
@@ -68,6 +245,7 @@ void sdf_select_instance(const char*celltype, const char*cellinst)
 	/* First follow the hierarchical parts of the cellinst name to
 	   get to the cell that I'm looking for. */
       vpiHandle scope = sdf_scope;
+      sdf_cell_count += 1;
       const char*src = cellinst;
       const char*dp;
       while ( (dp=strchr(src, '.')) ) {
@@ -98,6 +276,7 @@ void sdf_select_instance(const char*celltype, const char*cellinst)
       else
 	    sdf_cur_cell = find_scope(scope, src);
       if (sdf_cur_cell == 0) {
+	    sdf_cell_missing += 1;
 	    vpi_printf("SDF WARNING: %s:%d: ", vpi_get_str(vpiFile, sdf_callh),
 	               (int)vpi_get(vpiLineNo, sdf_callh));
 	    vpi_printf("Unable to find %s in scope %s.\n",
@@ -138,46 +317,37 @@ static const char*edge_str(int vpi_edge)
 void sdf_iopath_delays(int vpi_edge, const char*src, const char*dst,
 		       const struct sdf_delval_list_s*delval_list)
 {
-      vpiHandle iter, path;
+      unsigned pdx;
       int match_count = 0;
 
       if (sdf_cur_cell == 0)
 	    return;
 
-      iter = vpi_iterate(vpiModPath, sdf_cur_cell);
+      sdf_iopath_count += 1;
+      if (cell_paths_cell != sdf_cur_cell)
+	    cell_paths_collect(sdf_cur_cell);
 
 	/* Search for the modpath that matches the IOPATH by looking
 	   for the modpath that uses the same ports as the ports that
 	   the parser has found. */
-      if (iter) while ( (path = vpi_scan(iter)) ) {
+      for (pdx = 0 ;  pdx < cell_paths_count ;  pdx += 1) {
+	    struct sdf_modpath*cur = cell_paths + pdx;
 	    s_vpi_delay delays;
 	    struct t_vpi_time delay_vals[12];
 	    int idx;
 
-	    vpiHandle path_t_in = vpi_handle(vpiModPathIn,path);
-	    vpiHandle path_t_out = vpi_handle(vpiModPathOut,path);
-
-	    vpiHandle path_in = vpi_handle(vpiExpr,path_t_in);
-	    vpiHandle path_out = vpi_handle(vpiExpr,path_t_out);
-
-	      /* The expressions for the path terms must be signals,
-	         vpiNet or vpiReg. */
-	    assert(vpi_get(vpiType,path_in) == vpiNet);
-	    assert(vpi_get(vpiType,path_out) == vpiNet
-		   || vpi_get(vpiType,path_out) == vpiReg);
-
 	      /* If the src name doesn't match, go on. */
-	    if (strcmp(src,vpi_get_str(vpiName,path_in)) != 0)
+	    if (strcmp(src,cur->src) != 0)
 		  continue;
 	      /* The edge type must match too. But note that if this
 	         IOPATH has no edge, then it matches with all edges of
 	         the modpath object. */
 /* --> Is this correct in the context of the 10, 01, etc. edges? */
-	    if (vpi_edge != vpiNoEdge && vpi_get(vpiEdge,path_t_in) != vpi_edge)
+	    if (vpi_edge != vpiNoEdge && cur->edge != vpi_edge)
 		  continue;
 
 	      /* If the dst name doesn't match, go on. */
-	    if (strcmp(dst,vpi_get_str(vpiName,path_out)) != 0)
+	    if (strcmp(dst,cur->dst) != 0)
 		  continue;
 
 	      /* Ah, this must be a match! */
@@ -187,7 +357,7 @@ void sdf_iopath_delays(int vpi_edge, const char*src, const char*dst,
 	    delays.mtm_flag = 0;
 	    delays.append_flag = 0;
 	    delays.pulsere_flag = 0;
-	    vpi_get_delays(path, &delays);
+	    vpi_get_delays(cur->path, &delays);
 
 	    for (idx = 0 ; idx < delval_list->count ; idx += 1) {
 		  delay_vals[idx].type = vpiScaledRealTime;
@@ -196,11 +366,12 @@ void sdf_iopath_delays(int vpi_edge, const char*src, const char*dst,
 		  }
 	    }
 
-	    vpi_put_delays(path, &delays);
+	    vpi_put_delays(cur->path, &delays);
 	    match_count += 1;
       }
 
       if (match_count == 0) {
+	    sdf_iopath_missing += 1;
 	    vpi_printf("SDF WARNING: %s:%d: ", vpi_get_str(vpiFile, sdf_callh),
 	               (int)vpi_get(vpiLineNo, sdf_callh));
 	    vpi_printf("Unable to match ModPath %s%s -> %s in %s\n",
@@ -287,6 +458,7 @@ static PLI_INT32 sys_sdf_annotate_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
       vpiHandle argv = vpi_iterate(vpiArgument, callh);
       FILE *sdf_fd;
+      clock_t start;
       char *fname = get_filename(callh, name, vpi_scan(argv));
 
       if (fname == 0) {
@@ -315,8 +487,23 @@ static PLI_INT32 sys_sdf_annotate_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
 
       sdf_cur_cell = 0;
       sdf_callh = callh;
+      sdf_cell_count = 0;
+      sdf_cell_missing = 0;
+      sdf_iopath_count = 0;
+      sdf_iopath_missing = 0;
+      start = clock();
       sdf_process_file(sdf_fd, fname);
       sdf_callh = 0;
+      cell_paths_clear();
+      scope_table_delete();
+
+      if (sdf_flag_inform) {
+	    vpi_printf("%s:SDF INFO: Annotated %u cells (%u not found) "
+	               "and %u IOPATHs (%u not matched) in %.3f seconds.\n",
+	               fname, sdf_cell_count, sdf_cell_missing,
+	               sdf_iopath_count, sdf_iopath_missing,
+	               (double)(clock() - start) / CLOCKS_PER_SEC);
+      }
 
       fclose(sdf_fd);
       free(fname);
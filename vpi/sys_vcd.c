@@ -53,6 +53,8 @@ static PLI_UINT64 vcd_cur_time = 0;
 static int dump_is_off = 0;
 static long dump_limit = 0;
 static int dump_is_full = 0;
+  /* The native value change tracer, see vpip_trace_register(). */
+static PLI_INT32 vcd_tracer = 0;
 static int finish_status = 0;
 
 
@@ -197,6 +199,23 @@ static PLI_INT32 variable_cb_2(p_cb_data cause)
       return 0;
 }
 
+/*
+ * Check if the dump file has grown past the $dumplimit. If it has then
+ * mark the dump as full and return true.
+ */
+static int dump_limit_exceeded(void)
+{
+      if ((dump_limit > 0) && (ftell(dump_file) > dump_limit)) {
+            dump_is_full = 1;
+            vpi_printf("WARNING: Dump file limit (%ld bytes) "
+                               "exceeded.\n", dump_limit);
+            fprintf(dump_file, "$comment Dump file limit (%ld bytes) "
+                               "exceeded. $end\n", dump_limit);
+            return 1;
+      }
+      return 0;
+}
+
 static PLI_INT32 variable_cb_1(p_cb_data cause)
 {
       struct t_cb_data cb;
@@ -207,14 +226,7 @@ static PLI_INT32 variable_cb_1(p_cb_data cause)
       if (dump_header_pending()) return 0;
       if (info->scheduled) return 0;
 
-      if ((dump_limit > 0) && (ftell(dump_file) > dump_limit)) {
-            dump_is_full = 1;
-            vpi_printf("WARNING: Dump file limit (%ld bytes) "
-                               "exceeded.\n", dump_limit);
-            fprintf(dump_file, "$comment Dump file limit (%ld bytes) "
-                               "exceeded. $end\n", dump_limit);
-            return 0;
-      }
+      if (dump_limit_exceeded()) return 0;
 
       if (!vcd_dmp_list) {
           cb = *cause;
@@ -231,6 +243,52 @@ static PLI_INT32 variable_cb_1(p_cb_data cause)
       return 0;
 }
 
+/*
+ * Signals that are traced natively by the run time (see vpip_trace_add)
+ * have their values delivered here as raw vecval words, once per time
+ * step, so they can be written without any vpi_get_value() formatting.
+ */
+static void show_this_trace_rec(const s_vpip_trace_rec*rec)
+{
+      struct vcd_info*info = (struct vcd_info*)rec->user_data;
+      char*buf;
+
+      if (rec->size == 0) {
+	    fprintf(dump_file, "r%.16g %s\n", rec->real, info->ident);
+	    return;
+      }
+
+      buf = vcd_trace_rec_bits(rec);
+      if (rec->size == 1)
+	    fprintf(dump_file, "%s%s\n", buf, info->ident);
+      else
+	    fprintf(dump_file, "b%s %s\n", truncate_bitvec(buf), info->ident);
+}
+
+static void variable_trace_cb(PLI_UINT64 now, const s_vpip_trace_rec*recs,
+                              unsigned count, void*data)
+{
+      unsigned idx;
+
+      (void)data; /* Parameter is not used. */
+
+      if (dump_is_full) return;
+      if (dump_is_off) return;
+      if (dump_header_pending()) return;
+	/* The $dumpvars checkpoint already has these values. */
+      if (now == dumpvars_time) return;
+
+      if (dump_limit_exceeded()) return;
+
+      if (now != vcd_cur_time) {
+	    fprintf(dump_file, "#%" PLI_UINT64_FMT "\n", now);
+	    vcd_cur_time = now;
+      }
+
+      for (idx = 0 ;  idx < count ;  idx += 1)
+	    show_this_trace_rec(recs + idx);
+}
+
 static PLI_INT32 dumpvars_cb(p_cb_data cause)
 {
       if (dumpvars_status != 1) return 0;
@@ -267,6 +325,8 @@ static PLI_INT32 finish_cb(p_cb_data cause)
       }
 
       fclose(dump_file);
+      vpip_trace_unregister(vcd_tracer);
+      vcd_tracer = 0;
 
       for (cur = vcd_list ;  cur ;  cur = next) {
 	    next = cur->next;
@@ -309,6 +369,8 @@ __inline__ static int install_dumpvars_callback(void)
 
       vpi_register_cb(&cb);
 
+      vcd_tracer = vpip_trace_register(variable_trace_cb, 0);
+
       dumpvars_status = 1;
       return 0;
 }
@@ -657,7 +719,13 @@ static void scan_item(unsigned depth, vpiHandle item, int skip)
 		  info->next  = vcd_list;
 		  vcd_list    = info;
 
-		  info->cb    = vpi_register_cb(&cb);
+		    /* Prefer the native run time trace, and only fall
+		     * back to a value change callback if the signal
+		     * cannot be traced that way. */
+		  if (vpip_trace_add(vcd_tracer, item, info))
+			info->cb = 0;
+		  else
+			info->cb = vpi_register_cb(&cb);
 	    }
 
 	      /* Named events do not have a size, but other tools use
@@ -217,3 +217,24 @@ PLI_INT32 sys_dumpvars_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
       return 0;
 }
+
+char* vcd_trace_rec_bits(const s_vpip_trace_rec*rec)
+{
+      static char*buf = 0;
+      static unsigned buf_size = 0;
+      unsigned idx;
+
+      if (rec->size + 1 > buf_size) {
+	    buf_size = rec->size + 1;
+	    buf = realloc(buf, buf_size);
+      }
+
+      for (idx = 0 ;  idx < rec->size ;  idx += 1) {
+	    unsigned abit = (rec->vector[idx/32].aval >> (idx%32)) & 1;
+	    unsigned bbit = (rec->vector[idx/32].bval >> (idx%32)) & 1;
+	    buf[rec->size-idx-1] = "01zx"[abit | (bbit << 1)];
+      }
+      buf[rec->size] = 0;
+
+      return buf;
+}
@@ -62,6 +62,13 @@ EXTERN void vcd_scope_names_add(const char*name);
 EXTERN int  vcd_scope_names_test(const char*name);
 EXTERN void vcd_scope_names_delete(void);
 
+/*
+ * Convert the vector value of a native trace record (see
+ * vpip_trace_add) to a string of 0/1/x/z characters, MSB first. The
+ * string is kept in a static buffer that is reused by the next call.
+ */
+EXTERN char* vcd_trace_rec_bits(const s_vpip_trace_rec*rec);
+
 /*
  * Implement a work queue that can be used to send commands to a
  * dumper thread.
@@ -124,6 +124,13 @@ void        vpip_format_strength(char*, s_vpi_value*, unsigned) { }
 void        vpip_make_systf_system_defined(vpiHandle) { }
 void        vpip_mcd_rawwrite(PLI_UINT32, const char*, size_t) { }
 void        vpip_set_return_value(int) { }
+PLI_INT32   vpip_trace_register(vpip_trace_handler_t, void*) { return 0; }
+void        vpip_trace_unregister(PLI_INT32) { }
+PLI_INT32   vpip_trace_add(PLI_INT32, vpiHandle, void*) { return 0; }
+PLI_INT32   vpip_get_values(const vpiHandle*, PLI_UINT32, PLI_INT32, void*) { return 0; }
+PLI_INT32   vpip_put_values(const vpiHandle*, PLI_UINT32, PLI_INT32, const void*) { return 0; }
+PLI_INT32   vpip_put_array_words(vpiHandle, PLI_INT32, PLI_INT32, PLI_UINT32, const s_vpi_vecval*) { return 0; }
+PLI_INT32   vpip_get_array_words(vpiHandle, PLI_INT32, PLI_INT32, PLI_UINT32, s_vpi_vecval*) { return 0; }
 void        vpi_vcontrol(PLI_INT32, va_list) { }
 
 
@@ -225,6 +232,13 @@ vpip_routines_s vpi_routines = {
     .make_systf_system_defined  = vpip_make_systf_system_defined,
     .mcd_rawwrite               = vpip_mcd_rawwrite,
     .set_return_value           = vpip_set_return_value,
+    .trace_register             = vpip_trace_register,
+    .trace_unregister           = vpip_trace_unregister,
+    .trace_add                  = vpip_trace_add,
+    .get_values                 = vpip_get_values,
+    .put_values                 = vpip_put_values,
+    .put_array_words            = vpip_put_array_words,
+    .get_array_words            = vpip_get_array_words,
 };
 
 typedef PLI_UINT32 (*vpip_set_callback_t)(vpip_routines_s*, PLI_UINT32);
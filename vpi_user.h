@@ -659,6 +659,73 @@ extern void vpip_mcd_rawwrite(PLI_UINT32 mcd, const char*buf, size_t count);
 extern void vpip_count_drivers(vpiHandle ref, unsigned idx,
                                unsigned counts[4]);
 
+  /* Native value change tracing. This is a low overhead alternative
+     to cbValueChange callbacks for waveform dumpers. The vvp run time
+     notes which traced signals changed during a time step, and in the
+     read-only synch region of that step passes the final value of each
+     of them to the handler of the tracer in a single batch. Vector
+     values are passed as raw aval/bval words (LSB first), real values
+     in the real member. The record array is only valid during the
+     handler call.
+
+     The vpip_trace_register function registers a handler and returns
+     a tracer id for it, or 0 if tracing is not supported. Each tracer
+     gets only the records of the signals that were added to it, so
+     several dumpers can trace at once. The vpip_trace_unregister
+     function stops calls to the handler of a tracer.
+
+     The vpip_trace_add function returns 1 if the object can be traced
+     this way, or 0 if the caller must fall back to a cbValueChange
+     callback. Only whole signals (nets, variables and reals) that are
+     not automatic are supported. */
+typedef struct t_vpip_trace_rec {
+      void*user_data;          /* user_data passed to vpip_trace_add */
+      PLI_UINT32 size;         /* Width in bits, or 0 for a real value */
+      p_vpi_vecval vector;     /* (size+31)/32 words of value */
+      double real;             /* The value if this is a real */
+} s_vpip_trace_rec, *p_vpip_trace_rec;
+
+typedef void (*vpip_trace_handler_t)(PLI_UINT64 time,
+                                     const s_vpip_trace_rec*recs,
+                                     unsigned count, void*data);
+
+extern PLI_INT32 vpip_trace_register(vpip_trace_handler_t func, void*data);
+extern void vpip_trace_unregister(PLI_INT32 tracer);
+extern PLI_INT32 vpip_trace_add(PLI_INT32 tracer, vpiHandle ref,
+                                void*user_data);
+
+  /* Get or put the values of many objects in a single call. The
+     format must be vpiVectorVal, vpiIntVal or vpiRealVal. For
+     vpiVectorVal the buf is an array of s_vpi_vecval that holds the
+     values of the objects one after the other, each taking
+     (vpiSize+31)/32 words. For vpiIntVal the buf is an array of
+     PLI_INT32, and for vpiRealVal an array of double, with one entry
+     per object. Values are put with vpiNoDelay. Signals are accessed
+     directly, without going through the shared result buffer; other
+     objects use their normal vpi_get_value/vpi_put_value methods. The
+     return value is the number of objects processed, which is less
+     than count if an unsupported format or object is found. */
+extern PLI_INT32 vpip_get_values(const vpiHandle*refs, PLI_UINT32 count,
+                                 PLI_INT32 format, void*buf);
+extern PLI_INT32 vpip_put_values(const vpiHandle*refs, PLI_UINT32 count,
+                                 PLI_INT32 format, const void*buf);
+
+  /* Put or get count words of a memory (vpiMemory) in one call. The
+     first word is the one with index addr, and the index of each
+     following word is incr (1 or -1) more. The buf holds the values
+     one after the other in vpiVectorVal form, each taking
+     (width+31)/32 words where width is the vpiSize of a memory
+     word. Values are put with vpiNoDelay. The return value is the
+     number of words transferred. This stops early at the end of the
+     memory, and is 0 for memories (e.g. of reals) that cannot be
+     accessed this way. */
+extern PLI_INT32 vpip_put_array_words(vpiHandle ref, PLI_INT32 addr,
+                                      PLI_INT32 incr, PLI_UINT32 count,
+                                      const s_vpi_vecval*buf);
+extern PLI_INT32 vpip_get_array_words(vpiHandle ref, PLI_INT32 addr,
+                                      PLI_INT32 incr, PLI_UINT32 count,
+                                      s_vpi_vecval*buf);
+
 /*
  * Stopgap fix for br916. We need to reject any attempt to pass a thread
  * variable to $strobe or $monitor. To do this, we use some private VPI
@@ -688,7 +755,7 @@ extern void vpip_count_drivers(vpiHandle ref, unsigned idx,
  */
 
 // Increment the version number any time vpip_routines_s is changed.
-static const PLI_UINT32 vpip_routines_version = 1;
+static const PLI_UINT32 vpip_routines_version = 5;
 
 typedef struct {
     vpiHandle   (*register_cb)(p_cb_data);
@@ -729,6 +796,13 @@ typedef struct {
     void        (*make_systf_system_defined)(vpiHandle);
     void        (*mcd_rawwrite)(PLI_UINT32, const char*, size_t);
     void        (*set_return_value)(int);
+    PLI_INT32   (*trace_register)(vpip_trace_handler_t, void*);
+    void        (*trace_unregister)(PLI_INT32);
+    PLI_INT32   (*trace_add)(PLI_INT32, vpiHandle, void*);
+    PLI_INT32   (*get_values)(const vpiHandle*, PLI_UINT32, PLI_INT32, void*);
+    PLI_INT32   (*put_values)(const vpiHandle*, PLI_UINT32, PLI_INT32, const void*);
+    PLI_INT32   (*put_array_words)(vpiHandle, PLI_INT32, PLI_INT32, PLI_UINT32, const s_vpi_vecval*);
+    PLI_INT32   (*get_array_words)(vpiHandle, PLI_INT32, PLI_INT32, PLI_UINT32, s_vpi_vecval*);
 } vpip_routines_s;
 
 extern DLLEXPORT PLI_UINT32 vpip_set_callback(vpip_routines_s*routines, PLI_UINT32 version);
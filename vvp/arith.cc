@@ -185,13 +185,13 @@ void vvp_arith_div::wide4_(vvp_net_ptr_t ptr)
 {
       vvp_vector2_t a2 (op_a_, true);
       if (a2.is_NaN()) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
       vvp_vector2_t b2 (op_b_, true);
       if (b2.is_NaN() || b2.is_zero()) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -208,7 +208,7 @@ void vvp_arith_div::wide4_(vvp_net_ptr_t ptr)
       }
       vvp_vector2_t res = a2 / b2;
       if (negate) res = -res;
-      ptr.ptr()->send_vec4(vector2_to_vector4(res, wid_), 0);
+      send_vec4_cached(ptr.ptr(), vector2_to_vector4(res, wid_));
 }
 
 void vvp_arith_div::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
@@ -223,13 +223,13 @@ void vvp_arith_div::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 
       unsigned long a;
       if (! vector4_to_value(op_a_, a)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
       unsigned long b;
       if (! vector4_to_value(op_b_, b)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -262,7 +262,7 @@ void vvp_arith_div::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    for (unsigned idx = 0 ;  idx < wid_ ;  idx += 1)
 		  xval.set_bit(idx, BIT4_X);
 
-	    ptr.ptr()->send_vec4(xval, 0);
+	    send_vec4_cached(ptr.ptr(), xval);
 	    return;
       }
 
@@ -282,7 +282,7 @@ void vvp_arith_div::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    val >>= 1;
       }
 
-      ptr.ptr()->send_vec4(vval, 0);
+      send_vec4_cached(ptr.ptr(), vval);
 }
 
 
@@ -299,13 +299,13 @@ void vvp_arith_mod::wide_(vvp_net_ptr_t ptr)
 {
       vvp_vector2_t a2 (op_a_, true);
       if (a2.is_NaN()) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
       vvp_vector2_t b2 (op_b_, true);
       if (b2.is_NaN() || b2.is_zero()) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -321,7 +321,7 @@ void vvp_arith_mod::wide_(vvp_net_ptr_t ptr)
       }
       vvp_vector2_t res = a2 % b2;
       if (negate) res = -res;
-      ptr.ptr()->send_vec4(vector2_to_vector4(res, res.size()), 0);
+      send_vec4_cached(ptr.ptr(), vector2_to_vector4(res, res.size()));
 }
 
 void vvp_arith_mod::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
@@ -336,13 +336,13 @@ void vvp_arith_mod::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 
       unsigned long a;
       if (! vector4_to_value(op_a_, a)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
       unsigned long b;
       if (! vector4_to_value(op_b_, b)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -374,7 +374,7 @@ void vvp_arith_mod::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    for (unsigned idx = 0 ;  idx < wid_ ;  idx += 1)
 		  xval.set_bit(idx, BIT4_X);
 
-	    ptr.ptr()->send_vec4(xval, 0);
+	    send_vec4_cached(ptr.ptr(), xval);
 	    return;
       }
 
@@ -394,7 +394,7 @@ void vvp_arith_mod::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    val >>= 1;
       }
 
-      ptr.ptr()->send_vec4(vval, 0);
+      send_vec4_cached(ptr.ptr(), vval);
 }
 
 
@@ -415,14 +415,14 @@ void vvp_arith_mult::wide_(vvp_net_ptr_t ptr)
       vvp_vector2_t b2 (op_b_, true);
 
       if (a2.is_NaN() || b2.is_NaN()) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
       vvp_vector2_t result = a2 * b2;
 
       vvp_vector4_t res4 = vector2_to_vector4(result, wid_);
-      ptr.ptr()->send_vec4(res4, 0);
+      send_vec4_cached(ptr.ptr(), res4);
 }
 
 void vvp_arith_mult::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
@@ -437,13 +437,13 @@ void vvp_arith_mult::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 
       int64_t a;
       if (! vector4_to_value(op_a_, a, false, true)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
       int64_t b;
       if (! vector4_to_value(op_b_, b, false, true)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -460,7 +460,7 @@ void vvp_arith_mult::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    val >>= 1;
       }
 
-      ptr.ptr()->send_vec4(vval, 0);
+      send_vec4_cached(ptr.ptr(), vval);
 }
 
 
@@ -485,7 +485,7 @@ void vvp_arith_pow::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 
         // If we have an X or Z in the arguments return X.
       if (a2.is_NaN() || b2.is_NaN()) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -496,7 +496,7 @@ void vvp_arith_pow::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    double r_val = 0.0;
 	    if (vector2_to_value(a2, a_val, true)) {
 		  if (a_val == 0) {
-			ptr.ptr()->send_vec4(x_val_, 0);
+			send_vec4_cached(ptr.ptr(), x_val_);
 			return;
 		  }
 		  if (a_val == 1) {
@@ -506,11 +506,11 @@ void vvp_arith_pow::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 			r_val = b2.value(0) ? -1.0 : 1.0;
 		  }
 	    }
-	    ptr.ptr()->send_vec4(vvp_vector4_t(wid_, r_val), 0);
+	    send_vec4_cached(ptr.ptr(), vvp_vector4_t(wid_, r_val));
 	    return;
       }
 
-      ptr.ptr()->send_vec4(vector2_to_vector4(pow(a2, b2), wid_), 0);
+      send_vec4_cached(ptr.ptr(), vector2_to_vector4(pow(a2, b2), wid_));
 }
 
 
@@ -545,14 +545,14 @@ void vvp_arith_sum::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    vvp_bit4_t cur = add_with_carry(a, b, carry);
 
 	    if (cur == BIT4_X) {
-		  net->send_vec4(x_val_, 0);
+		  send_vec4_cached(net, x_val_);
 		  return;
 	    }
 
 	    value.set_bit(idx, cur);
       }
 
-      net->send_vec4(value, 0);
+      send_vec4_cached(net, value);
 }
 
 vvp_arith_sub::vvp_arith_sub(unsigned wid)
@@ -590,14 +590,14 @@ void vvp_arith_sub::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 	    vvp_bit4_t cur = add_with_carry(a, b, carry);
 
 	    if (cur == BIT4_X) {
-		  net->send_vec4(x_val_, 0);
+		  send_vec4_cached(net, x_val_);
 		  return;
 	    }
 
 	    value.set_bit(idx, cur);
       }
 
-      net->send_vec4(value, 0);
+      send_vec4_cached(net, value);
 }
 
 vvp_cmp_eeq::vvp_cmp_eeq(unsigned wid)
@@ -622,7 +622,7 @@ void vvp_cmp_eeq::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(eeq, 0);
+      send_vec4_cached(net, eeq);
 }
 
 vvp_cmp_nee::vvp_cmp_nee(unsigned wid)
@@ -647,7 +647,7 @@ void vvp_cmp_nee::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(eeq, 0);
+      send_vec4_cached(net, eeq);
 }
 
 vvp_cmp_eq::vvp_cmp_eq(unsigned wid)
@@ -694,7 +694,7 @@ void vvp_cmp_eq::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       }
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(res, 0);
+      send_vec4_cached(net, res);
 }
 
 vvp_cmp_eqx::vvp_cmp_eqx(unsigned wid)
@@ -737,7 +737,7 @@ void vvp_cmp_eqx::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       }
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(res, 0);
+      send_vec4_cached(net, res);
 }
 
 vvp_cmp_eqz::vvp_cmp_eqz(unsigned wid)
@@ -772,7 +772,7 @@ void vvp_cmp_eqz::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       }
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(res, 0);
+      send_vec4_cached(net, res);
 }
 
 vvp_cmp_ne::vvp_cmp_ne(unsigned wid)
@@ -819,7 +819,7 @@ void vvp_cmp_ne::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       }
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(res, 0);
+      send_vec4_cached(net, res);
 }
 
 
@@ -840,7 +840,7 @@ void vvp_cmp_gtge_base_::recv_vec4_base_(vvp_net_ptr_t ptr,
 	    : compare_gtge(op_a_, op_b_, out_if_equal);
       vvp_vector4_t val (1);
       val.set_bit(0, out);
-      ptr.ptr()->send_vec4(val, 0);
+      send_vec4_cached(ptr.ptr(), val);
 
       return;
 }
@@ -900,7 +900,7 @@ void vvp_cmp_weq::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       }
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(eeq, 0);
+      send_vec4_cached(net, eeq);
 }
 
 vvp_cmp_wne::vvp_cmp_wne(unsigned wid)
@@ -935,7 +935,7 @@ void vvp_cmp_wne::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       }
 
       vvp_net_t*net = ptr.ptr();
-      net->send_vec4(eeq, 0);
+      send_vec4_cached(net, eeq);
 }
 
 
@@ -958,7 +958,7 @@ void vvp_shiftl::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       bool overflow_flag;
       unsigned long shift;
       if (! vector4_to_value(op_b_, overflow_flag, shift)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -971,7 +971,7 @@ void vvp_shiftl::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       for (unsigned idx = shift ;  idx < out.size() ;  idx += 1)
 	    out.set_bit(idx, op_a_.value(idx-shift));
 
-      ptr.ptr()->send_vec4(out, 0);
+      send_vec4_cached(ptr.ptr(), out);
 }
 
 vvp_shiftr::vvp_shiftr(unsigned wid, bool signed_flag)
@@ -993,7 +993,7 @@ void vvp_shiftr::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       bool overflow_flag;
       unsigned long shift;
       if (! vector4_to_value(op_b_, overflow_flag, shift)) {
-	    ptr.ptr()->send_vec4(x_val_, 0);
+	    send_vec4_cached(ptr.ptr(), x_val_);
 	    return;
       }
 
@@ -1010,7 +1010,7 @@ void vvp_shiftr::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       for (unsigned idx = 0 ;  idx < shift ;  idx += 1)
 	    out.set_bit(idx+out.size()-shift, pad);
 
-      ptr.ptr()->send_vec4(out, 0);
+      send_vec4_cached(ptr.ptr(), out);
 }
 
 
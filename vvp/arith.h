@@ -32,7 +32,7 @@
  * inputs to match, and since only one input at a time changes, the
  * other will need to be initialized to X.
  */
-class vvp_arith_  : public vvp_net_fun_t {
+class vvp_arith_  : public vvp_net_fun_t, protected vvp_output_cache4 {
 
     public:
       explicit vvp_arith_(unsigned wid);
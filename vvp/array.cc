@@ -778,6 +778,80 @@ string __vpiArray::get_word_str(unsigned address)
       return "";
 }
 
+/*
+ * Check that ref is a memory that vpip_put_array_words and
+ * vpip_get_array_words can access, and return the array and the
+ * number of vecval words in each memory word.
+ */
+static __vpiArray* array_words_check(vpiHandle ref, PLI_INT32 incr,
+				     unsigned&words)
+{
+      __vpiArray*arr = dynamic_cast<__vpiArray*>(ref);
+      if (arr == 0 || arr->get_size() == 0)
+	    return 0;
+      if (incr != 1 && incr != -1)
+	    return 0;
+      if (vpi_array_is_real(arr) || vpi_array_is_string(arr))
+	    return 0;
+      if (arr->vals && arr->vals4 == 0 && arr->vals_width == 0)
+	    return 0;
+
+      words = (arr->get_word_size() + 31) / 32;
+      return arr;
+}
+
+extern "C" PLI_INT32 vpip_put_array_words(vpiHandle ref, PLI_INT32 addr,
+					  PLI_INT32 incr, PLI_UINT32 count,
+					  const s_vpi_vecval*buf)
+{
+      if (schedule_at_rosync()) {
+	    fprintf(stderr, "VPI error: attempted to put values "
+	                    "during a read-only synch callback.\n");
+	    return 0;
+      }
+
+      unsigned words;
+      __vpiArray*arr = array_words_check(ref, incr, words);
+      if (arr == 0)
+	    return 0;
+
+      vvp_vector4_t tmp (arr->get_word_size());
+      long index = (long)addr - arr->first_addr.get_value();
+      PLI_UINT32 idx;
+      for (idx = 0 ;  idx < count ;  idx += 1) {
+	    if (index < 0 || index >= (long)arr->get_size())
+		  break;
+	    tmp.set_vecval(buf);
+	    arr->set_word(index, 0, tmp);
+	    buf += words;
+	    index += incr;
+      }
+
+      return idx;
+}
+
+extern "C" PLI_INT32 vpip_get_array_words(vpiHandle ref, PLI_INT32 addr,
+					  PLI_INT32 incr, PLI_UINT32 count,
+					  s_vpi_vecval*buf)
+{
+      unsigned words;
+      __vpiArray*arr = array_words_check(ref, incr, words);
+      if (arr == 0)
+	    return 0;
+
+      long index = (long)addr - arr->first_addr.get_value();
+      PLI_UINT32 idx;
+      for (idx = 0 ;  idx < count ;  idx += 1) {
+	    if (index < 0 || index >= (long)arr->get_size())
+		  break;
+	    arr->get_word(index).get_vecval(buf);
+	    buf += words;
+	    index += incr;
+      }
+
+      return idx;
+}
+
 vpiHandle vpip_make_array(char*label, const char*name,
 				 int first_addr, int last_addr,
 				 bool signed_flag)
@@ -1158,7 +1232,7 @@ vvp_fun_arrayport_aa::~vvp_fun_arrayport_aa()
 
 void vvp_fun_arrayport_aa::alloc_instance(vvp_context_t context)
 {
-      unsigned long*addr = new unsigned long;
+      unsigned long*addr = vvp_context_new<unsigned long>();
       vvp_set_context_item(context, context_idx_, addr);
 
       *addr = addr_;
@@ -1177,7 +1251,7 @@ void vvp_fun_arrayport_aa::free_instance(vvp_context_t context)
 {
       unsigned long*addr = static_cast<unsigned long*>
             (vvp_get_context_item(context, context_idx_));
-      delete addr;
+      vvp_context_delete(addr);
 }
 #endif
 
@@ -396,22 +396,41 @@ void property_object::copy(char*dst, char*src)
 
 /* **** */
 
+static vector<class_type*> all_class_types;
+
 class_type::class_type(const string&nam, size_t nprop)
 : class_name_(nam), properties_(nprop)
 {
       instance_size_ = 0;
+      has_objects_ = false;
+      instance_count_ = 0;
+      reused_count_ = 0;
+      live_count_ = 0;
+      peak_live_count_ = 0;
+      all_class_types.push_back(this);
 }
 
 class_type::~class_type()
 {
       for (size_t idx = 0 ; idx < properties_.size() ; idx += 1)
 	    delete properties_[idx].type;
+      for (size_t idx = 0 ; idx < free_instances_.size() ; idx += 1)
+	    delete[]free_instances_[idx];
+
+      for (size_t idx = 0 ; idx < all_class_types.size() ; idx += 1) {
+	    if (all_class_types[idx] == this) {
+		  all_class_types.erase(all_class_types.begin() + idx);
+		  break;
+	    }
+      }
 }
 
 void class_type::set_property(size_t idx, const string&name, const string&type, uint64_t array_size)
 {
       assert(idx < properties_.size());
       properties_[idx].name = name;
+      properties_[idx].kind = PROP_OTHER;
+      properties_[idx].offset = 0;
 
       if (type == "b8")
 	    properties_[idx].type = new property_atom<uint8_t>;
@@ -429,21 +448,27 @@ void class_type::set_property(size_t idx, const string&name, const string&type,
 	    properties_[idx].type = new property_atom<int32_t>;
       else if (type == "sb64")
 	    properties_[idx].type = new property_atom<int64_t>;
-      else if (type == "r")
+      else if (type == "r") {
 	    properties_[idx].type = new property_real<double>;
-      else if (type == "S")
+	    properties_[idx].kind = PROP_REAL;
+      } else if (type == "S") {
 	    properties_[idx].type = new property_string;
-      else if (type == "o")
+	    properties_[idx].kind = PROP_STRING;
+      } else if (type == "o") {
 	    properties_[idx].type = new property_object(array_size);
-      else if (type[0] == 'b') {
+	    properties_[idx].kind = PROP_OBJECT;
+	    has_objects_ = true;
+      } else if (type[0] == 'b') {
 	    size_t wid = strtoul(type.c_str()+1, 0, 0);
 	    properties_[idx].type = new property_bit(wid);
       } else if (type[0] == 'L') {
 	    size_t wid = strtoul(type.c_str()+1,0,0);
 	    properties_[idx].type = new property_logic(wid);
+	    properties_[idx].kind = PROP_LOGIC;
       } else if (type[0] == 's' && type[1] == 'L') {
 	    size_t wid = strtoul(type.c_str()+2,0,0);
 	    properties_[idx].type = new property_logic(wid);
+	    properties_[idx].kind = PROP_LOGIC;
       } else {
 	    properties_[idx].type = 0;
       }
@@ -475,6 +500,7 @@ void class_type::finish_setup(void)
 		  class_property_t*ptype = properties_[pid].type;
 		  assert(ptype->instance_size() == cur->first);
 		  ptype->set_offset(accum);
+		  properties_[pid].offset = accum;
 		  accum += cur->first;
 	    }
       }
@@ -482,11 +508,23 @@ void class_type::finish_setup(void)
 
 class_type::inst_t class_type::instance_new() const
 {
-      char*buf = new char [instance_size_];
+      char*buf;
+      if (free_instances_.empty()) {
+	    buf = new char [instance_size_];
+      } else {
+	    buf = free_instances_.back();
+	    free_instances_.pop_back();
+	    reused_count_ += 1;
+      }
 
       for (size_t idx = 0 ; idx < properties_.size() ; idx += 1)
 	    properties_[idx].type->construct(buf);
 
+      instance_count_ += 1;
+      live_count_ += 1;
+      if (live_count_ > peak_live_count_)
+	    peak_live_count_ = live_count_;
+
       return reinterpret_cast<inst_t> (buf);
 }
 
@@ -497,7 +535,9 @@ void class_type::instance_delete(class_type::inst_t obj) const
       for (size_t idx = 0 ; idx < properties_.size() ; idx += 1)
 	    properties_[idx].type->destruct(buf);
 
-      delete[]buf;
+      assert(live_count_ > 0);
+      live_count_ -= 1;
+      free_instances_.push_back(buf);
 }
 
 void class_type::set_vec4(class_type::inst_t obj, size_t pid,
@@ -505,7 +545,11 @@ void class_type::set_vec4(class_type::inst_t obj, size_t pid,
 {
       char*buf = reinterpret_cast<char*> (obj);
       assert(pid < properties_.size());
-      properties_[pid].type->set_vec4(buf, val);
+      const prop_t&prop = properties_[pid];
+      if (prop.kind == PROP_LOGIC)
+	    *reinterpret_cast<vvp_vector4_t*>(buf + prop.offset) = val;
+      else
+	    prop.type->set_vec4(buf, val);
 }
 
 void class_type::get_vec4(class_type::inst_t obj, size_t pid,
@@ -513,53 +557,60 @@ void class_type::get_vec4(class_type::inst_t obj, size_t pid,
 {
       char*buf = reinterpret_cast<char*> (obj);
       assert(pid < properties_.size());
-      properties_[pid].type->get_vec4(buf, val);
-}
-
-void class_type::set_real(class_type::inst_t obj, size_t pid,
-			  double val) const
-{
-      char*buf = reinterpret_cast<char*> (obj);
-      assert(pid < properties_.size());
-      properties_[pid].type->set_real(buf, val);
-}
-
-double class_type::get_real(class_type::inst_t obj, size_t pid) const
-{
-      char*buf = reinterpret_cast<char*> (obj);
-      assert(pid < properties_.size());
-      return properties_[pid].type->get_real(buf);
+      const prop_t&prop = properties_[pid];
+      if (prop.kind == PROP_LOGIC)
+	    val = *reinterpret_cast<vvp_vector4_t*>(buf + prop.offset);
+      else
+	    prop.type->get_vec4(buf, val);
 }
 
-void class_type::set_string(class_type::inst_t obj, size_t pid,
-			    const string&val) const
+void class_type::set_object(class_type::inst_t obj, size_t pid,
+			    const vvp_object_t&val, size_t idx) const
 {
       char*buf = reinterpret_cast<char*> (obj);
       assert(pid < properties_.size());
-      properties_[pid].type->set_string(buf, val);
+      properties_[pid].type->set_object(buf, val, idx);
 }
 
-string class_type::get_string(class_type::inst_t obj, size_t pid) const
+void class_type::get_object(class_type::inst_t obj, size_t pid,
+			    vvp_object_t&val, size_t idx) const
 {
       char*buf = reinterpret_cast<char*> (obj);
       assert(pid < properties_.size());
-      return properties_[pid].type->get_string(buf);
+      properties_[pid].type->get_object(buf, val, idx);
 }
 
-void class_type::set_object(class_type::inst_t obj, size_t pid,
-			    const vvp_object_t&val, size_t idx) const
+void class_type::get_object_references(class_type::inst_t obj,
+				       vector<vvp_object*>&list) const
 {
       char*buf = reinterpret_cast<char*> (obj);
-      assert(pid < properties_.size());
-      properties_[pid].type->set_object(buf, val, idx);
+      for (size_t pid = 0 ; pid < properties_.size() ; pid += 1) {
+	    const prop_t&prop = properties_[pid];
+	    if (prop.kind != PROP_OBJECT)
+		  continue;
+
+	    vvp_object_t*val = reinterpret_cast<vvp_object_t*>(buf + prop.offset);
+	    size_t count = prop.type->instance_size() / sizeof(vvp_object_t);
+	    for (size_t idx = 0 ; idx < count ; idx += 1) {
+		  if (vvp_object*tmp = val[idx].peek<vvp_object>())
+			list.push_back(tmp);
+	    }
+      }
 }
 
-void class_type::get_object(class_type::inst_t obj, size_t pid,
-			    vvp_object_t&val, size_t idx) const
+void class_type::clear_object_references(class_type::inst_t obj) const
 {
       char*buf = reinterpret_cast<char*> (obj);
-      assert(pid < properties_.size());
-      properties_[pid].type->get_object(buf, val, idx);
+      for (size_t pid = 0 ; pid < properties_.size() ; pid += 1) {
+	    const prop_t&prop = properties_[pid];
+	    if (prop.kind != PROP_OBJECT)
+		  continue;
+
+	    vvp_object_t*val = reinterpret_cast<vvp_object_t*>(buf + prop.offset);
+	    size_t count = prop.type->instance_size() / sizeof(vvp_object_t);
+	    for (size_t idx = 0 ; idx < count ; idx += 1)
+		  val[idx].reset();
+      }
 }
 
 void class_type::copy_property(class_type::inst_t dst, size_t pid, class_type::inst_t src) const
@@ -572,6 +623,23 @@ void class_type::copy_property(class_type::inst_t dst, size_t pid, class_type::i
       properties_[pid].type->copy(dst_buf, src_buf);
 }
 
+void class_type::report_statistics(void)
+{
+      if (all_class_types.empty())
+	    return;
+
+      vpi_mcd_printf(1, "Class instances:\n");
+      for (size_t idx = 0 ; idx < all_class_types.size() ; idx += 1) {
+	    const class_type*cur = all_class_types[idx];
+	    if (cur->instance_count_ == 0)
+		  continue;
+	    vpi_mcd_printf(1, "    %8lu %s (reused=%lu, peak live=%lu, %zu bytes each)\n",
+			   cur->instance_count_, cur->class_name_.c_str(),
+			   cur->reused_count_, cur->peak_live_count_,
+			   cur->instance_size_);
+      }
+}
+
 int class_type::get_type_code(void) const
 {
       return vpiClassDefn;
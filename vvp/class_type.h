@@ -21,6 +21,7 @@
 
 # include  <string>
 # include  <vector>
+# include  <cassert>
 # include  "vpi_priv.h"
 
 class class_property_t;
@@ -56,33 +57,76 @@ class class_type : public __vpiHandle {
       void finish_setup(void);
 
     public:
-	// Constructors and destructors for making instances.
+	// Constructors and destructors for making instances. The
+	// instance memory of deleted instances is kept for reuse by
+	// later instances of the same class.
       inst_t instance_new() const;
       void instance_delete(inst_t) const;
 
+	// The real, string and 4-state vector properties are accessed
+	// directly at their offset within the instance. The other
+	// property types convert or check the value, and that is done
+	// by the property type.
       void set_vec4(inst_t inst, size_t pid, const vvp_vector4_t&val) const;
       void get_vec4(inst_t inst, size_t pid, vvp_vector4_t&val) const;
-      void set_real(inst_t inst, size_t pid, double val) const;
-      double get_real(inst_t inst, size_t pid) const;
-      void set_string(inst_t inst, size_t pid, const std::string&val) const;
-      std::string get_string(inst_t inst, size_t pid) const;
+      inline void set_real(inst_t inst, size_t pid, double val) const
+      { *prop_ptr_<double>(inst, pid, PROP_REAL) = val; }
+      inline double get_real(inst_t inst, size_t pid) const
+      { return *prop_ptr_<double>(inst, pid, PROP_REAL); }
+      inline void set_string(inst_t inst, size_t pid, const std::string&val) const
+      { *prop_ptr_<std::string>(inst, pid, PROP_STRING) = val; }
+      inline const std::string& get_string(inst_t inst, size_t pid) const
+      { return *prop_ptr_<std::string>(inst, pid, PROP_STRING); }
       void set_object(inst_t inst, size_t pid, const vvp_object_t&val, size_t idx) const;
       void get_object(inst_t inst, size_t pid, vvp_object_t&val, size_t idx) const;
 
       void copy_property(inst_t dst, size_t idx, inst_t src) const;
 
+	// These support the cycle collector. They get and clear the
+	// objects that the object properties of an instance refer to.
+      inline bool has_object_properties(void) const
+      { return has_objects_; }
+      void get_object_references(inst_t inst, std::vector<vvp_object*>&list) const;
+      void clear_object_references(inst_t inst) const;
+
+	// Report the instance counts of all the classes.
+      static void report_statistics(void);
+
     public: // VPI related methods
       int get_type_code(void) const;
 
     private:
+      enum prop_kind_t { PROP_OTHER, PROP_LOGIC, PROP_REAL, PROP_STRING,
+			 PROP_OBJECT };
+
+      template <class T> inline T* prop_ptr_(inst_t inst, size_t pid,
+                                             prop_kind_t kind) const
+      {
+	    assert(pid < properties_.size());
+	    const prop_t&prop = properties_[pid];
+	    assert(prop.kind == kind);
+	    return reinterpret_cast<T*>(reinterpret_cast<char*>(inst) + prop.offset);
+      }
+
       std::string class_name_;
 
       struct prop_t {
 	    std::string name;
 	    class_property_t*type;
+	    prop_kind_t kind;
+	    size_t offset;
       };
       std::vector<prop_t> properties_;
       size_t instance_size_;
+      bool has_objects_;
+
+	// Instance memory that is free for reuse.
+      mutable std::vector<char*> free_instances_;
+	// Statistics
+      mutable unsigned long instance_count_;
+      mutable unsigned long reused_count_;
+      mutable unsigned long live_count_;
+      mutable unsigned long peak_live_count_;
 };
 
 #endif /* IVL_class_type_H */
@@ -69,6 +69,7 @@ extern bool of_CAST2(vthread_t thr, vvp_code_t code);
 extern bool of_CAST_VEC2_DAR(vthread_t thr, vvp_code_t code);
 extern bool of_CAST_VEC4_DAR(vthread_t thr, vvp_code_t code);
 extern bool of_CAST_VEC4_STR(vthread_t thr, vvp_code_t code);
+extern bool of_CLOG2(vthread_t thr, vvp_code_t code);
 extern bool of_CMPE(vthread_t thr, vvp_code_t code);
 extern bool of_CMPIE(vthread_t thr, vvp_code_t code);
 extern bool of_CMPINE(vthread_t thr, vvp_code_t code);
@@ -198,6 +199,7 @@ extern bool of_QPOP_B_V(vthread_t thr, vvp_code_t code);
 extern bool of_QPOP_F_REAL(vthread_t thr, vvp_code_t code);
 extern bool of_QPOP_F_STR(vthread_t thr, vvp_code_t code);
 extern bool of_QPOP_F_V(vthread_t thr, vvp_code_t code);
+extern bool of_PRODUCT_DAR(vthread_t thr, vvp_code_t code);
 extern bool of_PROP_OBJ(vthread_t thr, vvp_code_t code);
 extern bool of_PROP_R(vthread_t thr, vvp_code_t code);
 extern bool of_PROP_STR(vthread_t thr, vvp_code_t code);
@@ -205,6 +207,8 @@ extern bool of_PROP_V(vthread_t thr, vvp_code_t code);
 extern bool of_PUSHI_STR(vthread_t thr, vvp_code_t code);
 extern bool of_PUSHI_REAL(vthread_t thr, vvp_code_t code);
 extern bool of_PUSHI_VEC4(vthread_t thr, vvp_code_t code);
+extern bool of_PUSHTIME_REAL(vthread_t thr, vvp_code_t code);
+extern bool of_PUSHTIME_VEC4(vthread_t thr, vvp_code_t code);
 extern bool of_PUSHV_STR(vthread_t thr, vvp_code_t code);
 extern bool of_PUTC_STR_VEC4(vthread_t thr, vvp_code_t code);
 extern bool of_RELEASE_NET(vthread_t thr, vvp_code_t code);
@@ -217,6 +221,7 @@ extern bool of_RET_VEC4(vthread_t thr, vvp_code_t code);
 extern bool of_RETLOAD_REAL(vthread_t thr, vvp_code_t code);
 extern bool of_RETLOAD_STR(vthread_t thr, vvp_code_t code);
 extern bool of_RETLOAD_VEC4(vthread_t thr, vvp_code_t code);
+extern bool of_REVERSE_DAR(vthread_t thr, vvp_code_t code);
 extern bool of_SCOPY(vthread_t thr, vvp_code_t code);
 extern bool of_SET_DAR_OBJ_REAL(vthread_t thr, vvp_code_t code);
 extern bool of_SET_DAR_OBJ_STR(vthread_t thr, vvp_code_t code);
@@ -225,6 +230,7 @@ extern bool of_SET_X0_X(vthread_t thr, vvp_code_t code);
 extern bool of_SHIFTL(vthread_t thr, vvp_code_t code);
 extern bool of_SHIFTR(vthread_t thr, vvp_code_t code);
 extern bool of_SHIFTR_S(vthread_t thr, vvp_code_t code);
+extern bool of_SORT_DAR(vthread_t thr, vvp_code_t code);
 extern bool of_SPLIT_VEC4(vthread_t thr, vvp_code_t code);
 extern bool of_STORE_DAR_R(vthread_t thr, vvp_code_t code);
 extern bool of_STORE_DAR_STR(vthread_t thr, vvp_code_t code);
@@ -258,6 +264,7 @@ extern bool of_SUBI(vthread_t thr, vvp_code_t code);
 extern bool of_SUB_WR(vthread_t thr, vvp_code_t code);
 extern bool of_SUBSTR(vthread_t thr, vvp_code_t code);
 extern bool of_SUBSTR_VEC4(vthread_t thr, vvp_code_t code);
+extern bool of_SUM_DAR(vthread_t thr, vvp_code_t code);
 extern bool of_TEST_NUL(vthread_t thr, vvp_code_t code);
 extern bool of_TEST_NUL_A(vthread_t thr, vvp_code_t code);
 extern bool of_TEST_NUL_OBJ(vthread_t thr, vvp_code_t code);
@@ -299,6 +306,7 @@ struct vvp_code_s {
 	    vvp_net_t   *net2;
 	    vvp_code_t   cptr2;
 	    class ufunc_core*ufunc_core_ptr;
+	    struct waitable_hooks_s*waitable;
       };
 };
 
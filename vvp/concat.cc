@@ -61,7 +61,7 @@ void vvp_fun_concat::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
 	    val_.set_bit(off+idx, bit.value(idx));
       }
 
-      port.ptr()->send_vec4(val_, 0);
+      send_vec4_cached(port.ptr(), val_);
 }
 
 void vvp_fun_concat::recv_vec4_pv(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -91,7 +91,7 @@ void vvp_fun_concat::recv_vec4_pv(vvp_net_ptr_t port, const vvp_vector4_t&bit,
 	    val_.set_bit(off+idx, bit.value(idx));
       }
 
-      port.ptr()->send_vec4(val_, 0);
+      send_vec4_cached(port.ptr(), val_);
 }
 
 void compile_concat(char*label, unsigned w0, unsigned w1,
@@ -234,7 +234,7 @@ void vvp_fun_repeat::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
 
       }
 
-      port.ptr()->send_vec4(val, 0);
+      send_vec4_cached(port.ptr(), val);
 }
 
 void compile_repeat(char*label, long width, long repeat, struct symb_s arg)
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+# include  "config.h"
+# include  "coverage.h"
+# include  "coverage_db.h"
+# include  "vpi_priv.h"
+# include  "vvp_net_sig.h"
+# include  <cstdlib>
+# include  <cstring>
+# include  <vector>
+
+using namespace std;
+
+bool coverage_flag = false;
+static const char*coverage_path = "vvp.cov";
+
+struct cover_line_s {
+      vpiHandle file_line;
+      __vpiScope*scope;
+};
+
+static vector<cover_line_s> line_table;
+
+struct cover_toggle_s {
+      vvp_net_fil_t*fil;
+      const char*name;
+	// A coverage_db::TOGGLE_* mask for each bit.
+      vector<unsigned char> flags;
+	// The number of rise/fall flags that are not yet set.
+      unsigned missing;
+};
+
+  // The toggle id of a filter is its index in this table. The first
+  // entry is not used so that an id of 0 means not covered.
+static vector<cover_toggle_s> toggle_table;
+
+void coverage_args(int argc, char*argv[])
+{
+      for (int idx = 0 ;  idx < argc ;  idx += 1) {
+	    const char*arg = argv[idx];
+	    if (strcmp(arg, "-coverage") == 0) {
+		  coverage_flag = true;
+
+	    } else if (strncmp(arg, "-coverage=", 10) == 0) {
+		  if (arg[10] == 0) {
+			fprintf(stderr, "Warning: Missing coverage "
+			        "database name.\n");
+			continue;
+		  }
+		  coverage_path = arg+10;
+		  coverage_flag = true;
+	    }
+      }
+}
+
+void coverage_add_line(vpiHandle file_line)
+{
+      cover_line_s cur;
+      cur.file_line = file_line;
+      cur.scope = vpip_peek_current_scope();
+      line_table.push_back(cur);
+}
+
+void coverage_toggle(unsigned id, const vvp_vector4_t&old,
+		     const vvp_vector4_t&val, unsigned base)
+{
+      cover_toggle_s&cur = toggle_table[id];
+
+      unsigned wid = val.size();
+      if (base + wid > cur.flags.size())
+	    wid = cur.flags.size() > base? cur.flags.size() - base : 0;
+
+      for (unsigned idx = 0 ;  idx < wid ;  idx += 1) {
+	    unsigned char flag;
+	    vvp_bit4_t from = old.value(base+idx);
+	    vvp_bit4_t to = val.value(idx);
+	    if (from == BIT4_0 && to == BIT4_1)
+		  flag = coverage_db::TOGGLE_RISE;
+	    else if (from == BIT4_1 && to == BIT4_0)
+		  flag = coverage_db::TOGGLE_FALL;
+	    else
+		  continue;
+
+	    unsigned char&flags = cur.flags[base+idx];
+	    if (flags & flag)
+		  continue;
+	    flags |= flag;
+	    cur.missing -= 1;
+      }
+
+	// There is nothing more to learn from this net.
+      if (cur.missing == 0)
+	    cur.fil->set_toggle_id(0);
+}
+
+static void attach_signal(__vpiSignal*sig)
+{
+      if (sig->node == 0)
+	    return;
+
+	// Only the static vector wires and variables are covered.
+      vvp_net_fil_t*fil = sig->node->fil;
+      if (dynamic_cast<vvp_wire_vec4*>(fil) == 0
+	  && dynamic_cast<vvp_wire_vec8*>(fil) == 0)
+	    return;
+
+	// A net can have more than one name (for example through
+	// port collapsing). Cover it under the first one.
+      if (fil->get_toggle_id() != 0 || fil->filter_size() == 0)
+	    return;
+
+      cover_toggle_s cur;
+      cur.fil = fil;
+      cur.name = strdup(vpi_get_str(vpiFullName, sig));
+      cur.flags.resize(fil->filter_size(), 0);
+      cur.missing = 2 * fil->filter_size();
+      fil->set_toggle_id(toggle_table.size());
+      toggle_table.push_back(cur);
+}
+
+static void attach_scope(__vpiScope*scope)
+{
+      for (unsigned idx = 0 ;  idx < scope->intern.size() ;  idx += 1) {
+	    vpiHandle item = scope->intern[idx];
+	    if (__vpiScope*sub = dynamic_cast<__vpiScope*>(item))
+		  attach_scope(sub);
+	    else if (__vpiSignal*sig = dynamic_cast<__vpiSignal*>(item))
+		  attach_signal(sig);
+      }
+}
+
+void coverage_init(void)
+{
+      if (! coverage_flag)
+	    return;
+
+      toggle_table.resize(1);
+      toggle_table[0].fil = 0;
+      toggle_table[0].name = 0;
+      toggle_table[0].missing = 0;
+
+      __vpiHandle**roots;
+      unsigned nroots;
+      vpip_make_root_iterator(roots, nroots);
+      for (unsigned idx = 0 ;  idx < nroots ;  idx += 1) {
+	    if (__vpiScope*scope = dynamic_cast<__vpiScope*>(roots[idx]))
+		  attach_scope(scope);
+      }
+}
+
+void coverage_write(void)
+{
+      if (! coverage_flag)
+	    return;
+
+      coverage_db db;
+      db.add_runs(1);
+
+      for (size_t idx = 0 ;  idx < line_table.size() ;  idx += 1) {
+	    const cover_line_s&cur = line_table[idx];
+	    string scope = cur.scope? vpi_get_str(vpiFullName, cur.scope) : "";
+	    string file = vpi_get_str(vpiFile, cur.file_line);
+	    string desc = vpi_get_str(_vpiDescription, cur.file_line);
+	    db.add_line(scope, file, vpi_get(vpiLineNo, cur.file_line),
+			desc, vpip_file_line_hits(cur.file_line));
+      }
+
+      for (size_t idx = 1 ;  idx < toggle_table.size() ;  idx += 1) {
+	    const cover_toggle_s&cur = toggle_table[idx];
+	    db.add_toggle(cur.name, cur.flags.size(), &cur.flags[0]);
+      }
+
+      db.write(coverage_path);
+}
+
+void coverage_delete(void)
+{
+      for (size_t idx = 1 ;  idx < toggle_table.size() ;  idx += 1)
+	    free(const_cast<char*>(toggle_table[idx].name));
+      toggle_table.clear();
+      line_table.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef IVL_coverage_H
+#define IVL_coverage_H
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+# include  "vpi_user.h"
+# include  <stdint.h>
+
+/*
+ * Coverage collection is enabled by the -coverage[=<path>] extended
+ * argument. Two kinds of coverage are collected:
+ *
+ * Statement coverage counts the times each %file_line instruction is
+ * executed, so it needs a design compiled with iverilog -pfileline=1.
+ * There is a %file_line for each statement, including the statements
+ * of each branch of an if or case, so a branch that is never taken
+ * shows up as statements that were never hit.
+ *
+ * Toggle coverage notes for each bit of each named static vector
+ * net or variable whether it was seen to rise (0 to 1) and to fall
+ * (1 to 0). The signal filters, which already compare the new value
+ * with the old, do the counting. Once all the bits of a net have
+ * toggled both ways the net is detached, so a well exercised design
+ * soon stops paying for it.
+ *
+ * At the end of simulation the coverage is written to <path> (vvp.cov
+ * by default) as a coverage database (see coverage_db.h). The vvp-cov
+ * program merges and reports on these databases.
+ */
+
+extern bool coverage_flag;
+
+extern void coverage_args(int argc, char*argv[]);
+
+  /* Note a %file_line being compiled. This is only called if
+     coverage is enabled. */
+extern void coverage_add_line(vpiHandle file_line);
+
+  /* Attach toggle coverage to the named signals of the compiled
+     design. */
+extern void coverage_init(void);
+extern void coverage_write(void);
+extern void coverage_delete(void);
+
+  /* The %file_line objects keep their own hit counts. */
+extern void vpip_count_file_line(vpiHandle file_line);
+extern uint64_t vpip_file_line_hits(vpiHandle file_line);
+
+#endif /* IVL_coverage_H */
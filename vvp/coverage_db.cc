@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+# include  "config.h"
+# include  "coverage_db.h"
+# include  <climits>
+# include  <cstring>
+# include  <cerrno>
+# include  <algorithm>
+
+using namespace std;
+
+static const char cover_magic[6] = { 'V', 'V', 'P', 'C', 'O', 'V' };
+static const unsigned char cover_version = 1;
+
+bool coverage_db::line_key_s::operator < (const line_key_s&that) const
+{
+      if (int cmp = file.compare(that.file))
+	    return cmp < 0;
+      if (lineno != that.lineno)
+	    return lineno < that.lineno;
+      if (int cmp = scope.compare(that.scope))
+	    return cmp < 0;
+      return desc < that.desc;
+}
+
+coverage_db::coverage_db()
+: runs_(0)
+{
+}
+
+coverage_db::~coverage_db()
+{
+}
+
+void coverage_db::add_line(const string&scope, const string&file,
+			   unsigned lineno, const string&desc, uint64_t hits)
+{
+      line_key_s key;
+      key.scope = scope;
+      key.file = file;
+      key.desc = desc;
+      key.lineno = lineno;
+      lines_[key] += hits;
+}
+
+bool coverage_db::add_toggle(const string&name, unsigned width,
+			     const unsigned char*flags)
+{
+      vector<unsigned char>&cur = toggles_[name];
+      if (cur.empty())
+	    cur.resize(width, 0);
+      else if (cur.size() != width)
+	    return false;
+
+      for (unsigned idx = 0 ;  idx < width ;  idx += 1)
+	    cur[idx] |= flags[idx] & TOGGLE_BOTH;
+
+      return true;
+}
+
+/*
+ * Writing is done by building up the image of the file in a string,
+ * then writing the string out in one go.
+ */
+static void put_number(string&buf, uint64_t val)
+{
+      while (val >= 0x80) {
+	    buf += (char) ((val & 0x7f) | 0x80);
+	    val >>= 7;
+      }
+      buf += (char) val;
+}
+
+namespace {
+      struct string_table_s {
+	    map<string,unsigned> index;
+	    vector<const string*> list;
+
+	    unsigned lookup(const string&str)
+	    {
+		  map<string,unsigned>::iterator cur = index.find(str);
+		  if (cur != index.end())
+			return cur->second;
+		  unsigned idx = list.size();
+		  cur = index.insert(make_pair(str, idx)).first;
+		  list.push_back(&cur->first);
+		  return idx;
+	    }
+      };
+}
+
+bool coverage_db::write(const char*path) const
+{
+      string_table_s strings;
+      string body;
+
+      put_number(body, lines_.size());
+      for (map<line_key_s,uint64_t>::const_iterator cur = lines_.begin()
+		 ; cur != lines_.end() ; ++ cur) {
+	    put_number(body, strings.lookup(cur->first.scope));
+	    put_number(body, strings.lookup(cur->first.file));
+	    put_number(body, strings.lookup(cur->first.desc));
+	    put_number(body, cur->first.lineno);
+	    put_number(body, cur->second);
+      }
+
+      put_number(body, toggles_.size());
+      for (map<string,vector<unsigned char> >::const_iterator cur = toggles_.begin()
+		 ; cur != toggles_.end() ; ++ cur) {
+	    const vector<unsigned char>&flags = cur->second;
+	    put_number(body, strings.lookup(cur->first));
+	    put_number(body, flags.size());
+	    for (size_t idx = 0 ;  idx < flags.size() ;  idx += 4) {
+		  unsigned char byte = 0;
+		  for (size_t bit = 0 ;  bit < 4 && idx+bit < flags.size() ;  bit += 1)
+			byte |= flags[idx+bit] << (2*bit);
+		  body += (char) byte;
+	    }
+      }
+
+      string head (cover_magic, sizeof cover_magic);
+      head += (char) 0;
+      head += (char) cover_version;
+      put_number(head, runs_);
+      put_number(head, strings.list.size());
+      for (size_t idx = 0 ;  idx < strings.list.size() ;  idx += 1) {
+	    const string&str = *strings.list[idx];
+	    put_number(head, str.size());
+	    head += str;
+      }
+
+      FILE*fd = fopen(path, "wb");
+      if (fd == 0) {
+	    fprintf(stderr, "%s: Unable to open coverage database for "
+		    "writing: %s\n", path, strerror(errno));
+	    return false;
+      }
+
+      bool rc = fwrite(head.data(), 1, head.size(), fd) == head.size()
+	    && fwrite(body.data(), 1, body.size(), fd) == body.size();
+      if (fclose(fd) != 0)
+	    rc = false;
+      if (! rc)
+	    fprintf(stderr, "%s: Error writing coverage database.\n", path);
+
+      return rc;
+}
+
+/*
+ * The reader works through the image of the file with a cursor. Any
+ * error (a number that runs off the end, an out of range string
+ * index and so on) sets the error flag, and the caller gives up.
+ */
+namespace {
+      struct reader_s {
+	    const unsigned char*ptr;
+	    const unsigned char*end;
+	    bool error;
+
+	    uint64_t number()
+	    {
+		  uint64_t val = 0;
+		  for (unsigned shift = 0 ;  shift < 64 ;  shift += 7) {
+			if (ptr == end)
+			      break;
+			unsigned char byte = *ptr++;
+			val |= (uint64_t)(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+			      return val;
+		  }
+		  error = true;
+		  return 0;
+	    }
+
+	    const unsigned char* bytes(uint64_t count)
+	    {
+		  if (count > (uint64_t)(end - ptr)) {
+			error = true;
+			ptr = end;
+			return 0;
+		  }
+		  const unsigned char*res = ptr;
+		  ptr += count;
+		  return res;
+	    }
+      };
+}
+
+bool coverage_db::read(const char*path)
+{
+      FILE*fd = fopen(path, "rb");
+      if (fd == 0) {
+	    fprintf(stderr, "%s: Unable to open coverage database: %s\n",
+		    path, strerror(errno));
+	    return false;
+      }
+
+      string image;
+      char buf[4096];
+      size_t count;
+      while ((count = fread(buf, 1, sizeof buf, fd)) > 0)
+	    image.append(buf, count);
+      fclose(fd);
+
+      reader_s in;
+      in.ptr = (const unsigned char*)image.data();
+      in.end = in.ptr + image.size();
+      in.error = false;
+
+      const unsigned char*head = in.bytes(sizeof cover_magic + 2);
+      if (in.error || memcmp(head, cover_magic, sizeof cover_magic) != 0
+	  || head[sizeof cover_magic] != 0) {
+	    fprintf(stderr, "%s: Not a coverage database.\n", path);
+	    return false;
+      }
+      if (head[sizeof cover_magic + 1] != cover_version) {
+	    fprintf(stderr, "%s: Unsupported coverage database version %u.\n",
+		    path, head[sizeof cover_magic + 1]);
+	    return false;
+      }
+
+      unsigned long runs = in.number();
+
+      vector<string> strings;
+      uint64_t nstrings = in.number();
+      for (uint64_t idx = 0 ;  idx < nstrings && !in.error ;  idx += 1) {
+	    uint64_t len = in.number();
+	    const unsigned char*str = in.bytes(len);
+	    if (str) strings.push_back(string((const char*)str, len));
+      }
+
+	// Collect the contents in a separate database, so that a bad
+	// file does not leave a partial merge behind.
+      coverage_db tmp;
+      tmp.runs_ = runs;
+
+      uint64_t nlines = in.number();
+      for (uint64_t idx = 0 ;  idx < nlines && !in.error ;  idx += 1) {
+	    uint64_t scope = in.number();
+	    uint64_t file = in.number();
+	    uint64_t desc = in.number();
+	    uint64_t lineno = in.number();
+	    uint64_t hits = in.number();
+	    if (scope >= strings.size() || file >= strings.size()
+		|| desc >= strings.size() || lineno > UINT_MAX) {
+		  in.error = true;
+		  break;
+	    }
+	    tmp.add_line(strings[scope], strings[file], lineno,
+			 strings[desc], hits);
+      }
+
+      uint64_t nnets = in.number();
+      vector<unsigned char> flags;
+      for (uint64_t idx = 0 ;  idx < nnets && !in.error ;  idx += 1) {
+	    uint64_t name = in.number();
+	    uint64_t width = in.number();
+	      // vvp never writes a net without bits.
+	    if (name >= strings.size() || width == 0 || width > UINT_MAX) {
+		  in.error = true;
+		  break;
+	    }
+	    const unsigned char*packed = in.bytes((width+3) / 4);
+	    if (packed == 0)
+		  break;
+	    flags.resize(width);
+	    for (uint64_t bit = 0 ;  bit < width ;  bit += 1)
+		  flags[bit] = (packed[bit/4] >> (2*(bit%4))) & TOGGLE_BOTH;
+	    if (! tmp.add_toggle(strings[name], width, &flags[0])) {
+		  in.error = true;
+		  break;
+	    }
+      }
+
+      if (in.error || in.ptr != in.end) {
+	    fprintf(stderr, "%s: Coverage database is corrupt.\n", path);
+	    return false;
+      }
+
+	// Now merge it in. Only the toggle widths can disagree.
+      for (map<string,vector<unsigned char> >::const_iterator cur = tmp.toggles_.begin()
+		 ; cur != tmp.toggles_.end() ; ++ cur) {
+	    map<string,vector<unsigned char> >::const_iterator old = toggles_.find(cur->first);
+	    if (old != toggles_.end() && old->second.size() != cur->second.size()) {
+		  fprintf(stderr, "%s: Net %s has width %zu, expected %zu. "
+			  "Is this database from the same design?\n",
+			  path, cur->first.c_str(), cur->second.size(),
+			  old->second.size());
+		  return false;
+	    }
+      }
+
+      runs_ += tmp.runs_;
+      for (map<line_key_s,uint64_t>::const_iterator cur = tmp.lines_.begin()
+		 ; cur != tmp.lines_.end() ; ++ cur)
+	    lines_[cur->first] += cur->second;
+      for (map<string,vector<unsigned char> >::const_iterator cur = tmp.toggles_.begin()
+		 ; cur != tmp.toggles_.end() ; ++ cur) {
+	    add_toggle(cur->first, cur->second.size(), &cur->second[0]);
+      }
+
+      return true;
+}
+
+static double percent(uint64_t part, uint64_t whole)
+{
+      return whole? 100.0 * part / whole : 100.0;
+}
+
+/*
+ * Print a list of bit numbers, most significant first, with runs of
+ * bits written as a range.
+ */
+static void print_bits(FILE*fd, const vector<unsigned char>&flags, unsigned char mask)
+{
+      const char*sep = "";
+      size_t idx = flags.size();
+      while (idx > 0) {
+	    idx -= 1;
+	    if (flags[idx] & mask)
+		  continue;
+	    size_t low = idx;
+	    while (low > 0 && (flags[low-1] & mask) == 0)
+		  low -= 1;
+	    if (low == idx)
+		  fprintf(fd, "%s%zu", sep, idx);
+	    else
+		  fprintf(fd, "%s%zu:%zu", sep, idx, low);
+	    sep = ",";
+	    idx = low;
+      }
+}
+
+void coverage_db::report(FILE*fd, bool list_missing) const
+{
+      uint64_t stmt_hit = 0;
+	// The same source line may be covered by many statements
+	// and instances. A source line is hit if any of them is.
+      map<pair<string,unsigned>,bool> source_lines;
+      size_t source_hit = 0;
+      for (map<line_key_s,uint64_t>::const_iterator cur = lines_.begin()
+		 ; cur != lines_.end() ; ++ cur) {
+	    bool hit = cur->second != 0;
+	    if (hit) stmt_hit += 1;
+	    bool&line = source_lines[make_pair(cur->first.file, cur->first.lineno)];
+	    if (hit && !line) {
+		  line = true;
+		  source_hit += 1;
+	    }
+      }
+
+      uint64_t bits = 0, bits_both = 0;
+      size_t nets_full = 0;
+      for (map<string,vector<unsigned char> >::const_iterator cur = toggles_.begin()
+		 ; cur != toggles_.end() ; ++ cur) {
+	    size_t both = count(cur->second.begin(), cur->second.end(),
+				(unsigned char)TOGGLE_BOTH);
+	    bits += cur->second.size();
+	    bits_both += both;
+	    if (both == cur->second.size())
+		  nets_full += 1;
+      }
+
+      fprintf(fd, "Coverage of %lu run%s:\n", runs_, runs_ == 1? "" : "s");
+      fprintf(fd, "  Statements: %" TIME_FMT_U " of %zu hit (%.1f%%)\n",
+	      stmt_hit, lines_.size(), percent(stmt_hit, lines_.size()));
+      fprintf(fd, "  Lines:      %zu of %zu hit (%.1f%%)\n",
+	      source_hit, source_lines.size(),
+	      percent(source_hit, source_lines.size()));
+      fprintf(fd, "  Toggles:    %" TIME_FMT_U " of %" TIME_FMT_U " bits toggled both ways"
+	      " (%.1f%%), %zu of %zu nets fully toggled\n",
+	      bits_both, bits, percent(bits_both, bits),
+	      nets_full, toggles_.size());
+
+      if (! list_missing)
+	    return;
+
+      if (stmt_hit < lines_.size()) {
+	    fprintf(fd, "Statements not hit:\n");
+	    for (map<line_key_s,uint64_t>::const_iterator cur = lines_.begin()
+		       ; cur != lines_.end() ; ++ cur) {
+		  if (cur->second != 0)
+			continue;
+		  fprintf(fd, "  %s:%u: %s (%s)\n", cur->first.file.c_str(),
+			  cur->first.lineno, cur->first.desc.c_str(),
+			  cur->first.scope.c_str());
+	    }
+      }
+
+      if (nets_full < toggles_.size()) {
+	    fprintf(fd, "Nets not fully toggled:\n");
+	    for (map<string,vector<unsigned char> >::const_iterator cur = toggles_.begin()
+		       ; cur != toggles_.end() ; ++ cur) {
+		  const vector<unsigned char>&flags = cur->second;
+		  bool rise = true, fall = true;
+		  for (size_t idx = 0 ;  idx < flags.size() ;  idx += 1) {
+			if (! (flags[idx] & TOGGLE_RISE)) rise = false;
+			if (! (flags[idx] & TOGGLE_FALL)) fall = false;
+		  }
+		  if (rise && fall)
+			continue;
+
+		  fprintf(fd, "  %s:", cur->first.c_str());
+		  if (! rise) {
+			fprintf(fd, " no 0->1 on [");
+			print_bits(fd, flags, TOGGLE_RISE);
+			fprintf(fd, "]");
+		  }
+		  if (! fall) {
+			fprintf(fd, " no 1->0 on [");
+			print_bits(fd, flags, TOGGLE_FALL);
+			fprintf(fd, "]");
+		  }
+		  fprintf(fd, "\n");
+	    }
+      }
+}
@@ -0,0 +1,103 @@
+#ifndef IVL_coverage_db_H
+#define IVL_coverage_db_H
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  <cstdio>
+# include  <map>
+# include  <string>
+# include  <vector>
+# include  <stdint.h>
+
+/*
+ * A coverage_db holds the coverage collected by one or more
+ * simulation runs. vvp writes one of these at the end of a run with
+ * the -coverage extended argument, and the vvp-cov program merges
+ * them and reports on the result.
+ *
+ * Statement coverage is kept as a hit count for each %file_line in
+ * the design, keyed by the scope of the code, the source file and
+ * line and the description of the statement. Toggle coverage is kept
+ * as a pair of flags for each bit of each net, noting whether the bit
+ * was ever seen to rise (0 to 1) or fall (1 to 0). Merging databases
+ * adds the hit counts and ORs the toggle flags, so merging is
+ * associative and the databases of a regression can be merged in any
+ * order.
+ *
+ * The file is a small binary format. All the numbers are unsigned
+ * LEB128 variable length integers, and the strings are stored once in
+ * a string table and referred to by their index:
+ *
+ *    "VVPCOV" 0 <version>
+ *    <runs>
+ *    <string count> { <length> <bytes> }...
+ *    <line count> { <scope> <file> <description> <lineno> <hits> }...
+ *    <net count> { <name> <width> <flags> }...
+ *
+ * The toggle flags of a net are packed 2 bits per net bit, 4 net bits
+ * per byte, starting with bit 0 of the net in the low bits.
+ */
+class coverage_db {
+
+    public:
+      enum { TOGGLE_RISE = 1, TOGGLE_FALL = 2, TOGGLE_BOTH = 3 };
+
+      coverage_db();
+      ~coverage_db();
+
+	// The number of simulation runs merged into this database.
+      unsigned long runs() const { return runs_; }
+      void add_runs(unsigned long count) { runs_ += count; }
+
+      void add_line(const std::string&scope, const std::string&file,
+		    unsigned lineno, const std::string&desc, uint64_t hits);
+	// The flags are one TOGGLE_* value per bit. Return false if
+	// the net is already present with a different width.
+      bool add_toggle(const std::string&name, unsigned width,
+		      const unsigned char*flags);
+
+	// Read a database file and merge it into this one. Return
+	// false (with a message to stderr) if the file cannot be read.
+      bool read(const char*path);
+      bool write(const char*path) const;
+
+	// Print a summary of the coverage. With list_missing, also
+	// list the statements that were not hit and the nets that did
+	// not toggle fully.
+      void report(FILE*fd, bool list_missing) const;
+
+    private:
+      struct line_key_s {
+	    std::string scope;
+	    std::string file;
+	    std::string desc;
+	    unsigned lineno;
+	    bool operator < (const line_key_s&that) const;
+      };
+
+      unsigned long runs_;
+      std::map<line_key_s,uint64_t> lines_;
+      std::map<std::string,std::vector<unsigned char> > toggles_;
+
+    private: // not implemented
+      coverage_db(const coverage_db&);
+      coverage_db& operator= (const coverage_db&);
+};
+
+#endif /* IVL_coverage_db_H */
@@ -29,7 +29,7 @@
 
 # include <iostream>
 
-void waitable_hooks_s::run_waiting_threads_(vthread_t&threads)
+void waitable_hooks_s::run_waiting_threads_(waiting_threads_s&threads)
 {
 	// Run the non-blocking event controls.
       last = &event_ctls;
@@ -45,11 +45,25 @@ void waitable_hooks_s::run_waiting_threads_(vthread_t&threads)
 	    }
       }
 
-      vthread_t tmp = threads;
-      if (tmp == 0) return;
-      threads = 0;
+      threads.schedule_all();
+}
 
-      vthread_schedule_list(tmp);
+void waiting_threads_s::grow_()
+{
+      size_ = size_? 2*size_ : 4;
+      list_ = (vthread_t*)realloc(list_, size_ * sizeof(vthread_t));
+      assert(list_);
+}
+
+void waiting_threads_s::schedule_all()
+{
+      if (count_ == 0)
+	    return;
+
+	// Scheduling does not run the threads, so none of them can
+	// come back to wait here before the list is emptied.
+      vthread_schedule_list(list_, count_);
+      count_ = 0;
 }
 
 evctl::evctl(unsigned long ecount)
@@ -223,7 +237,7 @@ vvp_fun_edge::~vvp_fun_edge()
 }
 
 bool vvp_fun_edge::recv_vec4_(const vvp_vector4_t&bit,
-                              vvp_bit4_t&old_bit, vthread_t&threads)
+                              vvp_bit4_t&old_bit, waiting_threads_s&threads)
 {
 	/* See what kind of edge this represents. */
       edge_t mask = VVP_EDGE(old_bit, bit.value(0));
@@ -239,7 +253,7 @@ bool vvp_fun_edge::recv_vec4_(const vvp_vector4_t&bit,
 }
 
 vvp_fun_edge_sa::vvp_fun_edge_sa(edge_t e)
-: vvp_fun_edge(e), threads_(0)
+: vvp_fun_edge(e)
 {
 }
 
@@ -247,12 +261,9 @@ vvp_fun_edge_sa::~vvp_fun_edge_sa()
 {
 }
 
-vthread_t vvp_fun_edge_sa::add_waiting_thread(vthread_t thread)
+void vvp_fun_edge_sa::add_waiting_thread(vthread_t thread)
 {
-      vthread_t tmp = threads_;
-      threads_ = thread;
-
-      return tmp;
+      threads_.add(thread);
 }
 
 void vvp_fun_edge_sa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -288,7 +299,7 @@ vvp_fun_edge_aa::~vvp_fun_edge_aa()
 
 void vvp_fun_edge_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new vvp_fun_edge_state_s);
+      vvp_set_context_item(context, context_idx_, vvp_context_new<vvp_fun_edge_state_s>());
       reset_instance(context);
 }
 
@@ -297,7 +308,7 @@ void vvp_fun_edge_aa::reset_instance(vvp_context_t context)
       vvp_fun_edge_state_s*state = static_cast<vvp_fun_edge_state_s*>
             (vvp_get_context_item(context, context_idx_));
 
-      state->threads = 0;
+      state->threads.clear();
       for (unsigned idx = 0 ;  idx < 4 ;  idx += 1)
             state->bits[idx] = bits_[idx];
 }
@@ -307,19 +318,16 @@ void vvp_fun_edge_aa::free_instance(vvp_context_t context)
 {
       vvp_fun_edge_state_s*state = static_cast<vvp_fun_edge_state_s*>
             (vvp_get_context_item(context, context_idx_));
-      delete state;
+      vvp_context_delete(state);
 }
 #endif
 
-vthread_t vvp_fun_edge_aa::add_waiting_thread(vthread_t thread)
+void vvp_fun_edge_aa::add_waiting_thread(vthread_t thread)
 {
       vvp_fun_edge_state_s*state = static_cast<vvp_fun_edge_state_s*>
             (vthread_get_wt_context_item(context_idx_));
 
-      vthread_t tmp = state->threads;
-      state->threads = thread;
-
-      return tmp;
+      state->threads.add(thread);
 }
 
 void vvp_fun_edge_aa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -562,7 +570,6 @@ bool anyedge_string_value::recv_string(const std::string&bit)
 }
 
 vvp_fun_anyedge_sa::vvp_fun_anyedge_sa()
-: threads_(0)
 {
 }
 
@@ -570,12 +577,9 @@ vvp_fun_anyedge_sa::~vvp_fun_anyedge_sa()
 {
 }
 
-vthread_t vvp_fun_anyedge_sa::add_waiting_thread(vthread_t thread)
+void vvp_fun_anyedge_sa::add_waiting_thread(vthread_t thread)
 {
-      vthread_t tmp = threads_;
-      threads_ = thread;
-
-      return tmp;
+      threads_.add(thread);
 }
 
 void vvp_fun_anyedge_sa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -639,7 +643,7 @@ vvp_fun_anyedge_aa::~vvp_fun_anyedge_aa()
 
 void vvp_fun_anyedge_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new vvp_fun_anyedge_state_s);
+      vvp_set_context_item(context, context_idx_, vvp_context_new<vvp_fun_anyedge_state_s>());
       reset_instance(context);
 }
 
@@ -648,7 +652,7 @@ void vvp_fun_anyedge_aa::reset_instance(vvp_context_t context)
       vvp_fun_anyedge_state_s*state = static_cast<vvp_fun_anyedge_state_s*>
             (vvp_get_context_item(context, context_idx_));
 
-      state->threads = 0;
+      state->threads.clear();
       for (unsigned idx = 0 ;  idx < 4 ;  idx += 1) {
 	    if (last_value_[idx])
 	          last_value_[idx]->duplicate(state->last_value_[idx]);
@@ -662,19 +666,16 @@ void vvp_fun_anyedge_aa::free_instance(vvp_context_t context)
 {
       vvp_fun_anyedge_state_s*state = static_cast<vvp_fun_anyedge_state_s*>
             (vvp_get_context_item(context, context_idx_));
-      delete state;
+      vvp_context_delete(state);
 }
 #endif
 
-vthread_t vvp_fun_anyedge_aa::add_waiting_thread(vthread_t thread)
+void vvp_fun_anyedge_aa::add_waiting_thread(vthread_t thread)
 {
       vvp_fun_anyedge_state_s*state = static_cast<vvp_fun_anyedge_state_s*>
             (vthread_get_wt_context_item(context_idx_));
 
-      vthread_t tmp = state->threads;
-      state->threads = thread;
-
-      return tmp;
+      state->threads.add(thread);
 }
 
 void vvp_fun_anyedge_aa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -764,7 +765,6 @@ vvp_fun_event_or::~vvp_fun_event_or()
 }
 
 vvp_fun_event_or_sa::vvp_fun_event_or_sa()
-: threads_(0)
 {
 }
 
@@ -772,12 +772,9 @@ vvp_fun_event_or_sa::~vvp_fun_event_or_sa()
 {
 }
 
-vthread_t vvp_fun_event_or_sa::add_waiting_thread(vthread_t thread)
+void vvp_fun_event_or_sa::add_waiting_thread(vthread_t thread)
 {
-      vthread_t tmp = threads_;
-      threads_ = thread;
-
-      return tmp;
+      threads_.add(thread);
 }
 
 void vvp_fun_event_or_sa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -800,7 +797,7 @@ vvp_fun_event_or_aa::~vvp_fun_event_or_aa()
 
 void vvp_fun_event_or_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new waitable_state_s);
+      vvp_set_context_item(context, context_idx_, vvp_context_new<waitable_state_s>());
 }
 
 void vvp_fun_event_or_aa::reset_instance(vvp_context_t context)
@@ -808,7 +805,7 @@ void vvp_fun_event_or_aa::reset_instance(vvp_context_t context)
       waitable_state_s*state = static_cast<waitable_state_s*>
             (vvp_get_context_item(context, context_idx_));
 
-      state->threads = 0;
+      state->threads.clear();
 }
 
 #ifdef CHECK_WITH_VALGRIND
@@ -816,19 +813,16 @@ void vvp_fun_event_or_aa::free_instance(vvp_context_t context)
 {
       waitable_state_s*state = static_cast<waitable_state_s*>
             (vvp_get_context_item(context, context_idx_));
-      delete state;
+      vvp_context_delete(state);
 }
 #endif
 
-vthread_t vvp_fun_event_or_aa::add_waiting_thread(vthread_t thread)
+void vvp_fun_event_or_aa::add_waiting_thread(vthread_t thread)
 {
       waitable_state_s*state = static_cast<waitable_state_s*>
             (vthread_get_wt_context_item(context_idx_));
 
-      vthread_t tmp = state->threads;
-      state->threads = thread;
-
-      return tmp;
+      state->threads.add(thread);
 }
 
 void vvp_fun_event_or_aa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -860,7 +854,7 @@ vvp_named_event::~vvp_named_event()
 }
 
 vvp_named_event_sa::vvp_named_event_sa(__vpiHandle*h)
-: vvp_named_event(h), threads_(0)
+: vvp_named_event(h)
 {
 }
 
@@ -868,12 +862,9 @@ vvp_named_event_sa::~vvp_named_event_sa()
 {
 }
 
-vthread_t vvp_named_event_sa::add_waiting_thread(vthread_t thread)
+void vvp_named_event_sa::add_waiting_thread(vthread_t thread)
 {
-      vthread_t tmp = threads_;
-      threads_ = thread;
-
-      return tmp;
+      threads_.add(thread);
 }
 
 void vvp_named_event_sa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -900,7 +891,7 @@ vvp_named_event_aa::~vvp_named_event_aa()
 
 void vvp_named_event_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new waitable_state_s);
+      vvp_set_context_item(context, context_idx_, vvp_context_new<waitable_state_s>());
 }
 
 void vvp_named_event_aa::reset_instance(vvp_context_t context)
@@ -908,7 +899,7 @@ void vvp_named_event_aa::reset_instance(vvp_context_t context)
       waitable_state_s*state = static_cast<waitable_state_s*>
             (vvp_get_context_item(context, context_idx_));
 
-      state->threads = 0;
+      state->threads.clear();
 }
 
 #ifdef CHECK_WITH_VALGRIND
@@ -916,19 +907,16 @@ void vvp_named_event_aa::free_instance(vvp_context_t context)
 {
       waitable_state_s*state = static_cast<waitable_state_s*>
             (vvp_get_context_item(context, context_idx_));
-      delete state;
+      vvp_context_delete(state);
 }
 #endif
 
-vthread_t vvp_named_event_aa::add_waiting_thread(vthread_t thread)
+void vvp_named_event_aa::add_waiting_thread(vthread_t thread)
 {
       waitable_state_s*state = static_cast<waitable_state_s*>
             (vthread_get_wt_context_item(context_idx_));
 
-      vthread_t tmp = state->threads;
-      state->threads = thread;
-
-      return tmp;
+      state->threads.add(thread);
 }
 
 void vvp_named_event_aa::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
@@ -23,6 +23,7 @@
 # include  "array.h"
 # include  "vthread.h"
 # include  "config.h"
+# include  <cstdlib>
 
 class evctl {
 
@@ -114,6 +115,43 @@ extern void schedule_evctl(vvp_array_t memory, unsigned index,
  *  Event / edge detection functors
  */
 
+/*
+ * The threads waiting on an event are kept in an array that is kept
+ * from one trigger of the event to the next. A thread that waits on
+ * the same event each time it is triggered (an always @(posedge clk)
+ * for example) only stores itself in the next slot, and the wakeup is
+ * a single pass over the array that schedules all the threads as one
+ * active event.
+ */
+class waiting_threads_s {
+
+    public:
+      waiting_threads_s() : list_(0), count_(0), size_(0) { }
+      ~waiting_threads_s() { free(list_); }
+
+      inline void add(vthread_t thr)
+      {
+	    if (count_ == size_) grow_();
+	    list_[count_++] = thr;
+      }
+
+      void clear() { count_ = 0; }
+
+	// Schedule all the waiting threads and empty the list.
+      void schedule_all();
+
+    private:
+      void grow_();
+
+      vthread_t*list_;
+      unsigned count_;
+      unsigned size_;
+
+    private: // not implemented
+      waiting_threads_s(const waiting_threads_s&);
+      waiting_threads_s& operator= (const waiting_threads_s&);
+};
+
 /*
  * A "waitable" functor is one that the %wait instruction can wait
  * on. This includes the infrastructure needed to hold threads.
@@ -124,13 +162,13 @@ struct waitable_hooks_s {
       waitable_hooks_s() : event_ctls(0) { last = &event_ctls; }
       virtual ~waitable_hooks_s() {}
 
-      virtual vthread_t add_waiting_thread(vthread_t thread) = 0;
+      virtual void add_waiting_thread(vthread_t thread) = 0;
 
       evctl*event_ctls;
       evctl**last;
 
     protected:
-      void run_waiting_threads_(vthread_t&threads);
+      void run_waiting_threads_(waiting_threads_s&threads);
 };
 
 /*
@@ -139,9 +177,7 @@ struct waitable_hooks_s {
  * needed is the list of threads waiting on that instance.
  */
 struct waitable_state_s {
-      waitable_state_s() : threads(0) {}
-
-      vthread_t threads;
+      waiting_threads_s threads;
 };
 
 /*
@@ -158,7 +194,7 @@ class vvp_fun_edge : public vvp_net_fun_t, public waitable_hooks_s {
 
     protected:
       bool recv_vec4_(const vvp_vector4_t&bit,
-                      vvp_bit4_t&old_bit, vthread_t&threads);
+                      vvp_bit4_t&old_bit, waiting_threads_s&threads);
 
       vvp_bit4_t bits_[4];
 
@@ -179,7 +215,7 @@ class vvp_fun_edge_sa : public vvp_fun_edge {
       explicit vvp_fun_edge_sa(edge_t e);
       virtual ~vvp_fun_edge_sa();
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
@@ -188,7 +224,7 @@ class vvp_fun_edge_sa : public vvp_fun_edge {
 			vvp_context_t context);
 
     private:
-      vthread_t threads_;
+      waiting_threads_s threads_;
 };
 
 /*
@@ -206,7 +242,7 @@ class vvp_fun_edge_aa : public vvp_fun_edge, public automatic_hooks_s {
       void free_instance(vvp_context_t context);
 #endif
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
@@ -251,7 +287,7 @@ class vvp_fun_anyedge_sa : public vvp_fun_anyedge {
       explicit vvp_fun_anyedge_sa();
       virtual ~vvp_fun_anyedge_sa();
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
@@ -266,7 +302,7 @@ class vvp_fun_anyedge_sa : public vvp_fun_anyedge {
 		       vvp_context_t context);
 
     private:
-      vthread_t threads_;
+      waiting_threads_s threads_;
 };
 
 /*
@@ -284,7 +320,7 @@ class vvp_fun_anyedge_aa : public vvp_fun_anyedge, public automatic_hooks_s {
       void free_instance(vvp_context_t context);
 #endif
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
@@ -320,13 +356,13 @@ class vvp_fun_event_or_sa : public vvp_fun_event_or {
       explicit vvp_fun_event_or_sa();
       ~vvp_fun_event_or_sa();
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
 
     private:
-      vthread_t threads_;
+      waiting_threads_s threads_;
 };
 
 /*
@@ -344,7 +380,7 @@ class vvp_fun_event_or_aa : public vvp_fun_event_or, public automatic_hooks_s {
       void free_instance(vvp_context_t context);
 #endif
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
@@ -378,13 +414,13 @@ class vvp_named_event_sa : public vvp_named_event {
       explicit vvp_named_event_sa(class __vpiHandle*eh);
       ~vvp_named_event_sa();
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t);
 
     private:
-      vthread_t threads_;
+      waiting_threads_s threads_;
 };
 
 /*
@@ -402,7 +438,7 @@ class vvp_named_event_aa : public vvp_named_event, public automatic_hooks_s {
       void free_instance(vvp_context_t context);
 #endif
 
-      vthread_t add_waiting_thread(vthread_t thread);
+      void add_waiting_thread(vthread_t thread);
 
       void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
                      vvp_context_t context);
@@ -36,7 +36,7 @@ void vvp_fun_extend_signed::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bi
                                       vvp_context_t)
 {
       if (bit.size() >= width_) {
-	    port.ptr()->send_vec4(bit, 0);
+	    send_vec4_cached(port.ptr(), bit);
 	    return;
       }
 
@@ -49,7 +49,7 @@ void vvp_fun_extend_signed::recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bi
       for (unsigned idx = bit.size() ;  idx < res.size() ;  idx += 1)
 	    res.set_bit(idx, pad);
 
-      port.ptr()->send_vec4(res, 0);
+      send_vec4_cached(port.ptr(), res);
 }
 
 void vvp_fun_extend_signed::recv_vec4_pv(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
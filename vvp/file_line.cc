@@ -18,6 +18,7 @@
 
 # include "compile.h"
 # include "vpi_priv.h"
+# include "coverage.h"
 
 struct __vpiFileLine : public __vpiHandle {
       __vpiFileLine();
@@ -28,6 +29,8 @@ struct __vpiFileLine : public __vpiHandle {
       const char *description;
       unsigned file_idx;
       unsigned lineno;
+	// The times this was executed, if coverage is enabled.
+      uint64_t hits;
 };
 
 bool show_file_line = false;
@@ -64,6 +67,7 @@ static char *file_line_get_str(int type, vpiHandle ref)
 }
 
 inline __vpiFileLine::__vpiFileLine()
+: hits(0)
 { }
 
 int __vpiFileLine::get_type_code(void) const
@@ -88,5 +92,20 @@ vpiHandle vpip_build_file_line(char*description, long file_idx, long lineno)
       obj->file_idx = (unsigned) file_idx;
       obj->lineno = (unsigned) lineno;
 
+      if (coverage_flag)
+	    coverage_add_line(obj);
+
       return obj;
 }
+
+void vpip_count_file_line(vpiHandle ref)
+{
+      static_cast<__vpiFileLine*>(ref)->hits += 1;
+}
+
+uint64_t vpip_file_line_hits(vpiHandle ref)
+{
+      struct __vpiFileLine*rfp = dynamic_cast<__vpiFileLine*>(ref);
+      assert(rfp);
+      return rfp->hits;
+}
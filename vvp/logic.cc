@@ -107,7 +107,7 @@ void vvp_fun_and::run_run()
 	    result.set_bit(idx, bitbit);
       }
 
-      ptr->send_vec4(result, 0);
+      send_vec4_cached(ptr, result);
 }
 
 vvp_fun_equiv::vvp_fun_equiv()
@@ -131,7 +131,7 @@ void vvp_fun_equiv::run_run()
       vvp_bit4_t bit = ~(input_[0].value(0) ^ input_[1].value(0));
       vvp_vector4_t result (1, bit);
 
-      ptr->send_vec4(result, 0);
+      send_vec4_cached(ptr, result);
 }
 
 vvp_fun_impl::vvp_fun_impl()
@@ -155,7 +155,7 @@ void vvp_fun_impl::run_run()
       vvp_bit4_t bit = ~input_[0].value(0) | input_[1].value(0);
       vvp_vector4_t result (1, bit);
 
-      ptr->send_vec4(result, 0);
+      send_vec4_cached(ptr, result);
 }
 
 vvp_fun_buf::vvp_fun_buf(unsigned wid)
@@ -543,7 +543,7 @@ void vvp_fun_not::run_run()
       net_ = 0;
 
       vvp_vector4_t result (input_, true /* invert */);
-      ptr->send_vec4(result, 0);
+      send_vec4_cached(ptr, result);
 }
 
 vvp_fun_or::vvp_fun_or(unsigned wid, bool invert)
@@ -579,7 +579,7 @@ void vvp_fun_or::run_run()
 	    result.set_bit(idx, bitbit);
       }
 
-      ptr->send_vec4(result, 0);
+      send_vec4_cached(ptr, result);
 }
 
 vvp_fun_xor::vvp_fun_xor(unsigned wid, bool invert)
@@ -615,7 +615,7 @@ void vvp_fun_xor::run_run()
 	    result.set_bit(idx, bitbit);
       }
 
-      ptr->send_vec4(result, 0);
+      send_vec4_cached(ptr, result);
 }
 
 /*
@@ -26,7 +26,8 @@
 /*
  * vvp_fun_boolean_ is just a common hook for holding operands.
  */
-class vvp_fun_boolean_ : public vvp_net_fun_t, protected vvp_gen_event_s {
+class vvp_fun_boolean_ : public vvp_net_fun_t, protected vvp_gen_event_s,
+                         protected vvp_output_cache4 {
 
     public:
       explicit vvp_fun_boolean_(unsigned wid);
@@ -190,7 +191,8 @@ class vvp_fun_muxr : public vvp_net_fun_t, private vvp_gen_event_s {
       sel_type select_;
 };
 
-class vvp_fun_not: public vvp_net_fun_t, private vvp_gen_event_s {
+class vvp_fun_not: public vvp_net_fun_t, private vvp_gen_event_s,
+                   private vvp_output_cache4 {
 
     public:
       explicit vvp_fun_not(unsigned wid);
@@ -27,6 +27,10 @@
 # include  "statistics.h"
 # include  "vvp_cleanup.h"
 # include  "vvp_object.h"
+# include  "class_type.h"
+# include  "sim_profile.h"
+# include  "net_activity.h"
+# include  "coverage.h"
 # include  <cstdio>
 # include  <cstdlib>
 # include  <cstring>
@@ -258,6 +262,7 @@ int main(int argc, char*argv[])
       struct rusage cycles[3];
       const char *logfile_name = 0x0;
       FILE *logfile = 0x0;
+      bool interactive_flag = false;
       extern void vpi_set_vlog_info(int, char**);
       extern bool stop_is_finish;
       extern int  stop_is_finish_exit_code;
@@ -297,6 +302,7 @@ int main(int argc, char*argv[])
            exit(0);
 	  case 'i':
 	    setvbuf(stdout, 0, _IONBF, 0);
+	    interactive_flag = true;
 	    break;
 	  case 'l':
 	    logfile_name = optarg;
@@ -389,6 +395,13 @@ int main(int argc, char*argv[])
 	    }
       }
 
+	/* Interactive mode keeps stdout unbuffered, so ignore the
+	   output buffering extended arguments. */
+      if (! interactive_flag)
+	    vpip_mcd_buffering(argc-optind, argv+optind);
+      vvp_object::cycle_collector_args(argc-optind, argv+optind);
+      net_activity_args(argc-optind, argv+optind);
+      coverage_args(argc-optind, argv+optind);
       vpip_mcd_init(logfile);
 
       if (verbose_flag) {
@@ -461,6 +474,9 @@ int main(int argc, char*argv[])
 	    vpi_mcd_printf(1, "Running ...\n");
       }
 
+      net_activity_init();
+      coverage_init();
+
 
       schedule_simulate();
 
@@ -475,6 +491,8 @@ int main(int argc, char*argv[])
 		    count_thread_events);
 	    vpi_mcd_printf(1, "    %8lu assign events\n",
 		    count_assign_events);
+	    vpi_mcd_printf(1, "             ...batches of vec4 assigns=%lu\n",
+			   count_assign_batched);
 	    vpi_mcd_printf(1, "             ...assign(vec4) pool=%lu\n",
 			   count_assign4_pool());
 	    vpi_mcd_printf(1, "             ...assign(vec8) pool=%lu\n",
@@ -487,8 +505,29 @@ int main(int argc, char*argv[])
 			   count_assign_arword_pool());
 	    vpi_mcd_printf(1, "    %8lu other events (pool=%lu)\n",
 			   count_gen_events, count_gen_pool());
+	    vpi_mcd_printf(1, "    %8lu threads (pool=%lu)\n",
+			   count_vthreads, count_vthread_pool());
+	    vpi_mcd_printf(1, "             ...leaf function calls=%lu\n",
+			   count_vthread_leaf_calls);
+	    vpi_mcd_printf(1, "    %8lu automatic contexts (reused=%lu, arena=%zu bytes)\n",
+			   count_contexts, count_contexts_reused,
+			   vvp_context_heap_total());
+	    vpi_mcd_printf(1, "    %8lu cached output sends (suppressed=%lu)\n",
+			   count_cached_sends, count_cached_sends_suppressed);
+	    vpi_mcd_printf(1, "    %8lu objects reclaimed from cycles (collections=%lu)\n",
+			   count_cycle_reclaimed, count_cycle_collections);
+	    class_type::report_statistics();
       }
 
+      vpip_profile_report();
+      vpip_profile_delete();
+      sim_profile_report();
+      sim_profile_delete();
+      net_activity_report();
+      net_activity_delete();
+      coverage_write();
+      coverage_delete();
+
       final_cleanup();
 
       return vvp_return_value;
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+# include  "config.h"
+# include  "net_activity.h"
+# include  "vpi_priv.h"
+# include  "vvp_net_sig.h"
+# include  "schedule.h"
+# include  <cstdio>
+# include  <cstdlib>
+# include  <cstring>
+# include  <vector>
+# include  <algorithm>
+
+using namespace std;
+
+bool net_activity_flag = false;
+static unsigned long activity_report_count = 20;
+
+struct net_activity_s {
+      const char*name;
+      uint64_t updates;
+      uint64_t changes;
+};
+
+  // The activity id of a filter is its index in this table. The
+  // first entry is not used so that an id of 0 means not counted.
+static vector<net_activity_s> activity_table;
+
+void net_activity_args(int argc, char*argv[])
+{
+      for (int idx = 0 ;  idx < argc ;  idx += 1) {
+	    const char*arg = argv[idx];
+	    if (strcmp(arg, "-net-activity") == 0) {
+		  net_activity_flag = true;
+
+	    } else if (strncmp(arg, "-net-activity=", 14) == 0) {
+		  char*ep;
+		  unsigned long val = strtoul(arg+14, &ep, 10);
+		  if (*ep)
+			fprintf(stderr, "Warning: Invalid net activity "
+			        "count \"%s\".\n", arg+14);
+		  else
+			activity_report_count = val;
+		  net_activity_flag = true;
+	    }
+      }
+}
+
+void net_activity_count(unsigned id, bool changed)
+{
+      net_activity_s&cur = activity_table[id];
+      cur.updates += 1;
+      if (changed)
+	    cur.changes += 1;
+}
+
+static void attach_signal(__vpiSignal*sig)
+{
+      if (sig->node == 0)
+	    return;
+
+	// Only the static vector wires and variables are counted.
+      vvp_net_fil_t*fil = sig->node->fil;
+      if (dynamic_cast<vvp_wire_vec4*>(fil) == 0
+	  && dynamic_cast<vvp_wire_vec8*>(fil) == 0)
+	    return;
+
+	// A net can have more than one name (for example through
+	// port collapsing). Count it under the first one.
+      if (fil->get_activity_id() != 0)
+	    return;
+
+      net_activity_s cur;
+      cur.name = strdup(vpi_get_str(vpiFullName, sig));
+      cur.updates = 0;
+      cur.changes = 0;
+      fil->set_activity_id(activity_table.size());
+      activity_table.push_back(cur);
+}
+
+static void attach_scope(__vpiScope*scope)
+{
+      for (unsigned idx = 0 ;  idx < scope->intern.size() ;  idx += 1) {
+	    vpiHandle item = scope->intern[idx];
+	    if (__vpiScope*sub = dynamic_cast<__vpiScope*>(item))
+		  attach_scope(sub);
+	    else if (__vpiSignal*sig = dynamic_cast<__vpiSignal*>(item))
+		  attach_signal(sig);
+      }
+}
+
+void net_activity_init(void)
+{
+      if (! net_activity_flag)
+	    return;
+
+      activity_table.resize(1);
+      activity_table[0].name = 0;
+
+      __vpiHandle**roots;
+      unsigned nroots;
+      vpip_make_root_iterator(roots, nroots);
+      for (unsigned idx = 0 ;  idx < nroots ;  idx += 1) {
+	    if (__vpiScope*scope = dynamic_cast<__vpiScope*>(roots[idx]))
+		  attach_scope(scope);
+      }
+}
+
+static bool activity_compare(const net_activity_s*a, const net_activity_s*b)
+{
+      if (a->updates != b->updates)
+	    return a->updates > b->updates;
+      return strcmp(a->name, b->name) < 0;
+}
+
+void net_activity_report(void)
+{
+      if (! net_activity_flag || activity_table.size() < 2)
+	    return;
+
+      vector<net_activity_s*> list;
+      uint64_t updates = 0, changes = 0;
+      unsigned long idle = 0;
+      for (size_t idx = 1 ;  idx < activity_table.size() ;  idx += 1) {
+	    net_activity_s*cur = &activity_table[idx];
+	    updates += cur->updates;
+	    changes += cur->changes;
+	    if (cur->changes == 0)
+		  idle += 1;
+	    if (cur->updates != 0)
+		  list.push_back(cur);
+      }
+      sort(list.begin(), list.end(), activity_compare);
+
+      vpi_mcd_printf(1, "Net activity at time %" TIME_FMT_U ": %" TIME_FMT_U
+		     " updates of %zu nets, %.1f%% without a value change."
+		     " %lu nets never changed.\n",
+		     schedule_simtime(), updates, activity_table.size()-1,
+		     updates? 100.0 * (updates - changes) / updates : 0.0,
+		     idle);
+
+      if (list.size() > activity_report_count)
+	    list.resize(activity_report_count);
+      if (list.empty())
+	    return;
+
+      vpi_mcd_printf(1, "%14s %14s %10s  %s\n",
+		     "updates", "changes", "no-change", "net");
+      for (size_t idx = 0 ;  idx < list.size() ;  idx += 1) {
+	    net_activity_s*cur = list[idx];
+	    vpi_mcd_printf(1, "%14" TIME_FMT_U " %14" TIME_FMT_U " %9.1f%%  %s\n",
+			   cur->updates, cur->changes,
+			   100.0 * (cur->updates - cur->changes) / cur->updates,
+			   cur->name);
+      }
+}
+
+void net_activity_delete(void)
+{
+      for (size_t idx = 1 ;  idx < activity_table.size() ;  idx += 1)
+	    free(const_cast<char*>(activity_table[idx].name));
+      activity_table.clear();
+}
@@ -0,0 +1,42 @@
+#ifndef IVL_net_activity_H
+#define IVL_net_activity_H
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Net activity counting is enabled by the -net-activity[=<count>]
+ * extended argument. Each named signal gets a pair of counters: the
+ * number of values that were written to it, and the number of those
+ * that changed its value. The counting is done by the signal filters
+ * (and, for variables, the variable functor), which already compare
+ * the new value with the old. At the end of simulation the <count>
+ * busiest signals (20 by default) are reported, along with the
+ * fraction of the writes that did not change a value and the number
+ * of signals that never changed at all.
+ */
+
+extern bool net_activity_flag;
+
+extern void net_activity_args(int argc, char*argv[]);
+  /* Attach counters to the named signals of the compiled design. */
+extern void net_activity_init(void);
+extern void net_activity_report(void);
+extern void net_activity_delete(void);
+
+#endif /* IVL_net_activity_H */
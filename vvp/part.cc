@@ -107,7 +107,7 @@ vvp_fun_part_aa::~vvp_fun_part_aa()
 
 void vvp_fun_part_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new vvp_vector4_t);
+      vvp_set_context_item(context, context_idx_, vvp_context_new<vvp_vector4_t>());
 }
 
 void vvp_fun_part_aa::reset_instance(vvp_context_t context)
@@ -123,7 +123,7 @@ void vvp_fun_part_aa::free_instance(vvp_context_t context)
 {
       vvp_vector4_t*val = static_cast<vvp_vector4_t*>
             (vvp_get_context_item(context, context_idx_));
-      delete val;
+      vvp_context_delete(val);
 }
 #endif
 
@@ -340,7 +340,7 @@ vvp_fun_part_var_aa::~vvp_fun_part_var_aa()
 
 void vvp_fun_part_var_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new vvp_fun_part_var_state_s);
+      vvp_set_context_item(context, context_idx_, vvp_context_new<vvp_fun_part_var_state_s>());
 }
 
 void vvp_fun_part_var_aa::reset_instance(vvp_context_t context)
@@ -358,7 +358,7 @@ void vvp_fun_part_var_aa::free_instance(vvp_context_t context)
 {
       vvp_fun_part_var_state_s*state = static_cast<vvp_fun_part_var_state_s*>
             (vvp_get_context_item(context, context_idx_));
-      delete state;
+      vvp_context_delete(state);
 }
 #endif
 
@@ -31,7 +31,7 @@
  * base class. This can be used in both statically and automatically
  * allocated scopes, as bits_ is only used for temporary storage.
  */
-class vvp_reduce_base : public vvp_net_fun_t {
+class vvp_reduce_base : public vvp_net_fun_t, private vvp_output_cache4 {
 
     public:
       vvp_reduce_base();
@@ -47,6 +47,10 @@ class vvp_reduce_base : public vvp_net_fun_t {
 
     protected:
       vvp_vector4_t bits_;
+
+    private:
+      void send_result_(vvp_net_ptr_t prt, vvp_bit4_t res,
+                        vvp_context_t context);
 };
 
 vvp_reduce_base::vvp_reduce_base()
@@ -62,8 +66,7 @@ void vvp_reduce_base::recv_vec4(vvp_net_ptr_t prt, const vvp_vector4_t&bit,
 {
       bits_ = bit;
       vvp_bit4_t res =  calculate_result();
-      vvp_vector4_t rv (1, res);
-      prt.ptr()->send_vec4(rv, context);
+      send_result_(prt, res, context);
 }
 
 void vvp_reduce_base::recv_vec4_pv(vvp_net_ptr_t prt, const vvp_vector4_t&bit,
@@ -78,8 +81,17 @@ void vvp_reduce_base::recv_vec4_pv(vvp_net_ptr_t prt, const vvp_vector4_t&bit,
       assert(bit.size() == wid);
       bits_.set_vec(base, bit);
       vvp_bit4_t res = calculate_result();
+      send_result_(prt, res, context);
+}
+
+void vvp_reduce_base::send_result_(vvp_net_ptr_t prt, vvp_bit4_t res,
+                                   vvp_context_t context)
+{
       vvp_vector4_t rv (1, res);
-      prt.ptr()->send_vec4(rv, context);
+      if (context == 0)
+	    send_vec4_cached(prt.ptr(), rv);
+      else
+	    prt.ptr()->send_vec4(rv, context);
 }
 
 class vvp_reduce_and  : public vvp_reduce_base {
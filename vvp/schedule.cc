@@ -22,6 +22,7 @@
 # include  "vthread.h"
 # include  "vpi_priv.h"
 # include  "vvp_net_sig.h"
+# include  "vvp_object.h"
 # include  "slab.h"
 # include  "compile.h"
 # include  <new>
@@ -30,12 +31,14 @@
 # include  <cstdlib>
 # include  <cassert>
 # include  <iostream>
+# include  <vector>
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 # include  "ivl_alloc.h"
 #endif
 
 unsigned long count_assign_events = 0;
+unsigned long count_assign_batched = 0;
 unsigned long count_gen_events = 0;
 unsigned long count_thread_events = 0;
   // Count the time events (A time cell created)
@@ -219,6 +222,95 @@ void assign_vector4_event_s::operator delete(void*dptr)
 
 unsigned long count_assign4_pool(void) { return assign4_heap.pool; }
 
+/*
+ * The non-blocking vector assignments with no delay are collected in
+ * a batch event instead of an event each. A clocked process does
+ * many of these in a row, and they are then applied in one go when
+ * the batch reaches the front of the nbassign queue. A batch is only
+ * added to while it is the last event of the nbassign queue of the
+ * current time step, so the assignments keep their order relative to
+ * the other non-blocking events.
+ */
+struct assign_vector4_batch_s  : public event_s {
+
+      struct item_s {
+	    vvp_net_ptr_t ptr;
+	    vvp_vector4_t val;
+	    unsigned base;
+	    unsigned vwid;
+      };
+
+      assign_vector4_batch_s();
+      ~assign_vector4_batch_s();
+
+      void add(vvp_net_ptr_t ptr, unsigned base, unsigned vwid,
+	       const vvp_vector4_t&val);
+
+      void run_run(void);
+      void single_step_display(void);
+
+      std::vector<item_s> items;
+
+	// The items array of the last batch, kept for its capacity.
+      static std::vector<item_s> spare_items;
+};
+
+std::vector<assign_vector4_batch_s::item_s> assign_vector4_batch_s::spare_items;
+
+  // The batch that is still open for more assignments, if any.
+static assign_vector4_batch_s*nba_batch = 0;
+
+assign_vector4_batch_s::assign_vector4_batch_s()
+{
+      items.swap(spare_items);
+}
+
+assign_vector4_batch_s::~assign_vector4_batch_s()
+{
+      if (nba_batch == this)
+	    nba_batch = 0;
+      items.clear();
+      if (items.capacity() > spare_items.capacity())
+	    items.swap(spare_items);
+}
+
+inline void assign_vector4_batch_s::add(vvp_net_ptr_t ptr,
+					unsigned base, unsigned vwid,
+					const vvp_vector4_t&val)
+{
+      items.push_back(item_s());
+      item_s&cur = items.back();
+      cur.ptr = ptr;
+      cur.val = val;
+      cur.base = base;
+      cur.vwid = vwid;
+}
+
+void assign_vector4_batch_s::run_run(void)
+{
+	// Sending the values may schedule more assignments, and they
+	// go in a new batch.
+      if (nba_batch == this)
+	    nba_batch = 0;
+
+      count_assign_batched += 1;
+      for (size_t idx = 0 ;  idx < items.size() ;  idx += 1) {
+	    const item_s&cur = items[idx];
+	    count_assign_events += 1;
+	    if (cur.vwid > 0)
+		  vvp_send_vec4_pv(cur.ptr, cur.val, cur.base,
+				   cur.val.size(), cur.vwid, 0);
+	    else
+		  vvp_send_vec4(cur.ptr, cur.val, 0);
+      }
+}
+
+void assign_vector4_batch_s::single_step_display(void)
+{
+      cerr << "assign_vector4_batch: Propagate " << items.size()
+	   << " assignments" << endl;
+}
+
 struct assign_vector8_event_s  : public event_s {
       vvp_net_ptr_t ptr;
       vvp_vector8_t val;
@@ -631,6 +723,10 @@ static void signals_capture(void)
 #endif
       signal(SIGINT,  &signals_handler);
       signal(SIGTERM, &signals_handler);
+#ifdef SIGUSR1
+      if (vpip_profile_flag)
+	    signal(SIGUSR1, &vpip_profile_signal);
+#endif
 }
 
 static void signals_revert(void)
@@ -640,6 +736,10 @@ static void signals_revert(void)
 #endif
       signal(SIGINT,  SIG_DFL);
       signal(SIGTERM, SIG_DFL);
+#ifdef SIGUSR1
+      if (vpip_profile_flag)
+	    signal(SIGUSR1, SIG_DFL);
+#endif
 }
 
 /*
@@ -820,6 +920,14 @@ void schedule_vthread(vthread_t thr, vvp_time64_t delay, bool push_flag)
       }
 }
 
+void schedule_vthread_list(vthread_t thr)
+{
+      struct vthread_event_s*cur = new vthread_event_s;
+
+      cur->thr = thr;
+      schedule_event_(cur, 0, SEQ_ACTIVE);
+}
+
 void schedule_t0_trigger(vvp_net_ptr_t ptr)
 {
       vvp_vector4_t bit (1, BIT4_X);
@@ -862,6 +970,16 @@ void schedule_assign_vector(vvp_net_ptr_t ptr,
 			    const vvp_vector4_t&bit,
 			    vvp_time64_t delay)
 {
+      if (delay == 0) {
+	    if (nba_batch == 0 || sched_list == 0 || sched_list->delay != 0
+		|| sched_list->nbassign != nba_batch) {
+		  nba_batch = new struct assign_vector4_batch_s;
+		  schedule_event_(nba_batch, 0, SEQ_NBASSIGN);
+	    }
+	    nba_batch->add(ptr, base, vwid, bit);
+	    return;
+      }
+
       struct assign_vector4_event_s*cur = new struct assign_vector4_event_s(bit);
       cur->ptr = ptr;
       cur->base = base;
@@ -1151,6 +1269,15 @@ void schedule_simulate(void)
 
       if (schedule_runnable) while (sched_list) {
 
+	    if (vpip_profile_report_flag)
+		  vpip_profile_report();
+
+	      /* Objects are only referenced through vvp_object_t
+		 between events, so this is a safe place to collect
+		 cycles of unreachable objects. */
+	    if (vvp_object::cycle_collect_pending())
+		  vvp_object::collect_cycles();
+
 	    if (schedule_stopped_flag) {
 		  schedule_stopped_flag = false;
 		  stop_handler(0);
@@ -1176,6 +1303,9 @@ void schedule_simulate(void)
 		  }
 		  ctim->delay = 0;
 
+		  if (vpip_mcd_flush_at_time)
+			vpip_mcd_time_flush();
+
 		  vpiNextSimTime();
 		    // Process the cbAtStartOfSimTime callbacks.
 		  while (ctim->start) {
@@ -35,6 +35,12 @@
 extern void schedule_vthread(vthread_t thr, vvp_time64_t delay,
 			     bool push_flag =false);
 
+/*
+ * Schedule a list of threads, linked through their wait_next and
+ * already marked as scheduled, as a single active event with delay 0.
+ */
+extern void schedule_vthread_list(vthread_t thr);
+
 extern void schedule_inactive(vthread_t thr);
 
 extern void schedule_init_vthread(vthread_t thr);
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+/*
+ * This file implements the simulation profiler described in
+ * sim_profile.h. The profiler counts rather than samples. The thread
+ * loop calls sim_profile_switch() each time a thread starts or stops
+ * running and each time it passes a %file_line, so the times charged
+ * are self times, and a function that a thread calls is charged for
+ * its own time.
+ */
+
+# include  "config.h"
+# include  "sim_profile.h"
+# include  "vpi_priv.h"
+# include  "schedule.h"
+# include  <cstdio>
+# include  <cstdlib>
+# include  <cstring>
+# include  <map>
+# include  <string>
+# include  <vector>
+# include  <algorithm>
+
+using namespace std;
+
+bool sim_profile_flag = false;
+
+static FILE*flat_file = 0;
+static FILE*folded_file = 0;
+
+typedef pair<__vpiScope*,vpiHandle> line_key_t;
+static map<__vpiScope*,sim_profile_entry*> scope_table;
+static map<line_key_t,sim_profile_entry*> line_table;
+
+static sim_profile_entry*current_entry = 0;
+static uint64_t switch_time = 0;
+  // Time spent outside of threads, and values delivered to
+  // functors that were not compiled in a scope.
+static uint64_t sched_nsec = 0;
+static uint64_t other_evals = 0;
+
+static FILE* open_profile_file(const char*path)
+{
+      if (strcmp(path, "-") == 0)
+	    return stdout;
+
+      FILE*fd = fopen(path, "w");
+      if (fd == 0) {
+	    perror(path);
+	    exit(1);
+      }
+      return fd;
+}
+
+void sim_profile_init(void)
+{
+      if (const char*path = getenv("VVP_PROFILE")) {
+	    flat_file = open_profile_file(path);
+	    sim_profile_flag = true;
+      }
+      if (const char*path = getenv("VVP_PROFILE_FOLDED")) {
+	    folded_file = open_profile_file(path);
+	    sim_profile_flag = true;
+      }
+}
+
+static sim_profile_entry* new_entry(__vpiScope*scope, const char*file,
+                                    unsigned lineno)
+{
+      sim_profile_entry*entry = new sim_profile_entry;
+      entry->scope = scope;
+      entry->file = file;
+      entry->lineno = lineno;
+      entry->insns = 0;
+      entry->nsec = 0;
+      entry->runs = 0;
+      entry->evals = 0;
+      return entry;
+}
+
+sim_profile_entry* sim_profile_scope(__vpiScope*scope)
+{
+      sim_profile_entry*&entry = scope_table[scope];
+      if (entry == 0)
+	    entry = new_entry(scope, 0, 0);
+      return entry;
+}
+
+sim_profile_entry* sim_profile_line(__vpiScope*scope, vpiHandle file_line)
+{
+      sim_profile_entry*&entry = line_table[line_key_t(scope, file_line)];
+      if (entry == 0)
+	    entry = new_entry(scope, strdup(vpi_get_str(vpiFile, file_line)),
+	                      vpi_get(vpiLineNo, file_line));
+      return entry;
+}
+
+sim_profile_entry* sim_profile_switch(sim_profile_entry*next)
+{
+      uint64_t now = vpip_profile_now();
+      if (switch_time != 0) {
+	    if (current_entry)
+		  current_entry->nsec += now - switch_time;
+	    else
+		  sched_nsec += now - switch_time;
+      }
+      switch_time = now;
+
+      sim_profile_entry*prev = current_entry;
+      current_entry = next;
+      return prev;
+}
+
+sim_profile_entry* sim_profile_net(void)
+{
+      if (__vpiScope*scope = vpip_peek_current_scope())
+	    return sim_profile_scope(scope);
+      return 0;
+}
+
+void sim_profile_functor(vvp_net_t*net)
+{
+      if (net->prof_entry)
+	    net->prof_entry->evals += 1;
+      else
+	    other_evals += 1;
+}
+
+/*
+ * The scope path is written with ';' between the scope names, which
+ * is the frame separator of the collapsed stack format.
+ */
+static void scope_path(string&path, __vpiScope*scope)
+{
+      if (scope->scope) {
+	    scope_path(path, scope->scope);
+	    path += ';';
+      }
+      path += scope->scope_name();
+}
+
+static bool entry_compare(const sim_profile_entry*a, const sim_profile_entry*b)
+{
+      if (a->nsec != b->nsec)
+	    return a->nsec > b->nsec;
+      return a->evals > b->evals;
+}
+
+static void flat_report(void)
+{
+	// Sum the lines of each scope into a total for the scope.
+      map<__vpiScope*,sim_profile_entry> totals;
+      for (map<__vpiScope*,sim_profile_entry*>::iterator cur = scope_table.begin()
+		 ; cur != scope_table.end() ;  ++ cur )
+	    totals[cur->first] = *cur->second;
+
+      vector<sim_profile_entry*> lines;
+      for (map<line_key_t,sim_profile_entry*>::iterator cur = line_table.begin()
+		 ; cur != line_table.end() ;  ++ cur ) {
+	    sim_profile_entry*line = cur->second;
+	    map<__vpiScope*,sim_profile_entry>::iterator tot = totals.find(line->scope);
+	    if (tot == totals.end()) {
+		  totals[line->scope] = *line;
+		  totals[line->scope].file = 0;
+	    } else {
+		  tot->second.insns += line->insns;
+		  tot->second.nsec  += line->nsec;
+		  tot->second.runs  += line->runs;
+	    }
+	    if (line->insns)
+		  lines.push_back(line);
+      }
+
+      vector<sim_profile_entry*> scopes;
+      uint64_t total_nsec = sched_nsec;
+      uint64_t total_insns = 0;
+      uint64_t total_evals = other_evals;
+      for (map<__vpiScope*,sim_profile_entry>::iterator cur = totals.begin()
+		 ; cur != totals.end() ;  ++ cur ) {
+	    scopes.push_back(&cur->second);
+	    total_nsec += cur->second.nsec;
+	    total_insns += cur->second.insns;
+	    total_evals += cur->second.evals;
+      }
+      sort(scopes.begin(), scopes.end(), entry_compare);
+      sort(lines.begin(), lines.end(), entry_compare);
+
+      fprintf(flat_file, "Simulation profile at time %" TIME_FMT_U
+	      ", %.6f seconds, %" TIME_FMT_U " instructions, %" TIME_FMT_U
+	      " functor evaluations:\n",
+	      schedule_simtime(), total_nsec / 1e9, total_insns, total_evals);
+      fprintf(flat_file, "%12.6f %6.2f %14s %10s %14" TIME_FMT_U "  (scheduler and functors)\n",
+	      sched_nsec / 1e9,
+	      total_nsec? 100.0 * sched_nsec / total_nsec : 0.0,
+	      "-", "-", other_evals);
+
+      fprintf(flat_file, "\nBy scope:\n");
+      fprintf(flat_file, "%12s %6s %14s %10s %14s  %s\n",
+	      "seconds", "%", "instructions", "runs", "evaluations", "scope");
+      for (size_t idx = 0 ;  idx < scopes.size() ;  idx += 1) {
+	    sim_profile_entry*cur = scopes[idx];
+	    fprintf(flat_file, "%12.6f %6.2f %14" TIME_FMT_U " %10" TIME_FMT_U
+		    " %14" TIME_FMT_U "  %s\n",
+		    cur->nsec / 1e9,
+		    total_nsec? 100.0 * cur->nsec / total_nsec : 0.0,
+		    cur->insns, cur->runs, cur->evals,
+		    vpi_get_str(vpiFullName, cur->scope));
+      }
+
+      if (lines.empty()) {
+	    fflush(flat_file);
+	    return;
+      }
+
+      fprintf(flat_file, "\nBy source line:\n");
+      fprintf(flat_file, "%12s %6s %14s  %-30s %s\n",
+	      "seconds", "%", "instructions", "file:line", "scope");
+      for (size_t idx = 0 ;  idx < lines.size() ;  idx += 1) {
+	    sim_profile_entry*cur = lines[idx];
+	    char buf[4096];
+	    snprintf(buf, sizeof buf, "%s:%u", cur->file, cur->lineno);
+	    fprintf(flat_file, "%12.6f %6.2f %14" TIME_FMT_U "  %-30s %s\n",
+		    cur->nsec / 1e9,
+		    total_nsec? 100.0 * cur->nsec / total_nsec : 0.0,
+		    cur->insns, buf,
+		    vpi_get_str(vpiFullName, cur->scope));
+      }
+      fflush(flat_file);
+}
+
+/*
+ * Write the times in microseconds in collapsed stack format. The
+ * source line, when there is one, is the leaf frame.
+ */
+static void folded_report(void)
+{
+      if (sched_nsec >= 1000)
+	    fprintf(folded_file, "(scheduler) %" TIME_FMT_U "\n", sched_nsec / 1000);
+
+      for (map<__vpiScope*,sim_profile_entry*>::iterator cur = scope_table.begin()
+		 ; cur != scope_table.end() ;  ++ cur ) {
+	    if (cur->second->nsec < 1000)
+		  continue;
+	    string path;
+	    scope_path(path, cur->first);
+	    fprintf(folded_file, "%s %" TIME_FMT_U "\n", path.c_str(),
+		    cur->second->nsec / 1000);
+      }
+
+      for (map<line_key_t,sim_profile_entry*>::iterator cur = line_table.begin()
+		 ; cur != line_table.end() ;  ++ cur ) {
+	    sim_profile_entry*line = cur->second;
+	    if (line->nsec < 1000)
+		  continue;
+	    string path;
+	    scope_path(path, line->scope);
+	    fprintf(folded_file, "%s;%s:%u %" TIME_FMT_U "\n", path.c_str(),
+		    line->file, line->lineno, line->nsec / 1000);
+      }
+      fflush(folded_file);
+}
+
+void sim_profile_report(void)
+{
+      if (! sim_profile_flag)
+	    return;
+
+	// Charge the time up to now.
+      sim_profile_switch(current_entry);
+
+      if (flat_file)
+	    flat_report();
+      if (folded_file)
+	    folded_report();
+}
+
+void sim_profile_delete(void)
+{
+      for (map<__vpiScope*,sim_profile_entry*>::iterator cur = scope_table.begin()
+		 ; cur != scope_table.end() ;  ++ cur )
+	    delete cur->second;
+      for (map<line_key_t,sim_profile_entry*>::iterator cur = line_table.begin()
+		 ; cur != line_table.end() ;  ++ cur ) {
+	    free(const_cast<char*>(cur->second->file));
+	    delete cur->second;
+      }
+      scope_table.clear();
+      line_table.clear();
+
+      if (flat_file && flat_file != stdout)
+	    fclose(flat_file);
+      if (folded_file && folded_file != stdout)
+	    fclose(folded_file);
+      flat_file = 0;
+      folded_file = 0;
+      sim_profile_flag = false;
+}
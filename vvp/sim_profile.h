@@ -0,0 +1,77 @@
+#ifndef IVL_sim_profile_H
+#define IVL_sim_profile_H
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  "vpi_user.h"
+# include  <stdint.h>
+
+class __vpiScope;
+
+/*
+ * The simulation profiler is enabled by the VVP_PROFILE and/or the
+ * VVP_PROFILE_FOLDED environment variables. It counts the
+ * instructions executed by the threads and the wall time spent
+ * running them, and charges them to the scope of the thread. If the
+ * code has %file_line instructions (compiled with iverilog
+ * -pfileline=1), they are further charged to the source line.
+ * The values delivered to functors are also counted, and charged to
+ * the scope that the functor was compiled in. The time spent outside
+ * of threads is charged to a separate entry for the scheduler.
+ *
+ * At the end of simulation a flat report is written to the VVP_PROFILE
+ * file, and the times are written in collapsed stack format, one line
+ * per scope path, to the VVP_PROFILE_FOLDED file. The latter can be
+ * read by flame graph tools.
+ */
+struct sim_profile_entry {
+      __vpiScope*scope;
+	// The source line, or nil for the scope as a whole.
+      const char*file;
+      unsigned lineno;
+	// The thread instructions and time charged to this entry.
+      uint64_t insns;
+      uint64_t nsec;
+	// The number of times a thread started running here.
+      uint64_t runs;
+	// The values delivered to functors of the scope.
+      uint64_t evals;
+};
+
+extern void sim_profile_init(void);
+
+extern sim_profile_entry* sim_profile_scope(__vpiScope*scope);
+extern sim_profile_entry* sim_profile_line(__vpiScope*scope, vpiHandle file_line);
+
+/*
+ * Charge the time since the last switch to the current entry, and
+ * make the next entry current. This returns the entry that was
+ * current so that it can be restored. A nil entry stands for the
+ * time spent outside of threads.
+ */
+extern sim_profile_entry* sim_profile_switch(sim_profile_entry*next);
+
+  /* Get the entry of the scope that a net is being compiled in, or
+     nil if it is not in a scope. The net keeps it in prof_entry. */
+extern sim_profile_entry* sim_profile_net(void);
+
+extern void sim_profile_report(void);
+extern void sim_profile_delete(void);
+
+#endif /* IVL_sim_profile_H */
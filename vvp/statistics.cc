@@ -35,5 +35,12 @@ unsigned long count_vpi_nets = 0;
 
 unsigned long count_vpi_scopes = 0;
 
+/*
+ * These count the contexts of automatic scopes that were created, and
+ * the number of times a freed context was reused.
+ */
+unsigned long count_contexts = 0;
+unsigned long count_contexts_reused = 0;
+
 size_t size_opcodes = 0;
 
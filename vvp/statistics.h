@@ -49,6 +49,7 @@ extern unsigned long count_time_events;
 extern unsigned long count_time_pool(void);
 
 extern unsigned long count_assign_events;
+extern unsigned long count_assign_batched;
 extern unsigned long count_assign4_pool(void);
 extern unsigned long count_assign8_pool(void);
 extern unsigned long count_assign_real_pool(void);
@@ -58,6 +59,19 @@ extern unsigned long count_assign_arword_pool(void);
 extern unsigned long count_gen_events;
 extern unsigned long count_gen_pool(void);
 
+extern unsigned long count_contexts;
+extern unsigned long count_contexts_reused;
+
+extern unsigned long count_cached_sends;
+extern unsigned long count_cached_sends_suppressed;
+
+extern unsigned long count_cycle_collections;
+extern unsigned long count_cycle_reclaimed;
+
+extern unsigned long count_vthreads;
+extern unsigned long count_vthread_leaf_calls;
+extern unsigned long count_vthread_pool(void);
+
 extern size_t size_opcodes;
 extern size_t size_vvp_nets;
 extern size_t size_vvp_net_funs;
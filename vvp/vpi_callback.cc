@@ -37,6 +37,7 @@
 # include  <cstdio>
 # include  <cassert>
 # include  <cstdlib>
+# include  <vector>
 /*
  * Callback handles are created when the VPI function registers a
  * callback. The handle is stored by the run time, and it triggered
@@ -66,6 +67,7 @@ struct sync_cb  : public vvp_gen_event_s {
 inline __vpiCallback::__vpiCallback()
 {
       next = 0;
+      prof = 0;
 }
 
 __vpiCallback::~__vpiCallback()
@@ -321,7 +323,10 @@ void sync_cb::run_run()
 	    assert(vpi_mode_flag == VPI_MODE_NONE);
 	    vpi_mode_flag = sync_flag? VPI_MODE_ROSYNC : VPI_MODE_RWSYNC;
 	    vpip_cur_task = dynamic_cast<__vpiSysTaskCall*>(cur->cb_data.obj);
-	    (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    {
+		  vpip_profile_timer timer (cur->prof);
+		  (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    }
 	    vpip_cur_task = 0;
 	    vpi_mode_flag = VPI_MODE_NONE;
       }
@@ -514,7 +519,10 @@ void vpiEndOfCompile(void) {
       while (EndOfCompile) {
 	    cur = EndOfCompile;
 	    EndOfCompile = dynamic_cast<simulator_callback*>(cur->next);
-	    (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    {
+		  vpip_profile_timer timer (cur->prof);
+		  (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    }
 	    delete cur;
       }
 
@@ -534,7 +542,10 @@ void vpiStartOfSim(void) {
       while (StartOfSimulation) {
 	    cur = StartOfSimulation;
 	    StartOfSimulation = dynamic_cast<simulator_callback*>(cur->next);
-	    (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    {
+		  vpip_profile_timer timer (cur->prof);
+		  (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    }
 	    delete cur;
       }
 
@@ -556,7 +567,10 @@ void vpiPostsim(void) {
 	      /* Only set the time if it is not NULL. */
 	    if (cur->cb_data.time)
 	          vpip_time_to_timestruct(cur->cb_data.time, schedule_simtime());
-	    (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    {
+		  vpip_profile_timer timer (cur->prof);
+		  (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    }
 	    delete cur;
       }
 
@@ -577,7 +591,10 @@ void vpiNextSimTime(void)
       while (NextSimTime) {
 	    cur = NextSimTime;
 	    NextSimTime = dynamic_cast<simulator_callback*>(cur->next);
-	    (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    {
+		  vpip_profile_timer timer (cur->prof);
+		  (cur->cb_data.cb_rtn)(&cur->cb_data);
+	    }
 	    delete cur;
       }
 
@@ -655,6 +672,9 @@ vpiHandle vpi_register_cb(p_cb_data data)
 	    break;
       }
 
+      if (obj && vpip_profile_flag)
+	    obj->prof = vpip_profile_callback(data->reason);
+
       return obj;
 }
 
@@ -696,7 +716,10 @@ void callback_execute(struct __vpiCallback*cur)
 	    assert(0);
 	    break;
       }
-      (cur->cb_data.cb_rtn)(&cur->cb_data);
+      {
+	    vpip_profile_timer timer (cur->prof);
+	    (cur->cb_data.cb_rtn)(&cur->cb_data);
+      }
 
       vpi_mode_flag = save_mode;
 }
@@ -717,6 +740,7 @@ vvp_vpi_callback::vvp_vpi_callback()
 {
       vpi_callbacks_ = 0;
       array_words_ = 0;
+      trace_id_ = 0;
 }
 
 vvp_vpi_callback::~vvp_vpi_callback()
@@ -765,6 +789,9 @@ void vvp_vpi_callback::clear_all_callbacks()
  */
 void vvp_vpi_callback::run_vpi_callbacks()
 {
+      if (trace_id_)
+	    vpip_trace_mark(trace_id_);
+
       struct __vpi_array_word*array_word = array_words_;
       while (array_word) {
 	    array_word->array->word_change(array_word->word);
@@ -802,6 +829,220 @@ void vvp_vpi_callback::run_vpi_callbacks()
       }
 }
 
+/*
+ * Native value change tracing. Each dumper or other client registers
+ * a tracer with its own handler. Each signal added to a tracer gets an
+ * entry in the trace_table, and the filter of the signal carries the id
+ * of the first entry, with any more entries for the same signal (from
+ * other tracers) chained through the next member. When the filter
+ * propagates a value, run_vpi_callbacks() calls vpip_trace_mark(),
+ * which simply notes each entry in the pending list of its tracer
+ * (once per time step). In the read-only synch region the pending
+ * signals of each tracer are read directly as raw vecval words into a
+ * reusable buffer and handed to the handler of that tracer in one
+ * batch. This skips the value_callback list, the t_vpi_value
+ * formatting and the per-signal callback that the dumpers would
+ * otherwise use. The vvp run time is single threaded, so a single
+ * buffer is all that is needed.
+ */
+struct trace_entry_s {
+      vvp_signal_value*sig;
+      void*user_data;
+      unsigned tracer;
+      unsigned next;
+      bool real_flag;
+      bool pending;
+};
+
+struct tracer_s {
+      vpip_trace_handler_t func;
+      void*data;
+      std::vector<unsigned> pending;
+};
+
+struct trace_flush_s : public vvp_gen_event_s {
+      trace_flush_s() : scheduled(false) { }
+      void run_run();
+      bool scheduled;
+};
+
+  // Id 0 is not used in either table, so that 0 can mean none.
+static std::vector<trace_entry_s> trace_table (1);
+static std::vector<tracer_s> tracer_table (1);
+static std::vector<s_vpi_vecval> trace_words;
+static std::vector<s_vpip_trace_rec> trace_recs;
+static trace_flush_s trace_flush;
+
+void vpip_trace_mark(unsigned id)
+{
+      while (id != 0) {
+	    trace_entry_s&ent = trace_table[id];
+	    if (! ent.pending) {
+		  ent.pending = true;
+		  tracer_table[ent.tracer].pending.push_back(id);
+	    }
+	    id = ent.next;
+      }
+
+      if (! trace_flush.scheduled) {
+	    trace_flush.scheduled = true;
+	    schedule_generic(&trace_flush, 0, true, true);
+      }
+}
+
+/*
+ * Read the values of the pending entries of a tracer into the
+ * trace_recs and trace_words buffers, and clear the pending list.
+ */
+static void trace_collect(tracer_s&tracer)
+{
+      static vvp_vector4_t tmp;
+
+	// Size the word buffer first, so that the vector pointers in
+	// the records remain valid while the words are filled in.
+      size_t nwords = 0;
+      for (unsigned idx = 0 ; idx < tracer.pending.size() ; idx += 1) {
+	    const trace_entry_s&ent = trace_table[tracer.pending[idx]];
+	    if (! ent.real_flag)
+		  nwords += (ent.sig->value_size() + 31) / 32;
+      }
+      trace_words.resize(nwords);
+      trace_recs.resize(tracer.pending.size());
+
+      size_t base = 0;
+      for (unsigned idx = 0 ; idx < tracer.pending.size() ; idx += 1) {
+	    trace_entry_s&ent = trace_table[tracer.pending[idx]];
+	    s_vpip_trace_rec&rec = trace_recs[idx];
+	    ent.pending = false;
+	    rec.user_data = ent.user_data;
+	    if (ent.real_flag) {
+		  rec.size = 0;
+		  rec.vector = 0;
+		  rec.real = ent.sig->real_value();
+		  continue;
+	    }
+
+	    ent.sig->vec4_value(tmp);
+	    rec.size = tmp.size();
+	    rec.vector = &trace_words[base];
+	    rec.real = 0.0;
+	    tmp.get_vecval(rec.vector);
+	    base += (rec.size + 31) / 32;
+      }
+
+      tracer.pending.clear();
+}
+
+void trace_flush_s::run_run()
+{
+      scheduled = false;
+
+      for (unsigned id = 1 ; id < tracer_table.size() ; id += 1) {
+	    tracer_s&tracer = tracer_table[id];
+	    if (tracer.pending.empty())
+		  continue;
+
+	    if (tracer.func == 0) {
+		  for (unsigned idx = 0 ; idx < tracer.pending.size() ; idx += 1)
+			trace_table[tracer.pending[idx]].pending = false;
+		  tracer.pending.clear();
+		  continue;
+	    }
+
+	    trace_collect(tracer);
+
+	    assert(vpi_mode_flag == VPI_MODE_NONE);
+	    vpi_mode_flag = VPI_MODE_ROSYNC;
+	    (tracer.func)(schedule_simtime(), &trace_recs[0],
+	                  trace_recs.size(), tracer.data);
+	    vpi_mode_flag = VPI_MODE_NONE;
+      }
+}
+
+extern "C" PLI_INT32 vpip_trace_register(vpip_trace_handler_t func, void*data)
+{
+      if (func == 0)
+	    return 0;
+
+      tracer_s tracer;
+      tracer.func = func;
+      tracer.data = data;
+      tracer_table.push_back(tracer);
+
+      return tracer_table.size() - 1;
+}
+
+extern "C" void vpip_trace_unregister(PLI_INT32 id)
+{
+      if (id <= 0 || (size_t)id >= tracer_table.size())
+	    return;
+
+      tracer_table[id].func = 0;
+      tracer_table[id].data = 0;
+}
+
+extern "C" PLI_INT32 vpip_trace_add(PLI_INT32 tracer, vpiHandle ref,
+                                    void*user_data)
+{
+      vvp_net_t*net = 0;
+      bool real_flag = false;
+
+      if (tracer <= 0 || (size_t)tracer >= tracer_table.size())
+	    return 0;
+      if (tracer_table[tracer].func == 0)
+	    return 0;
+
+      if (ref->vpi_get(vpiAutomatic))
+	    return 0;
+
+      switch (ref->get_type_code()) {
+	  case vpiReg:
+	  case vpiNet:
+	  case vpiIntegerVar:
+	  case vpiBitVar:
+	  case vpiByteVar:
+	  case vpiShortIntVar:
+	  case vpiIntVar:
+	  case vpiLongIntVar:
+	  case vpiTimeVar: {
+		__vpiSignal*sig = dynamic_cast<__vpiSignal*>(ref);
+		if (sig == 0)
+		      return 0;
+		net = sig->node;
+		break;
+	  }
+	  case vpiRealVar: {
+		__vpiRealVar*rsig = dynamic_cast<__vpiRealVar*>(ref);
+		if (rsig == 0)
+		      return 0;
+		net = rsig->net;
+		real_flag = true;
+		break;
+	  }
+	  default:
+	    return 0;
+      }
+
+      if (net == 0 || net->fil == 0)
+	    return 0;
+
+      vvp_signal_value*sig = dynamic_cast<vvp_signal_value*>(net->fil);
+      if (sig == 0)
+	    return 0;
+
+      trace_entry_s ent;
+      ent.sig = sig;
+      ent.user_data = user_data;
+      ent.tracer = tracer;
+      ent.next = net->fil->get_trace_id();
+      ent.real_flag = real_flag;
+      ent.pending = false;
+      net->fil->set_trace_id(trace_table.size());
+      trace_table.push_back(ent);
+
+      return 1;
+}
+
 void vvp_signal_value::get_signal_value(struct t_vpi_value*vp)
 {
       switch (vp->format) {
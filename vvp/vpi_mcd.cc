@@ -55,6 +55,111 @@ static unsigned fd_table_len = 0;
 
 static FILE* logfile;
 
+/*
+ * Output buffering. Normally the MCD files use the stdio defaults,
+ * and the log file is line buffered. The -output-flush=<policy>
+ * extended argument selects how the MCD files, the log file and the files opened with
+ * $fopen for writing are buffered instead:
+ *
+ *    line  - flush at the end of each line
+ *    time  - flush when simulation time advances
+ *    size  - flush only when the buffer is full
+ *
+ * The output is also flushed by $fflush and at the end of the
+ * simulation. The -output-buffer=<bytes> extended argument sets the
+ * buffer size.
+ */
+enum mcd_flush_policy_t {
+      MCD_FLUSH_DEFAULT,
+      MCD_FLUSH_LINE,
+      MCD_FLUSH_TIME,
+      MCD_FLUSH_SIZE
+};
+static mcd_flush_policy_t mcd_flush_policy = MCD_FLUSH_DEFAULT;
+static size_t mcd_buffer_size = 64*1024;
+
+bool vpip_mcd_flush_at_time = false;
+  /* Set when there may be unflushed output for a time step flush. */
+static bool mcd_output_pending = false;
+
+static void mcd_set_buffering(FILE*fp)
+{
+      if (fp == 0 || fp == stderr)
+	    return;
+
+      switch (mcd_flush_policy) {
+	  case MCD_FLUSH_DEFAULT:
+	    break;
+	  case MCD_FLUSH_LINE:
+	    setvbuf(fp, 0, _IOLBF, mcd_buffer_size);
+	    break;
+	  case MCD_FLUSH_TIME:
+	  case MCD_FLUSH_SIZE:
+	    setvbuf(fp, 0, _IOFBF, mcd_buffer_size);
+	    break;
+      }
+}
+
+/*
+ * Look for the buffering extended arguments. This must be called before
+ * vpip_mcd_init() and before anything is written to stdout.
+ */
+void vpip_mcd_buffering(int argc, char*argv[])
+{
+      for (int idx = 0 ;  idx < argc ;  idx += 1) {
+	    const char*arg = argv[idx];
+	    if (strncmp(arg, "-output-flush=", 14) == 0) {
+		  arg += 14;
+		  if (strcmp(arg, "line") == 0)
+			mcd_flush_policy = MCD_FLUSH_LINE;
+		  else if (strcmp(arg, "time") == 0)
+			mcd_flush_policy = MCD_FLUSH_TIME;
+		  else if (strcmp(arg, "size") == 0)
+			mcd_flush_policy = MCD_FLUSH_SIZE;
+		  else
+			fprintf(stderr, "Warning: Unknown output flush policy "
+			        "\"%s\", expected line, time or size.\n", arg);
+
+	    } else if (strncmp(arg, "-output-buffer=", 15) == 0) {
+		  char*ep;
+		  unsigned long size = strtoul(arg+15, &ep, 10);
+		  if (*ep == 'k' || *ep == 'K') {
+			size *= 1024;
+			ep += 1;
+		  } else if (*ep == 'm' || *ep == 'M') {
+			size *= 1024*1024;
+			ep += 1;
+		  }
+		  if (*ep || size == 0)
+			fprintf(stderr, "Warning: Invalid output buffer size "
+			        "\"%s\".\n", arg+15);
+		  else
+			mcd_buffer_size = size;
+	    }
+      }
+
+      vpip_mcd_flush_at_time = mcd_flush_policy == MCD_FLUSH_TIME;
+}
+
+/*
+ * Called by the scheduler when time advances, if the policy is to
+ * flush then.
+ */
+void vpip_mcd_time_flush(void)
+{
+      if (! mcd_output_pending)
+	    return;
+
+      mcd_output_pending = false;
+      for (unsigned idx = 0 ;  idx < 31 ;  idx += 1) {
+	    if (mcd_table[idx].fp) fflush(mcd_table[idx].fp);
+      }
+      if (logfile) fflush(logfile);
+      for (unsigned idx = 1 ;  idx < fd_table_len ;  idx += 1) {
+	    if (fd_table[idx].fp) fflush(fd_table[idx].fp);
+      }
+}
+
 /* Initialize mcd portion of vpi.  Must be called before
  * any vpi_mcd routines can be used.
  */
@@ -78,6 +183,9 @@ void vpip_mcd_init(FILE *log)
       fd_table[2].filename = strdup("stderr");
 
       logfile = log;
+
+      mcd_set_buffering(stdout);
+      mcd_set_buffering(logfile);
 }
 
 #ifdef CHECK_WITH_VALGRIND
@@ -174,6 +282,7 @@ got_entry:
 #endif
 	if(mcd_table[i].fp == NULL)
 		return 0;
+	mcd_set_buffering(mcd_table[i].fp);
 	mcd_table[i].filename = strdup(name);
 
 	if (vpi_trace) {
@@ -214,6 +323,7 @@ vpi_mcd_vprintf(PLI_UINT32 mcd, const char*fmt, va_list ap)
       }
       va_end(saved_ap);
 
+      mcd_output_pending = true;
       for(int i = 0; i < 31; i++) {
 	    if((mcd>>i) & 1) {
 		  if(mcd_table[i].fp) {
@@ -244,8 +354,10 @@ extern "C" void vpip_mcd_rawwrite(PLI_UINT32 mcd, const char*buf, size_t cnt)
 {
       if (!IS_MCD(mcd)) return;
 
-      for(int idx = 0; idx < 31; idx += 1) {
-	    if (((mcd>>idx) & 1) == 0)
+      mcd_output_pending = true;
+	/* Only visit the channels that are selected. */
+      for(int idx = 0; mcd != 0; idx += 1, mcd >>= 1) {
+	    if ((mcd & 1) == 0)
 		  continue;
 
 	    if (mcd_table[idx].fp == 0)
@@ -317,6 +429,8 @@ got_entry:
 		fd_table[i].fp = fopen("nul", mode);
 #endif
       if (fd_table[i].fp == NULL) return 0;
+      if (mode[0] != 'r' || strchr(mode, '+'))
+	    mcd_set_buffering(fd_table[i].fp);
       fd_table[i].filename = strdup(name);
       return ((1U<<31)|i);
 }
@@ -329,5 +443,15 @@ extern "C" FILE *vpi_get_file(PLI_INT32 fd)
 	// Only know about fd_table_len indices
       if (FD_IDX(fd) >= fd_table_len) return NULL;
 
+	// The caller may write to the file. Output to stderr is not
+	// buffered, so keep it in order with the buffered stdout.
+      if (mcd_flush_policy != MCD_FLUSH_DEFAULT) {
+	    mcd_output_pending = true;
+	    if (FD_IDX(fd) == 2) {
+		  fflush(stdout);
+		  if (logfile) fflush(logfile);
+	    }
+      }
+
       return fd_table[FD_IDX(fd)].fp;
 }
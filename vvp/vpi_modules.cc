@@ -28,8 +28,11 @@
 # include  "ivl_alloc.h"
 
 static ivl_dll_t*dll_list = 0;
+static char**dll_name_list = 0;
 static unsigned dll_list_cnt = 0;
 
+const char*vpip_current_module = 0;
+
 #if defined(__MINGW32__) || defined (__CYGWIN__)
 typedef PLI_UINT32 (*vpip_set_callback_t)(vpip_routines_s*, PLI_UINT32);
 #endif
@@ -130,9 +133,12 @@ void load_module_delete(void)
 {
       for (unsigned idx = 0; idx < dll_list_cnt; idx += 1) {
 	    ivl_dlclose(dll_list[idx]);
+	    free(dll_name_list[idx]);
       }
       free(dll_list);
+      free(dll_name_list);
       dll_list = 0;
+      dll_name_list = 0;
       dll_list_cnt = 0;
 }
 
@@ -245,10 +251,17 @@ void vpip_load_module(const char*name)
       dll_list_cnt += 1;
       dll_list = (ivl_dll_t*)realloc(dll_list, dll_list_cnt*sizeof(ivl_dll_t));
       dll_list[dll_list_cnt-1] = dll;
+      dll_name_list = (char**)realloc(dll_name_list, dll_list_cnt*sizeof(char*));
+      dll_name_list[dll_list_cnt-1] = strdup(name);
+
+	/* Remember which module is registering things. */
+      vpip_current_module = dll_name_list[dll_list_cnt-1];
 
       vpi_mode_flag = VPI_MODE_REGISTER;
       vlog_startup_routines_t*routines = (vlog_startup_routines_t*)table;
       for (unsigned tmp = 0 ;  routines[tmp] ;  tmp += 1)
 	    (routines[tmp])();
       vpi_mode_flag = VPI_MODE_NONE;
+
+      vpip_current_module = 0;
 }
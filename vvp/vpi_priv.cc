@@ -20,6 +20,7 @@
 # include  "version_base.h"
 # include  "vpi_priv.h"
 # include  "schedule.h"
+# include  "sim_profile.h"
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 #endif
@@ -594,6 +595,11 @@ void vpi_set_vlog_info(int argc, char** argv)
 		setvbuf(vpi_trace, trace_buf, _IOLBF, sizeof(trace_buf));
 	  }
     }
+
+    if (const char*path = getenv("VPI_PROFILE"))
+	  vpip_profile_init(path);
+
+    sim_profile_init();
 }
 
 static void vec4_get_value_string(const vvp_vector4_t&word_val, unsigned width,
@@ -1168,6 +1174,163 @@ vpiHandle vpi_put_value(vpiHandle obj, s_vpi_value*vp,
       return 0;
 }
 
+/*
+ * The batched value routines move the values of many objects between
+ * the simulation and a caller supplied buffer. Signals are read and
+ * written directly as vectors, which avoids formatting each value into
+ * the shared result buffer; anything else is passed to the normal
+ * vpi_get_value/vpi_put_value methods of the object.
+ */
+static unsigned batch_words(vpiHandle obj)
+{
+      if (__vpiSignal*sig = dynamic_cast<__vpiSignal*>(obj))
+	    return (sig->width() + 31) / 32;
+
+      return (vpi_get(vpiSize, obj) + 31) / 32;
+}
+
+extern "C" PLI_INT32 vpip_get_values(const vpiHandle*refs, PLI_UINT32 count,
+                                     PLI_INT32 format, void*buf)
+{
+      static vvp_vector4_t tmp;
+      char*cp = static_cast<char*>(buf);
+
+      for (PLI_UINT32 idx = 0 ;  idx < count ;  idx += 1) {
+	    vpiHandle obj = refs[idx];
+	    __vpiSignal*sig = dynamic_cast<__vpiSignal*>(obj);
+	    s_vpi_value val;
+
+	    switch (format) {
+
+		case vpiVectorVal: {
+		      s_vpi_vecval*vec = reinterpret_cast<s_vpi_vecval*>(cp);
+		      unsigned words = batch_words(obj);
+		      if (sig) {
+			    sig->get_vec4(tmp);
+			    tmp.get_vecval(vec);
+		      } else {
+			    val.format = vpiVectorVal;
+			    obj->vpi_get_value(&val);
+			    if (val.format != vpiVectorVal)
+				  return idx;
+			    memcpy(vec, val.value.vector,
+			           words * sizeof(s_vpi_vecval));
+		      }
+		      cp += words * sizeof(s_vpi_vecval);
+		      break;
+		}
+
+		case vpiIntVal: {
+		      PLI_INT32*dst = reinterpret_cast<PLI_INT32*>(cp);
+		      if (sig) {
+			    int32_t ival = 0;
+			    sig->get_vec4(tmp);
+			    vector4_to_value(tmp, ival, sig->signed_flag, false);
+			    *dst = ival;
+		      } else {
+			    val.format = vpiIntVal;
+			    obj->vpi_get_value(&val);
+			    if (val.format != vpiIntVal)
+				  return idx;
+			    *dst = val.value.integer;
+		      }
+		      cp += sizeof(PLI_INT32);
+		      break;
+		}
+
+		case vpiRealVal: {
+		      double*dst = reinterpret_cast<double*>(cp);
+		      if (sig) {
+			    sig->get_vec4(tmp);
+			    *dst = 0.0;
+			    vector4_to_value(tmp, *dst, sig->signed_flag);
+		      } else {
+			    val.format = vpiRealVal;
+			    obj->vpi_get_value(&val);
+			    if (val.format != vpiRealVal)
+				  return idx;
+			    *dst = val.value.real;
+		      }
+		      cp += sizeof(double);
+		      break;
+		}
+
+		default:
+		  fprintf(stderr, "VPI error: vpip_get_values does not "
+		                  "support value format %d.\n", (int)format);
+		  return 0;
+	    }
+      }
+
+      return count;
+}
+
+extern "C" PLI_INT32 vpip_put_values(const vpiHandle*refs, PLI_UINT32 count,
+                                     PLI_INT32 format, const void*buf)
+{
+      if (schedule_at_rosync()) {
+	    fprintf(stderr, "VPI error: attempted to put values "
+	                    "during a read-only synch callback.\n");
+	    return 0;
+      }
+
+      const char*cp = static_cast<const char*>(buf);
+
+      for (PLI_UINT32 idx = 0 ;  idx < count ;  idx += 1) {
+	    vpiHandle obj = refs[idx];
+	    __vpiSignal*sig = dynamic_cast<__vpiSignal*>(obj);
+	    s_vpi_value val;
+	    val.format = format;
+
+	    switch (format) {
+
+		case vpiVectorVal: {
+		      const s_vpi_vecval*vec =
+			    reinterpret_cast<const s_vpi_vecval*>(cp);
+		      unsigned words = batch_words(obj);
+		      if (sig) {
+			    vvp_vector4_t tmp (sig->width());
+			    tmp.set_vecval(vec);
+			    sig->put_vec4(tmp);
+		      } else {
+			    val.value.vector = const_cast<s_vpi_vecval*>(vec);
+			    obj->vpi_put_value(&val, vpiNoDelay);
+		      }
+		      cp += words * sizeof(s_vpi_vecval);
+		      break;
+		}
+
+		case vpiIntVal:
+		  val.value.integer = *reinterpret_cast<const PLI_INT32*>(cp);
+		  if (sig) {
+			vvp_vector4_t tmp = vec4_from_vpi_value(&val, sig->width());
+			sig->put_vec4(tmp);
+		  } else {
+			obj->vpi_put_value(&val, vpiNoDelay);
+		  }
+		  cp += sizeof(PLI_INT32);
+		  break;
+
+		case vpiRealVal:
+		  val.value.real = *reinterpret_cast<const double*>(cp);
+		  if (sig) {
+			sig->put_vec4(vvp_vector4_t(sig->width(), val.value.real));
+		  } else {
+			obj->vpi_put_value(&val, vpiNoDelay);
+		  }
+		  cp += sizeof(double);
+		  break;
+
+		default:
+		  fprintf(stderr, "VPI error: vpip_put_values does not "
+		                  "support value format %d.\n", (int)format);
+		  return 0;
+	    }
+      }
+
+      return count;
+}
+
 vpiHandle vpi_handle(PLI_INT32 type, vpiHandle ref)
 {
       vpiHandle res = 0;
@@ -1283,41 +1446,16 @@ vpiHandle vpi_handle_by_index(vpiHandle ref, PLI_INT32 idx)
 
 static vpiHandle find_name(const char *name, vpiHandle handle)
 {
-      vpiHandle rtn = 0;
       __vpiScope*ref = dynamic_cast<__vpiScope*>(handle);
 
+      /* Look the name up in the scope name index. */
+      vpiHandle rtn = ref->find_item(name);
+      if (rtn) return rtn;
+
       /* check module names */
       if (!strcmp(name, vpi_get_str(vpiName, handle)))
 	    rtn = handle;
 
-      /* brute force search for the name in all objects in this scope */
-      for (unsigned i = 0 ;  i < ref->intern.size() ;  i += 1) {
-	      /* The standard says that since a port does not have a full
-	       * name it cannot be found by name. Because of this we need
-	       * to skip ports here so the correct handle can be located. */
-	    if (vpi_get(vpiType, ref->intern[i]) == vpiPort) continue;
-	    char *nm = vpi_get_str(vpiName, ref->intern[i]);
-	    if (nm && !strcmp(name, nm)) {
-		  rtn = ref->intern[i];
-		  break;
-	    } else if (vpi_get(vpiType, ref->intern[i]) == vpiMemory ||
-	               vpi_get(vpiType, ref->intern[i]) == vpiNetArray) {
-		  /* We need to iterate on the words */
-		  vpiHandle word_i, word_h;
-		  word_i = vpi_iterate(vpiMemoryWord, ref->intern[i]);
-		  while (word_i && (word_h = vpi_scan(word_i))) {
-			nm = vpi_get_str(vpiName, word_h);
-			if (nm && !strcmp(name, nm)) {
-			      rtn = word_h;
-			      vpi_free_object(word_i);
-			      break;
-			}
-		  }
-	    }
-	    /* found it yet? */
-	    if (rtn) break;
-      }
-
       return rtn;
 }
 
@@ -1347,11 +1485,6 @@ static char * find_rest(char *name)
 
 static vpiHandle find_scope(const char *name, vpiHandle handle, int depth)
 {
-
-      vpiHandle iter = handle==0
-	    ? vpi_iterate(vpiModule, NULL)
-	    : vpi_iterate(vpiInternalScope, handle);
-
       vector<char> name_buf (strlen(name)+1);
       strcpy(&name_buf[0], name);
       char*nm_first = &name_buf[0];
@@ -1361,6 +1494,25 @@ static vpiHandle find_scope(const char *name, vpiHandle handle, int depth)
 	    *nm_rest++ = 0;
       }
 
+	/* Below the root, use the scope name index to find the child
+	 * scope directly. Only fall back to the scan if the name does
+	 * not refer to a scope. */
+      if (handle) {
+	    __vpiScope*ref = dynamic_cast<__vpiScope*>(handle);
+	    assert(ref);
+	    vpiHandle hand = ref->find_item(nm_first);
+	    if (hand && dynamic_cast<__vpiScope*>(hand)) {
+		  if (nm_rest)
+			return find_scope(nm_rest, hand, depth+1);
+		  else
+			return hand;
+	    }
+      }
+
+      vpiHandle iter = handle==0
+	    ? vpi_iterate(vpiModule, NULL)
+	    : vpi_iterate(vpiInternalScope, handle);
+
       vpiHandle rtn = 0;
       vpiHandle hand;
       while (iter && (hand = vpi_scan(iter))) {
@@ -1746,5 +1898,12 @@ vpip_routines_s vpi_routines = {
     .make_systf_system_defined  = vpip_make_systf_system_defined,
     .mcd_rawwrite               = vpip_mcd_rawwrite,
     .set_return_value           = vpip_set_return_value,
+    .trace_register             = vpip_trace_register,
+    .trace_unregister           = vpip_trace_unregister,
+    .trace_add                  = vpip_trace_add,
+    .get_values                 = vpip_get_values,
+    .put_values                 = vpip_put_values,
+    .put_array_words            = vpip_put_array_words,
+    .get_array_words            = vpip_get_array_words,
 };
 #endif
@@ -24,6 +24,7 @@
 # include  "vvp_net.h"
 # include  "config.h"
 
+# include  <csignal>
 # include  <map>
 # include  <set>
 # include  <string>
@@ -99,6 +100,85 @@ enum vpi_mode_t {
 };
 extern vpi_mode_t vpi_mode_flag;
 
+/*
+ * Output buffering for the MCD and FD files (see vpi_mcd.cc). When
+ * vpip_mcd_flush_at_time is set the scheduler calls
+ * vpip_mcd_time_flush() each time the simulation time advances.
+ */
+extern bool vpip_mcd_flush_at_time;
+extern void vpip_mcd_buffering(int argc, char*argv[]);
+extern void vpip_mcd_time_flush(void);
+
+/*
+ * The VPI profiler (enabled by the VPI_PROFILE environment variable)
+ * charges the time spent in VPI module code to these counters, one
+ * per module, system task/function and kind of call. A
+ * vpip_profile_timer wrapped around a call into a module does the
+ * timing. It does nothing if it is given a nil counter, which is what
+ * callers pass when profiling is off.
+ */
+struct __vpiProfile {
+      const char*module;
+      const char*name;
+      const char*kind;
+      unsigned long calls;
+      uint64_t nsec;
+};
+
+struct __vpiUserSystf;
+
+extern bool vpip_profile_flag;
+extern volatile sig_atomic_t vpip_profile_report_flag;
+extern __vpiProfile*vpip_profile_current;
+extern uint64_t vpip_profile_nested;
+  /* The name of the module whose startup routines are running. */
+extern const char*vpip_current_module;
+
+extern void vpip_profile_init(const char*path);
+extern uint64_t vpip_profile_now(void);
+extern __vpiProfile*vpip_profile_entry(const char*module, const char*name,
+                                       const char*kind);
+extern __vpiProfile*vpip_profile_systf(__vpiUserSystf*defn, bool compiletf);
+extern __vpiProfile*vpip_profile_callback(PLI_INT32 reason);
+extern void vpip_profile_report(void);
+extern void vpip_profile_delete(void);
+extern "C" void vpip_profile_signal(int);
+
+class vpip_profile_timer {
+    public:
+      explicit inline vpip_profile_timer(__vpiProfile*prof)
+      : prof_(prof), start_(0), saved_nested_(0), saved_current_(0)
+      {
+	    if (prof_ == 0) return;
+	    saved_nested_ = vpip_profile_nested;
+	    saved_current_ = vpip_profile_current;
+	    vpip_profile_nested = 0;
+	    vpip_profile_current = prof_;
+	    start_ = vpip_profile_now();
+      }
+
+      inline ~vpip_profile_timer()
+      {
+	    if (prof_ == 0) return;
+	    uint64_t elapsed = vpip_profile_now() - start_;
+	      // Nested calls are charged to their own counters.
+	    prof_->calls += 1;
+	    prof_->nsec += elapsed - vpip_profile_nested;
+	    vpip_profile_nested = saved_nested_ + elapsed;
+	    vpip_profile_current = saved_current_;
+      }
+
+    private:
+      __vpiProfile*prof_;
+      uint64_t start_;
+      uint64_t saved_nested_;
+      __vpiProfile*saved_current_;
+
+    private: // Not implemented
+      vpip_profile_timer(const vpip_profile_timer&);
+      vpip_profile_timer& operator= (const vpip_profile_timer&);
+};
+
 /*
  * This structure is the very base of a vpiHandle. Every handle
  * structure is derived from this class so that the library can
@@ -187,6 +267,9 @@ struct __vpiCallback : public __vpiHandle {
 
 	// user supplied callback data
       struct t_cb_data cb_data;
+
+	// Profile counter, if profiling.
+      __vpiProfile*prof;
 };
 
 class value_callback : public __vpiCallback {
@@ -203,6 +286,12 @@ class value_callback : public __vpiCallback {
 
 extern void callback_execute(struct __vpiCallback*cur);
 
+/*
+ * Signal filters that have been registered with vpip_trace_add() call
+ * this to note a value change for the native tracers.
+ */
+extern void vpip_trace_mark(unsigned id);
+
 struct __vpiSystemTime : public __vpiHandle {
       __vpiSystemTime();
       int get_type_code(void) const;
@@ -254,6 +343,13 @@ class __vpiScope : public __vpiHandle {
 	// TRUE if this is an automatic func/task/block
       inline bool is_automatic() const { return is_automatic_; }
 
+	// Find an item in this scope by its base name. Array words
+	// (i.e. "mem[3]") are found through their parent array. This
+	// uses a name index that is built the first time it is needed
+	// and is discarded whenever the scope contents change.
+      vpiHandle find_item(const char*name);
+      void invalidate_name_index();
+
     public:
       __vpiScope *scope;
       unsigned file_idx;
@@ -276,8 +372,9 @@ class __vpiScope : public __vpiHandle {
       vvp_context_t live_contexts;
         /* Keep a list of freed contexts. */
       vvp_context_t free_contexts;
-	/* Keep a list of threads in the scope. */
-      std::set<vthread_t> threads;
+	/* Keep a list of threads in the scope. The list is linked
+	   through the threads themselves. */
+      vthread_t threads;
       signed int time_units :8;
       signed int time_precision :8;
 
@@ -290,13 +387,16 @@ class __vpiScope : public __vpiHandle {
       const char*tname_;
 	/* the scope may be "automatic" */
       bool is_automatic_;
+	/* Lazily built index of the intern items by name. */
+      std::map<std::string,vpiHandle>*name_index_;
 };
 
 class vpiScopeFunction  : public __vpiScope {
     public:
       inline vpiScopeFunction(const char*nam, const char*tnam,
 			      bool auto_flag, int func_type, unsigned func_wid, vvp_bit4_t func_init_val)
-      : __vpiScope(nam,tnam, auto_flag), func_type_(func_type), func_wid_(func_wid), func_init_val_(func_init_val)
+      : __vpiScope(nam,tnam, auto_flag), func_type_(func_type), func_wid_(func_wid), func_init_val_(func_init_val),
+        leaf_state_(0)
       { }
 
       int get_type_code(void) const { return vpiFunction; }
@@ -313,11 +413,16 @@ class vpiScopeFunction  : public __vpiScope {
     public:
       inline unsigned get_func_width(void) const { return func_wid_; }
       inline vvp_bit4_t get_func_init_val(void) const { return func_init_val_; }
+	// Whether the function body is a leaf that %callf can run
+	// directly: 0 until the first call, then 1 if so or -1 if not.
+      inline int get_leaf_state(void) const { return leaf_state_; }
+      inline void set_leaf_state(int state) { leaf_state_ = state; }
 
     private:
       int func_type_;
       unsigned func_wid_;
       vvp_bit4_t func_init_val_;
+      int leaf_state_;
 };
 
 extern __vpiScope* vpip_peek_current_scope(void);
@@ -350,6 +455,9 @@ struct __vpiSignal : public __vpiHandle {
       void get_bit_value(struct __vpiBit*bit, p_vpi_value vp);
       vpiHandle put_bit_value(struct __vpiBit*bit, p_vpi_value vp, int flags);
       void make_bits();
+	// Direct vector access used by the batched value routines.
+      void get_vec4(vvp_vector4_t&val) const;
+      void put_vec4(const vvp_vector4_t&val);
 
       struct __vpiBit*bits;
 
@@ -808,6 +916,11 @@ struct __vpiUserSystf : public __vpiHandle {
 
       s_vpi_systf_data info;
       bool is_user_defn;
+	// The module that registered this task/function.
+      const char*module;
+	// Profile counters, created on first use.
+      __vpiProfile*prof_calltf;
+      __vpiProfile*prof_compiletf;
 };
 
 extern vpiHandle vpip_make_systf_iterator(void);
@@ -969,6 +1082,10 @@ extern void vpip_time_to_timestruct(struct t_vpi_time*ts, vvp_time64_t ti);
 extern vvp_time64_t vpip_timestruct_to_time(const struct t_vpi_time*ts);
 
 extern double vpip_time_to_scaled_real(vvp_time64_t ti, __vpiScope*sc);
+  /* Scale a simulation time to the (rounded) integer time in the
+     units of the scope, as returned by $time. A nil scope means the
+     simulation precision. */
+extern vvp_time64_t vpip_time_to_scaled_time(vvp_time64_t ti, __vpiScope*sc);
 extern vvp_time64_t vpip_scaled_real_to_time64(double val, __vpiScope*sc);
 
 /*
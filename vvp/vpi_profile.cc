@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * This file implements the VPI profiler. When the VPI_PROFILE
+ * environment variable is set, every compiletf/calltf invocation and
+ * every callback dispatched to a VPI module is timed and the time is
+ * charged to a counter for the module, the system task/function and
+ * the kind of call. A callback is charged to the task/function that
+ * was running when it was registered. The times are self times, so a
+ * calltf that causes value change callbacks is not charged for them.
+ * The report is written at the end of simulation, and when vvp gets
+ * SIGUSR1.
+ */
+
+# include  "config.h"
+# include  "vpi_priv.h"
+# include  <cstdio>
+# include  <cstdlib>
+# include  <cstring>
+# include  <csignal>
+# include  <ctime>
+# include  <map>
+# include  <string>
+# include  <vector>
+# include  <algorithm>
+#ifndef CLOCK_MONOTONIC
+# include  <sys/time.h>
+#endif
+
+using namespace std;
+
+bool vpip_profile_flag = false;
+volatile sig_atomic_t vpip_profile_report_flag = 0;
+
+static FILE*profile_file = 0;
+
+__vpiProfile*vpip_profile_current = 0;
+uint64_t vpip_profile_nested = 0;
+
+static map<string,__vpiProfile*> profile_table;
+
+void vpip_profile_init(const char*path)
+{
+      if (strcmp(path, "-") == 0) {
+	    profile_file = stdout;
+      } else {
+	    profile_file = fopen(path, "w");
+	    if (profile_file == 0) {
+		  perror(path);
+		  exit(1);
+	    }
+      }
+      vpip_profile_flag = true;
+}
+
+uint64_t vpip_profile_now(void)
+{
+#ifdef CLOCK_MONOTONIC
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+      struct timeval tv;
+      gettimeofday(&tv, 0);
+      return (uint64_t)tv.tv_sec * 1000000000 + tv.tv_usec * 1000;
+#endif
+}
+
+__vpiProfile* vpip_profile_entry(const char*module, const char*name,
+                                 const char*kind)
+{
+      if (module == 0) module = "vvp";
+      if (name == 0) name = "-";
+
+      string key = string(module) + '\0' + name + '\0' + kind;
+      map<string,__vpiProfile*>::iterator cur = profile_table.find(key);
+      if (cur != profile_table.end())
+	    return cur->second;
+
+      __vpiProfile*prof = new __vpiProfile;
+      prof->module = strdup(module);
+      prof->name = strdup(name);
+      prof->kind = kind;
+      prof->calls = 0;
+      prof->nsec = 0;
+      profile_table[key] = prof;
+      return prof;
+}
+
+__vpiProfile* vpip_profile_systf(__vpiUserSystf*defn, bool compiletf)
+{
+      __vpiProfile*&prof = compiletf? defn->prof_compiletf : defn->prof_calltf;
+      if (prof == 0)
+	    prof = vpip_profile_entry(defn->module, defn->info.tfname,
+	                              compiletf? "compiletf" : "calltf");
+      return prof;
+}
+
+static const char* callback_reason_name(PLI_INT32 reason)
+{
+      switch (reason) {
+	  case cbValueChange:       return "cbValueChange";
+	  case cbReadOnlySynch:     return "cbReadOnlySynch";
+	  case cbReadWriteSynch:    return "cbReadWriteSynch";
+	  case cbAtStartOfSimTime:  return "cbAtStartOfSimTime";
+	  case cbAtEndOfSimTime:    return "cbAtEndOfSimTime";
+	  case cbAfterDelay:        return "cbAfterDelay";
+	  case cbEndOfCompile:      return "cbEndOfCompile";
+	  case cbStartOfSimulation: return "cbStartOfSimulation";
+	  case cbEndOfSimulation:   return "cbEndOfSimulation";
+	  case cbNextSimTime:       return "cbNextSimTime";
+	  default:                  return "callback";
+      }
+}
+
+/*
+ * A callback is charged to whatever registered it: the running
+ * task/function or callback if there is one, otherwise the module
+ * whose startup routines are being run.
+ */
+__vpiProfile* vpip_profile_callback(PLI_INT32 reason)
+{
+      const char*module = vpip_current_module;
+      const char*name = "(startup)";
+
+      if (vpip_profile_current) {
+	    module = vpip_profile_current->module;
+	    name = vpip_profile_current->name;
+      } else if (vpip_cur_task) {
+	    module = vpip_cur_task->defn->module;
+	    name = vpip_cur_task->defn->info.tfname;
+      }
+
+      return vpip_profile_entry(module, name, callback_reason_name(reason));
+}
+
+static bool profile_compare(const __vpiProfile*a, const __vpiProfile*b)
+{
+      return a->nsec > b->nsec;
+}
+
+void vpip_profile_report(void)
+{
+      vpip_profile_report_flag = 0;
+      if (! vpip_profile_flag)
+	    return;
+
+      vector<__vpiProfile*> list;
+      uint64_t total = 0;
+      for (map<string,__vpiProfile*>::iterator cur = profile_table.begin()
+		 ; cur != profile_table.end() ;  ++ cur ) {
+	    if (cur->second->calls == 0)
+		  continue;
+	    list.push_back(cur->second);
+	    total += cur->second->nsec;
+      }
+      sort(list.begin(), list.end(), profile_compare);
+
+      fprintf(profile_file, "VPI profile at time %" TIME_FMT_U
+	      ", %.6f seconds in VPI calls:\n",
+	      schedule_simtime(), total / 1e9);
+      fprintf(profile_file, "%12s %6s %12s %10s  %-16s %-20s %s\n",
+	      "seconds", "%", "calls", "ns/call", "module",
+	      "task/function", "kind");
+      for (size_t idx = 0 ;  idx < list.size() ;  idx += 1) {
+	    __vpiProfile*cur = list[idx];
+	    fprintf(profile_file, "%12.6f %6.2f %12lu %10.0f  %-16s %-20s %s\n",
+		    cur->nsec / 1e9,
+		    total? 100.0 * cur->nsec / total : 0.0,
+		    cur->calls, (double)cur->nsec / cur->calls,
+		    cur->module, cur->name, cur->kind);
+      }
+      fflush(profile_file);
+}
+
+extern "C" void vpip_profile_signal(int)
+{
+      vpip_profile_report_flag = 1;
+}
+
+void vpip_profile_delete(void)
+{
+      for (map<string,__vpiProfile*>::iterator cur = profile_table.begin()
+		 ; cur != profile_table.end() ;  ++ cur ) {
+	    free(const_cast<char*>(cur->second->module));
+	    free(const_cast<char*>(cur->second->name));
+	    delete cur->second;
+      }
+      profile_table.clear();
+      if (profile_file && profile_file != stdout)
+	    fclose(profile_file);
+      profile_file = 0;
+      vpip_profile_flag = false;
+}
@@ -26,6 +26,7 @@
 # include  "vvp_cleanup.h"
 #endif
 # include  <vector>
+# include  <cstdio>
 # include  <cstring>
 # include  <cstdlib>
 # include  <cassert>
@@ -134,6 +135,7 @@ static void delete_sub_scopes(__vpiScope *scope)
 	    }
       }
       scope->intern.clear();
+      scope->invalidate_name_index();
 
 	/* Save any class definitions to clean up later. */
       map<std::string, class_type*>::iterator citer;
@@ -329,12 +331,71 @@ static vpiHandle module_iter(int code, vpiHandle obj)
 
 
 __vpiScope::__vpiScope(const char*nam, const char*tnam, bool auto_flag)
-: is_automatic_(auto_flag)
+: is_automatic_(auto_flag), name_index_(0)
 {
+      threads = 0;
       name_ = vpip_name_string(nam);
       tname_ = vpip_name_string(tnam? tnam : "");
 }
 
+void __vpiScope::invalidate_name_index()
+{
+      delete name_index_;
+      name_index_ = 0;
+}
+
+vpiHandle __vpiScope::find_item(const char*name)
+{
+      if (name_index_ == 0) {
+	    name_index_ = new map<std::string,vpiHandle>;
+	    for (unsigned idx = 0 ;  idx < intern.size() ;  idx += 1) {
+		  vpiHandle obj = intern[idx];
+		    /* The standard says that since a port does not
+		     * have a full name it cannot be found by name. */
+		  if (obj->get_type_code() == vpiPort) continue;
+		  const char*nm = obj->vpi_get_str(vpiName);
+		  if (nm == 0) continue;
+		    /* The first item with a given name wins. */
+		  name_index_->insert(make_pair(std::string(nm), obj));
+	    }
+      }
+
+      map<std::string,vpiHandle>::const_iterator cur;
+      cur = name_index_->find(name);
+      if (cur != name_index_->end())
+	    return cur->second;
+
+	/* Array words are not in the index. Instead split a name like
+	 * "mem[3]" into the array name and the index and get the word
+	 * from the array. The index must be in the canonical form that
+	 * the word name would have. */
+      size_t len = strlen(name);
+      const char*brk = strrchr(name, '[');
+      if (brk == 0 || brk == name || name[len-1] != ']')
+	    return 0;
+
+      cur = name_index_->find(std::string(name, brk - name));
+      if (cur == name_index_->end())
+	    return 0;
+
+      vpiHandle array = cur->second;
+      int type = array->get_type_code();
+      if (type != vpiMemory && type != vpiNetArray)
+	    return 0;
+
+      char*end;
+      long word = strtol(brk+1, &end, 10);
+      if (end != name+len-1)
+	    return 0;
+
+      char sidx [64];
+      snprintf(sidx, sizeof sidx, "%ld]", word);
+      if (strcmp(sidx, brk+1) != 0)
+	    return 0;
+
+      return array->vpi_index(word);
+}
+
 int __vpiScope::vpi_get(int code)
 {
       switch (code) {
@@ -448,6 +509,7 @@ void vpip_attach_to_scope(__vpiScope*scope, vpiHandle obj)
 {
       assert(scope);
       scope->intern.push_back(obj);
+      scope->invalidate_name_index();
 }
 
 /*
@@ -645,8 +707,8 @@ unsigned vpip_add_item_to_context(automatic_hooks_s*item,
 
       scope->item[idx] = item;
 
-        /* Offset the context index by 2 to leave space for the list links. */
-      return 2 + idx;
+        /* Offset the context index by 3 to leave space for the list links. */
+      return 3 + idx;
 }
 
 
@@ -39,6 +39,7 @@
 # include  <climits>
 # include  <cstring>
 # include  <cassert>
+# include  <vector>
 #ifdef CHECK_WITH_VALGRIND
 # include  <valgrind/memcheck.h>
 #endif
@@ -151,6 +152,103 @@ static vpiHandle fill_in_var4(struct __vpiSignal*obj,
  * They work with full or partial signals.
  */
 
+/*
+ * When the whole of the signal is being formatted, the hex, octal and
+ * binary formats take the bits straight from the aval/bval words of
+ * the value instead of reading them one at a time. The signal_vecval
+ * function returns those words (with an extra zero word at the end)
+ * or nil if only part of the signal is wanted.
+ */
+static const s_vpi_vecval* signal_vecval(vvp_signal_value*sig, int base,
+                                         unsigned wid)
+{
+      static vvp_vector4_t tmp;
+      static std::vector<s_vpi_vecval> vec;
+
+      if (base != 0 || wid != sig->value_size())
+	    return 0;
+
+      sig->vec4_value(tmp);
+      if (tmp.size() != wid)
+	    return 0;
+
+      unsigned nvec = (wid + 31) / 32;
+      vec.resize(nvec + 1);
+      tmp.get_vecval(&vec[0]);
+      vec[nvec].aval = 0;
+      vec[nvec].bval = 0;
+      return &vec[0];
+}
+
+/*
+ * Return the cnt (at most 4) bits starting at idx as the 2 bit per
+ * bit codes (0, 1, X=2, Z=3) that index the hex_digits and oct_digits
+ * tables. The spread_bits table moves the bits of a nibble to the even
+ * bit positions.
+ */
+static const unsigned char spread_bits[16] = {
+      0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+      0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+};
+
+static inline unsigned vecval_codes(const s_vpi_vecval*vec, unsigned idx,
+                                    unsigned cnt)
+{
+      unsigned word = idx / 32;
+      unsigned shift = idx % 32;
+      PLI_UINT32 aval = (PLI_UINT32)vec[word].aval >> shift;
+      PLI_UINT32 bval = (PLI_UINT32)vec[word].bval >> shift;
+      if (shift + cnt > 32) {
+	    aval |= (PLI_UINT32)vec[word+1].aval << (32 - shift);
+	    bval |= (PLI_UINT32)vec[word+1].bval << (32 - shift);
+      }
+      PLI_UINT32 mask = (1U << cnt) - 1U;
+      aval &= mask;
+      bval &= mask;
+	// A set bval gives X (2) or Z (3), so the low bit of the code
+	// is aval^bval and the high bit is bval.
+      return (spread_bits[bval] << 1) | spread_bits[aval ^ bval];
+}
+
+/*
+ * The most significant digit of an octal or hex value may have only
+ * some of its bits. Fill in X or Z if they are the only thing in the
+ * partial digit.
+ */
+static unsigned oct_fill_xz(unsigned val, unsigned wid)
+{
+      switch (wid % 3) {
+	  case 1:
+	    if (val == 2) val = 42;
+	    else if (val == 3) val = 63;
+	    break;
+	  case 2:
+	    if (val == 10) val = 42;
+	    else if (val == 15) val = 63;
+	    break;
+      }
+      return val;
+}
+
+static unsigned hex_fill_xz(unsigned val, unsigned wid)
+{
+      switch (wid % 4) {
+	  case 1:
+	    if (val == 2) val = 170;
+	    else if (val == 3) val = 255;
+	    break;
+	  case 2:
+	    if (val == 10) val = 170;
+	    else if (val == 15) val = 255;
+	    break;
+	  case 3:
+	    if (val == 42) val = 170;
+	    else if (val == 63) val = 255;
+	    break;
+      }
+      return val;
+}
+
 static void format_vpiBinStrVal(vvp_signal_value*sig, int base, unsigned wid,
                                 s_vpi_value*vp)
 {
@@ -159,6 +257,21 @@ static void format_vpiBinStrVal(vvp_signal_value*sig, int base, unsigned wid,
       long offset = end - 1;
       long ssize = (signed)sig->value_size();
 
+      if (const s_vpi_vecval*vec = signal_vecval(sig, base, wid)) {
+	    static const char bin_digits[4] = { '0', '1', 'x', 'z' };
+	    for (unsigned idx = 0 ;  idx < wid ;  idx += 4) {
+		  unsigned cnt = (wid - idx < 4) ? wid - idx : 4;
+		  unsigned val = vecval_codes(vec, idx, cnt);
+		  for (unsigned bit = 0 ;  bit < cnt ;  bit += 1) {
+			rbuf[wid-1-idx-bit] = bin_digits[val & 3];
+			val >>= 2;
+		  }
+	    }
+	    rbuf[wid] = 0;
+	    vp->value.str = rbuf;
+	    return;
+      }
+
       for (long idx = base ;  idx < end ;  idx += 1) {
 	    if (idx < 0 || idx >= ssize) {
                   rbuf[offset-idx] = 'x';
@@ -181,6 +294,17 @@ static void format_vpiOctStrVal(vvp_signal_value*sig, int base, unsigned wid,
       unsigned val = 0;
 
       rbuf[dwid] = 0;
+      if (const s_vpi_vecval*vec = signal_vecval(sig, base, wid)) {
+	    for (unsigned idx = 0 ;  idx + 3 <= wid ;  idx += 3) {
+		  dwid -= 1;
+		  rbuf[dwid] = oct_digits[vecval_codes(vec, idx, 3)];
+	    }
+	    if (dwid > 0)
+		  rbuf[0] = oct_digits[oct_fill_xz(vecval_codes(vec, wid - wid%3, wid%3), wid)];
+	    vp->value.str = rbuf;
+	    return;
+      }
+
       for (long idx = base ;  idx < end ;  idx += 1) {
 	    unsigned bit = 0;
 	    if (idx < 0 || idx >= ssize) {
@@ -210,19 +334,7 @@ static void format_vpiOctStrVal(vvp_signal_value*sig, int base, unsigned wid,
 	    }
       }
 
-	/* Fill in X or Z if they are the only thing in the value. */
-      switch (wid % 3) {
-	  case 1:
-	    if (val == 2) val = 42;
-	    else if (val == 3) val = 63;
-	    break;
-	  case 2:
-	    if (val == 10) val = 42;
-	    else if (val == 15) val = 63;
-	    break;
-      }
-
-      if (dwid > 0) rbuf[0] = oct_digits[val];
+      if (dwid > 0) rbuf[0] = oct_digits[oct_fill_xz(val, wid)];
 
       vp->value.str = rbuf;
 }
@@ -237,6 +349,17 @@ static void format_vpiHexStrVal(vvp_signal_value*sig, int base, unsigned wid,
       unsigned val = 0;
 
       rbuf[dwid] = 0;
+      if (const s_vpi_vecval*vec = signal_vecval(sig, base, wid)) {
+	    for (unsigned idx = 0 ;  idx + 4 <= wid ;  idx += 4) {
+		  dwid -= 1;
+		  rbuf[dwid] = hex_digits[vecval_codes(vec, idx, 4)];
+	    }
+	    if (dwid > 0)
+		  rbuf[0] = hex_digits[hex_fill_xz(vecval_codes(vec, wid - wid%4, wid%4), wid)];
+	    vp->value.str = rbuf;
+	    return;
+      }
+
       for (long idx = base ;  idx < end ;  idx += 1) {
 	    unsigned bit = 0;
 	    if (idx < 0 || idx >= ssize) {
@@ -266,23 +389,7 @@ static void format_vpiHexStrVal(vvp_signal_value*sig, int base, unsigned wid,
 	    }
       }
 
-	/* Fill in X or Z if they are the only thing in the value. */
-      switch (wid % 4) {
-	  case 1:
-	    if (val == 2) val = 170;
-	    else if (val == 3) val = 255;
-	    break;
-	  case 2:
-	    if (val == 10) val = 170;
-	    else if (val == 15) val = 255;
-	    break;
-	  case 3:
-	    if (val == 42) val = 170;
-	    else if (val == 63) val = 255;
-	    break;
-      }
-
-      if (dwid > 0) rbuf[0] = hex_digits[val];
+      if (dwid > 0) rbuf[0] = hex_digits[hex_fill_xz(val, wid)];
 
       vp->value.str = rbuf;
 }
@@ -973,14 +1080,34 @@ static vpiHandle signal_put_value(vpiHandle ref, s_vpi_value*vp, int flags)
       if (flags == vpiForceFlag) {
 	    vvp_vector2_t mask (vvp_vector2_t::FILL1, wid);
 	    rfp->node->force_vec4(val, mask);
-      } else if (net_flag && !dynamic_cast<vvp_island_port*>(rfp->node->fun)) {
-	    rfp->node->send_vec4(val, vthread_get_wt_context());
       } else {
-	    vvp_send_vec4(dest, val, vthread_get_wt_context());
+	    rfp->put_vec4(val);
       }
       return ref;
 }
 
+void __vpiSignal::get_vec4(vvp_vector4_t&val) const
+{
+      vvp_signal_value*vsig = dynamic_cast<vvp_signal_value*>(node->fil);
+      assert(vsig);
+      vsig->vec4_value(val);
+}
+
+/*
+ * Deposit a value into the signal, as a vpiNoDelay vpi_put_value
+ * would. Nets that are not part of an island have their value sent
+ * directly to the net output, everything else goes through the input.
+ */
+void __vpiSignal::put_vec4(const vvp_vector4_t&val)
+{
+      if (get_type_code()==vpiNet && !dynamic_cast<vvp_island_port*>(node->fun)) {
+	    node->send_vec4(val, vthread_get_wt_context());
+      } else {
+	    vvp_net_ptr_t dest(node, 0);
+	    vvp_send_vec4(dest, val, vthread_get_wt_context());
+      }
+}
+
 vvp_vector4_t vec4_from_vpi_value(s_vpi_value*vp, unsigned wid)
 {
       vvp_vector4_t val (wid, BIT4_0);
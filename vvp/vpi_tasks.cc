@@ -39,6 +39,7 @@
 using namespace std;
 
 inline __vpiUserSystf::__vpiUserSystf()
+: is_user_defn(false), module(0), prof_calltf(0), prof_compiletf(0)
 { }
 
 int __vpiUserSystf::get_type_code(void) const
@@ -952,7 +953,11 @@ void vpip_execute_vpi_call(vthread_t thr, vpiHandle ref)
 	    assert(vpi_mode_flag == VPI_MODE_NONE);
 	    vpi_mode_flag = VPI_MODE_CALLTF;
 	    vpip_cur_task->put_value = false;
-	    vpip_cur_task->defn->info.calltf(vpip_cur_task->defn->info.user_data);
+	    {
+		  vpip_profile_timer timer (vpip_profile_flag
+			? vpip_profile_systf(vpip_cur_task->defn, false) : 0);
+		  vpip_cur_task->defn->info.calltf(vpip_cur_task->defn->info.user_data);
+	    }
 	    vpi_mode_flag = VPI_MODE_NONE;
 	      /* If the function call did not set a value then put a
 	       * default value (0). */
@@ -1007,6 +1012,7 @@ vpiHandle vpi_register_systf(const struct t_vpi_systf_data*ss)
       cur->info = *ss;
       cur->info.tfname = strdup(ss->tfname);
       cur->is_user_defn = true;
+      cur->module = vpip_current_module;
 
       return cur;
 }
@@ -65,6 +65,34 @@ double vpip_time_to_scaled_real(vvp_time64_t ti, __vpiScope*scope)
       return val;
 }
 
+/*
+ * Scale a simulation time to the time units of the scope, rounding
+ * to the nearest unit. This is the integer version of
+ * vpip_time_to_scaled_real().
+ */
+vvp_time64_t vpip_time_to_scaled_time(vvp_time64_t ti, __vpiScope*scope)
+{
+      int units = scope? scope->time_units : vpi_time_precision;
+
+	/* Calculate the divisor needed to scale the simulation time
+	   (in time_precision units) to time units of the scope. */
+      vvp_time64_t divisor = 1;
+      while (units > vpi_time_precision) {
+	    divisor *= 10;
+	    units -= 1;
+      }
+
+	/* Scale the simtime, and use the modulus to round up if
+	   appropriate. */
+      vvp_time64_t fraction = ti % divisor;
+      ti /= divisor;
+
+      if ((divisor >= 10) && (fraction >= (divisor/2)))
+	    ti += 1;
+
+      return ti;
+}
+
 /*
  * This routine does not currently support negative real delays and it
  * does not check for overflow. It is only used for modpath delays and
@@ -103,26 +131,11 @@ static void timevar_get_value(vpiHandle ref, s_vpi_value*vp, bool is_int_func,
 
       struct __vpiSystemTime*rfp = dynamic_cast<__vpiSystemTime*>(ref);
       unsigned long num_bits;
-      vvp_time64_t x, simtime = schedule_simtime();
-      int units = rfp->scope? rfp->scope->time_units : vpi_time_precision;
+      vvp_time64_t x, simtime;
 
       char*rbuf = (char *) need_result_buf(128, RBUF_VAL);
 
-	/* Calculate the divisor needed to scale the simulation time
-	   (in time_precision units) to time units of the scope. */
-      vvp_time64_t divisor = 1;
-      while (units > vpi_time_precision) {
-	    divisor *= 10;
-	    units -= 1;
-      }
-
-	/* Scale the simtime, and use the modulus to round up if
-	   appropriate. */
-      vvp_time64_t simtime_fraction = simtime % divisor;
-      simtime /= divisor;
-
-      if ((divisor >= 10) && (simtime_fraction >= (divisor/2)))
-	    simtime += 1;
+      simtime = vpip_time_to_scaled_time(schedule_simtime(), rfp->scope);
 
 	/* If this is a call to $stime only return the lower 32 bits. */
       if (is_stime) simtime &= 0xffffffff;
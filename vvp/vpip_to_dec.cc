@@ -53,6 +53,8 @@
 #endif
 #endif
 
+#define ALLOC_MARGIN 4
+
 #define B_IS0(x)  ((x) == 0)
 #define B_IS1(x)  ((x) == 1)
 #define B_ISX(x)  ((x) == 2)
@@ -67,18 +69,25 @@
  * propagated as a "carry" to the next array element, the result is again
  * less than or equal to 2^BBITS.  BBITS and BASE are configured above
  * to depend on the "unsigned long" length of the host, for efficiency.
+ *
+ * Only the ulen low elements of valv are in use. Shifting in the most
+ * significant bits first means the number grows from nothing, so the
+ * carry out extends ulen instead of being pushed through a run of
+ * leading zero elements. The new ulen is returned.
  */
-static inline void shift_in(unsigned long *valv, unsigned int vlen, unsigned long val)
+static inline unsigned shift_in(unsigned long *valv, unsigned int ulen, unsigned long val)
 {
 	unsigned int i;
-	/* printf("shift in %u\n",val); */
-	for (i=0; i<vlen; i++) {
+	for (i=0; i<ulen; i++) {
 		val=(valv[i]<<BBITS)+val;
 		valv[i]=val%BASE;
 		val=val/BASE;
 	}
-	if (val!=0)
-	      fprintf(stderr,"internal error: carry out %lu in " __FILE__ "\n",val);
+	while (val!=0) {
+		valv[ulen++]=val%BASE;
+		val=val/BASE;
+	}
+	return ulen;
 }
 
 /* Since BASE is a power of ten, conversion of each element of the
@@ -104,9 +113,13 @@ static inline int write_digits(unsigned long v, char **buf,
 }
 
 /* Jump through some hoops so we don't have to malloc/free valv
- * on every call, and implement an optional malloc-less version. */
+ * on every call, and implement an optional malloc-less version.
+ * The vecv array holds the aval/bval words of the vector being
+ * converted and is kept around in the same way. */
 static unsigned long *valv=NULL;
 static unsigned int vlen_alloc=0;
+static s_vpi_vecval *vecv=NULL;
+static unsigned int vecv_alloc=0;
 
 #ifdef CHECK_WITH_VALGRIND
 void dec_str_delete(void)
@@ -114,112 +127,138 @@ void dec_str_delete(void)
       free(valv);
       valv = 0;
       vlen_alloc = 0;
+      free(vecv);
+      vecv = 0;
+      vecv_alloc = 0;
 }
 #endif
 
+/* Count the bits of the vector that are X and Z. This is only needed
+ * when some bval is set, so it is done a bit at a time. */
+static void count_xz(const s_vpi_vecval*vec, unsigned wid,
+                     unsigned&count_x, unsigned&count_z)
+{
+      for (unsigned idx = 0 ;  idx < wid ;  idx += 1) {
+	    PLI_UINT32 mask = 1U << (idx%32);
+	    if (! (vec[idx/32].bval & mask)) continue;
+	    if (vec[idx/32].aval & mask)
+		  count_x += 1;
+	    else
+		  count_z += 1;
+      }
+}
+
 unsigned vpip_vec4_to_dec_str(const vvp_vector4_t&vec4,
 			      char *buf, unsigned int nbuf,
 			      int signed_flag)
 {
-      unsigned int idx, vlen;
-      unsigned int mbits=vec4.size();   /* number of non-sign bits */
-      unsigned count_x = 0, count_z = 0;
-
-      unsigned long val=0;
-      int comp=0;
-      if (signed_flag) {
-	    switch (vec4.value(vec4.size()-1)) {
-		case BIT4_X:
-		  count_x += 1;
-		  break;
-		case BIT4_Z:
-		  count_z += 1;
-		  break;
-		case BIT4_1:
-		  comp=1;
-		  break;
-		case BIT4_0:
+      unsigned int wid = vec4.size();
+      unsigned int nvec = (wid + 31) / 32;
+      int comp = 0;
+
+      if (nvec > vecv_alloc) {
+	    free(vecv);
+	    vecv = (s_vpi_vecval*) malloc((nvec+ALLOC_MARGIN) * sizeof(*vecv));
+	    vecv_alloc = nvec+ALLOC_MARGIN;
+      }
+      vec4.get_vecval(vecv);
+
+	/* Any X or Z bits make the whole result a single character. */
+      bool has_xz = false;
+      for (unsigned idx = 0 ;  idx < nvec ;  idx += 1) {
+	    if (vecv[idx].bval) {
+		  has_xz = true;
 		  break;
 	    }
-	    mbits -= 1;
       }
-      assert(mbits<(UINT_MAX-92)/28);
-      vlen = ((mbits*28+92)/93+BDIGITS-1)/BDIGITS;
-	/* printf("vlen=%d\n",vlen); */
-
-#define ALLOC_MARGIN 4
-      if (!valv || vlen > vlen_alloc) {
-	    if (valv) free(valv);
-	    valv = (unsigned long*) calloc(vlen+ALLOC_MARGIN, sizeof (*valv));
-	    vlen_alloc=vlen+ALLOC_MARGIN;
-      } else {
-	    memset(valv,0,vlen*sizeof(valv[0]));
+      if (has_xz) {
+	    unsigned count_x = 0, count_z = 0;
+	    count_xz(vecv, wid, count_x, count_z);
+	    if (count_x == wid)
+		  buf[0] = 'x';
+	    else if (count_x > 0)
+		  buf[0] = 'X';
+	    else if (count_z == wid)
+		  buf[0] = 'z';
+	    else
+		  buf[0] = 'Z';
+	    buf[1] = 0;
+	    return 0;
       }
 
-      for (idx = 0; idx < mbits; idx += 1) {
-	      /* printf("%c ",bits[mbits-idx-1]); */
-	    switch (vec4.value(mbits-idx-1)) {
-		case BIT4_Z:
-		  count_z += 1;
-		  break;
-		case BIT4_X:
-		  count_x += 1;
-		  break;
-		case BIT4_1:
-		  if (! comp)
-			val += 1;
-		  break;
-		case BIT4_0:
-		  if (comp)
-			val += 1;
-		  break;
+	/* Turn a negative value into its magnitude. The magnitude of
+	   the most negative value needs all wid bits, so the
+	   complement is taken over the full width. */
+      if (signed_flag && wid > 0 &&
+          (vecv[(wid-1)/32].aval >> ((wid-1)%32)) & 1) {
+	    comp = 1;
+	    PLI_UINT32 carry = 1;
+	    for (unsigned idx = 0 ;  idx < nvec ;  idx += 1) {
+		  PLI_UINT32 word = ~(PLI_UINT32)vecv[idx].aval;
+		  if (idx == nvec-1 && wid%32)
+			word &= (1U << (wid%32)) - 1U;
+		  word += carry;
+		  carry = (carry && word == 0) ? 1 : 0;
+		  vecv[idx].aval = (PLI_INT32)word;
 	    }
+      }
+
+      if (comp) {
+	    *buf++='-';
+	    nbuf--;
+      }
 
-	    if ((mbits-idx-1)%BBITS==0) {
-		    /* make negative 2's complement, not 1's complement */
-		  if (comp && idx==mbits-1) ++val;
-		  shift_in(valv,vlen,val);
-		  val=0;
-	    } else {
-		  val=val+val;
+	/* Values that fit in 64 bits are converted directly. */
+      if (nvec <= 2) {
+	    uint64_t val = 0;
+	    if (nvec >= 1)
+		  val |= (PLI_UINT32)vecv[0].aval;
+	    if (nvec == 2)
+		  val |= (uint64_t)(PLI_UINT32)vecv[1].aval << 32;
+
+	    char tmp[24];
+	    unsigned cnt = 0;
+	    do {
+		  tmp[cnt++] = '0' + val%10;
+		  val /= 10;
+	    } while (val != 0);
+	    while (cnt > 0) {
+		  *buf++ = tmp[--cnt];
+		  nbuf--;
 	    }
+	    *buf = '\0';
+	    return 0;
       }
 
-	if (count_x == vec4.size()) {
-	      buf[0] = 'x';
-	      buf[1] = 0;
-	} else if (count_x > 0) {
-	      buf[0] = 'X';
-	      buf[1] = 0;
-	} else if (count_z == vec4.size()) {
-	      buf[0] = 'z';
-	      buf[1] = 0;
-	} else if (count_z > 0) {
-	      buf[0] = 'Z';
-	      buf[1] = 0;
-	} else {
-	      int i;
-	      int zero_suppress=1;
-	      if (comp) {
-		    *buf++='-';
-		    nbuf--;
-		      /* printf("-"); */
-	      }
-	      for (i=vlen-1; i>=0; i--) {
-		    zero_suppress = write_digits(valv[i],
-						 &buf,&nbuf,zero_suppress);
-		      /* printf(",%.4u",valv[i]); */
-	      }
-		/* Awkward special case, since we don't want to
-		 * zero suppress down to nothing at all.  The only
-		 * way we can still have zero_suppress on in the
-		 * comp=1 case is if mbits==0, and therefore vlen==0.
-		 * We represent 1'sb1 as "-1". */
-	      if (zero_suppress) *buf++='0'+comp;
-		/* printf("\n"); */
-	      *buf='\0';
-	}
-	return 0;
+      unsigned vlen = ((wid*28+92)/93+BDIGITS-1)/BDIGITS + 1;
+      if (!valv || vlen > vlen_alloc) {
+	    free(valv);
+	    valv = (unsigned long*) malloc((vlen+ALLOC_MARGIN) * sizeof(*valv));
+	    vlen_alloc = vlen+ALLOC_MARGIN;
+      }
+
+	/* Shift the magnitude in a word at a time, most significant
+	   word first. */
+      unsigned ulen = 0;
+      for (unsigned idx = nvec ;  idx > 0 ;  idx -= 1) {
+	    unsigned long word = (PLI_UINT32)vecv[idx-1].aval;
+#if BBITS == 32
+	    ulen = shift_in(valv, ulen, word);
+#else
+	    ulen = shift_in(valv, ulen, word >> BBITS);
+	    ulen = shift_in(valv, ulen, word & BMASK);
+#endif
+      }
+      assert(ulen <= vlen_alloc);
+
+      int zero_suppress = 1;
+      for (int i = ulen-1; i >= 0; i--) {
+	    zero_suppress = write_digits(valv[i], &buf, &nbuf, zero_suppress);
+      }
+	/* We don't want to zero suppress down to nothing at all. */
+      if (zero_suppress) *buf++='0';
+      *buf='\0';
+      return 0;
 }
 
 void vpip_dec_str_to_vec4(vvp_vector4_t&vec, const char*buf)
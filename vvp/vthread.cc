@@ -28,6 +28,9 @@
 # include  "vvp_cobject.h"
 # include  "vvp_darray.h"
 # include  "class_type.h"
+# include  "statistics.h"
+# include  "sim_profile.h"
+# include  "coverage.h"
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 #endif
@@ -268,6 +271,7 @@ struct vthread_s {
       unsigned i_am_detached     :1;
       unsigned i_am_waiting      :1;
       unsigned i_am_in_function  :1; // True if running function code
+      unsigned i_am_leaf_call    :1; // True if running a leaf function call
       unsigned i_have_ended      :1;
       unsigned i_was_disabled    :1;
       unsigned waiting_for_event :1;
@@ -281,13 +285,20 @@ struct vthread_s {
       struct vthread_s*parent;
 	/* This points to the containing scope. */
       __vpiScope*parent_scope;
-	/* This is used for keeping wait queues. */
+	/* These link the thread into the list of threads in the
+	   containing scope. */
+      struct vthread_s*scope_next;
+      struct vthread_s*scope_prev;
+	/* This is used for keeping wait queues, and for the list of
+	   free threads. */
       struct vthread_s*wait_next;
 	/* These are used to access automatically allocated items. */
       vvp_context_t wt_context, rd_context;
 	/* These are used to pass non-blocking event control information. */
       vvp_net_t*event;
       uint64_t ecount;
+	/* The profiler entry for the source line the thread is at. */
+      sim_profile_entry*prof_entry;
 	/* Save the file/line information when available. */
     private:
       char *filenm_;
@@ -364,6 +375,7 @@ void vthread_s::debug_dump(ostream&fd, const char*label)
       fd << "**** Done ****" << endl;
 }
 
+static void pop_child_context(vthread_t thr, vthread_t child);
 static void do_join(vthread_t thr, vthread_t child);
 
 __vpiScope* vthread_scope(struct vthread_s*thr)
@@ -450,6 +462,19 @@ template <class VVP_QUEUE> static vvp_queue*get_queue_object(vthread_t thr, vvp_
       return queue;
 }
 
+/*
+ * Get the dynamic array or queue in the variable referenced by "net",
+ * or nil if the variable has not been allocated. Unlike a queue that
+ * is being added to, an array that is only read is not allocated.
+ */
+static vvp_darray*get_darray_object(vvp_net_t*net)
+{
+      vvp_fun_signal_object*obj = dynamic_cast<vvp_fun_signal_object*> (net->fun);
+      assert(obj);
+
+      return obj->get_object().peek<vvp_darray>();
+}
+
 /*
  * The following are used to allow a common template to be written for
  * queue real/string/vec4 operations
@@ -564,8 +589,10 @@ static void multiply_array_imm(unsigned long*res, unsigned long*val,
 
 /*
  * Allocate a context for use by a child thread. By preference, use
- * the last freed context. If none available, create a new one. Add
- * it to the list of live contexts in that scope.
+ * the last freed context, so recursive calls reuse the contexts of
+ * earlier calls in stack order. If none available, create a new one
+ * in the context arena. Add it to the list of live contexts in that
+ * scope.
  */
 static vvp_context_t vthread_alloc_context(__vpiScope*scope)
 {
@@ -577,14 +604,19 @@ static vvp_context_t vthread_alloc_context(__vpiScope*scope)
             for (unsigned idx = 0 ; idx < scope->nitem ; idx += 1) {
                   scope->item[idx]->reset_instance(context);
             }
+            count_contexts_reused += 1;
       } else {
             context = vvp_allocate_context(scope->nitem);
             for (unsigned idx = 0 ; idx < scope->nitem ; idx += 1) {
                   scope->item[idx]->alloc_instance(context);
             }
+            count_contexts += 1;
       }
 
+      vvp_set_prev_context(context, 0);
       vvp_set_next_context(context, scope->live_contexts);
+      if (scope->live_contexts)
+            vvp_set_prev_context(scope->live_contexts, context);
       scope->live_contexts = context;
 
       return context;
@@ -593,23 +625,24 @@ static vvp_context_t vthread_alloc_context(__vpiScope*scope)
 /*
  * Free a context previously allocated to a child thread by pushing it
  * onto the freed context stack. Remove it from the list of live contexts
- * in that scope.
+ * in that scope. The live list is doubly linked because contexts of
+ * forked threads need not be freed in the order they were allocated.
  */
 static void vthread_free_context(vvp_context_t context, __vpiScope*scope)
 {
       assert(scope->is_automatic());
       assert(context);
 
-      if (context == scope->live_contexts) {
-            scope->live_contexts = vvp_get_next_context(context);
+      vvp_context_t prev = vvp_get_prev_context(context);
+      vvp_context_t next = vvp_get_next_context(context);
+      if (prev) {
+            vvp_set_next_context(prev, next);
       } else {
-            vvp_context_t tmp = scope->live_contexts;
-            while (context != vvp_get_next_context(tmp)) {
-                  assert(tmp);
-                  tmp = vvp_get_next_context(tmp);
-            }
-            vvp_set_next_context(tmp, vvp_get_next_context(context));
+            assert(context == scope->live_contexts);
+            scope->live_contexts = next;
       }
+      if (next)
+            vvp_set_prev_context(next, prev);
 
       vvp_set_next_context(context, scope->free_contexts);
       scope->free_contexts = context;
@@ -625,23 +658,81 @@ void contexts_delete(struct __vpiScope*scope)
 	    for (unsigned idx = 0; idx < scope->nitem; idx += 1) {
 		  scope->item[idx]->free_instance(context);
 	    }
-	    free(context);
 	    context = scope->free_contexts;
       }
       free(scope->item);
 }
 #endif
 
+/*
+ * The threads in a scope are kept in an intrusive list so that adding
+ * and removing a thread does not allocate. A thread that is not in
+ * the list has a nil scope_prev and is not the head.
+ */
+static void scope_add_thread(__vpiScope*scope, vthread_t thr)
+{
+      thr->scope_prev = 0;
+      thr->scope_next = scope->threads;
+      if (scope->threads)
+	    scope->threads->scope_prev = thr;
+      scope->threads = thr;
+}
+
+static void scope_remove_thread(__vpiScope*scope, vthread_t thr)
+{
+      if (thr->scope_prev) {
+	    thr->scope_prev->scope_next = thr->scope_next;
+      } else if (scope->threads == thr) {
+	    scope->threads = thr->scope_next;
+      } else {
+	    return;
+      }
+      if (thr->scope_next)
+	    thr->scope_next->scope_prev = thr->scope_prev;
+      thr->scope_next = 0;
+      thr->scope_prev = 0;
+}
+
+/*
+ * Threads are created for every %fork and every function call, so
+ * deleted threads are kept in a free list and reused. A reused thread
+ * keeps the capacity of its stacks.
+ */
+static vthread_t thread_free_list = 0;
+static unsigned long thread_pool_count = 0;
+unsigned long count_vthreads = 0;
+unsigned long count_vthread_leaf_calls = 0;
+
+unsigned long count_vthread_pool(void)
+{
+      return thread_pool_count;
+}
+
+static vthread_t vthread_alloc(void)
+{
+      vthread_t thr = thread_free_list;
+      if (thr) {
+	    thread_free_list = thr->wait_next;
+	    return thr;
+      }
+
+      thread_pool_count += 1;
+      return new struct vthread_s;
+}
+
 /*
  * Create a new thread with the given start address.
  */
-vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
+static vthread_t vthread_init(vvp_code_t pc, __vpiScope*scope)
 {
-      vthread_t thr = new struct vthread_s;
+      vthread_t thr = vthread_alloc();
+      count_vthreads += 1;
       thr->pc     = pc;
 	//thr->bits4  = vvp_vector4_t(32);
       thr->parent = 0;
       thr->parent_scope = scope;
+      thr->scope_next = 0;
+      thr->scope_prev = 0;
       thr->wait_next = 0;
       thr->wt_context = 0;
       thr->rd_context = 0;
@@ -650,6 +741,7 @@ vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
       thr->i_am_detached = 0;
       thr->i_am_waiting  = 0;
       thr->i_am_in_function = 0;
+      thr->i_am_leaf_call = 0;
       thr->is_scheduled  = 0;
       thr->i_have_ended  = 0;
       thr->i_was_disabled = 0;
@@ -657,6 +749,7 @@ vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
       thr->waiting_for_event = 0;
       thr->event  = 0;
       thr->ecount = 0;
+      thr->prof_entry = 0;
 
       thr->flags[0] = BIT4_0;
       thr->flags[1] = BIT4_1;
@@ -665,7 +758,13 @@ vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
       for (int idx = 4 ; idx < 8 ; idx += 1)
 	    thr->flags[idx] = BIT4_X;
 
-      scope->threads .insert(thr);
+      return thr;
+}
+
+vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
+{
+      vthread_t thr = vthread_init(pc, scope);
+      scope_add_thread(scope, thr);
       return thr;
 }
 
@@ -699,11 +798,15 @@ static void child_delete(vthread_t base)
 
 void vthreads_delete(struct __vpiScope*scope)
 {
-      for (std::set<vthread_t>::iterator cur = scope->threads.begin()
-		 ; cur != scope->threads.end() ; ++ cur ) {
-	    delete *cur;
+      while (vthread_t cur = scope->threads) {
+	    scope->threads = cur->scope_next;
+	    delete cur;
+      }
+
+      while (vthread_t cur = thread_free_list) {
+	    thread_free_list = cur->wait_next;
+	    delete cur;
       }
-      scope->threads.clear();
 }
 #endif
 
@@ -747,7 +850,7 @@ static void vthread_reap(vthread_t thr)
       thr->parent = 0;
 
 	// Remove myself from the containing scope if needed.
-      thr->parent_scope->threads.erase(thr);
+      scope_remove_thread(thr->parent_scope, thr);
 
       thr->pc = codespace_null();
 
@@ -767,7 +870,11 @@ static void vthread_reap(vthread_t thr)
 void vthread_delete(vthread_t thr)
 {
       thr->cleanup();
-      delete thr;
+      thr->args_real.clear();
+      thr->args_str.clear();
+      thr->args_vec4.clear();
+      thr->wait_next = thread_free_list;
+      thread_free_list = thr;
 }
 
 void vthread_mark_scheduled(vthread_t thr)
@@ -785,6 +892,38 @@ void vthread_delay_delete()
 	    running_thread->delay_delete = 1;
 }
 
+/*
+ * This is the instruction loop of vthread_run() for when the
+ * simulation profiler is on. The instructions and time are charged
+ * to the source line that the thread is at, or to its scope if it
+ * has not passed a %file_line.
+ */
+static void run_thread_profiled(vthread_t thr)
+{
+      sim_profile_entry*entry = thr->prof_entry;
+      if (entry == 0)
+	    entry = sim_profile_scope(thr->parent_scope);
+      entry->runs += 1;
+      sim_profile_entry*prev = sim_profile_switch(entry);
+
+      for (;;) {
+	    vvp_code_t cp = thr->pc;
+	    thr->pc += 1;
+	    entry->insns += 1;
+
+	    bool rc = (cp->opcode)(thr, cp);
+	    if (cp->opcode == &of_FILE_LINE) {
+		  entry = sim_profile_line(thr->parent_scope, cp->handle);
+		  thr->prof_entry = entry;
+		  sim_profile_switch(entry);
+	    }
+	    if (rc == false)
+		  break;
+      }
+
+      sim_profile_switch(prev);
+}
+
 /*
  * This function runs each thread by fetching an instruction,
  * incrementing the PC, and executing the instruction. The thread may
@@ -801,6 +940,12 @@ void vthread_run(vthread_t thr)
 
             running_thread = thr;
 
+	    if (sim_profile_flag) {
+		  run_thread_profiled(thr);
+		  thr = tmp;
+		  continue;
+	    }
+
 	    for (;;) {
 		  vvp_code_t cp = thr->pc;
 		  thr->pc += 1;
@@ -830,18 +975,26 @@ bool of_CHUNK_LINK(vthread_t thr, vvp_code_t code)
 }
 
 /*
- * This is called by an event functor to wake up all the threads on
- * its list. I in fact created that list in the %wait instruction, and
- * I also am certain that the waiting_for_event flag is set.
+ * This is called by an event functor to wake up all the threads in
+ * its array. The %wait instruction put them there, so I am certain
+ * that the waiting_for_event flag is set. The threads are linked in
+ * reverse order, as the %wait instruction used to push them on the
+ * front of a list, and marked scheduled in the same pass.
  */
-void vthread_schedule_list(vthread_t thr)
+void vthread_schedule_list(vthread_t*list, unsigned count)
 {
-      for (vthread_t cur = thr ;  cur ;  cur = cur->wait_next) {
+      vthread_t head = 0;
+      for (unsigned idx = 0 ;  idx < count ;  idx += 1) {
+	    vthread_t cur = list[idx];
 	    assert(cur->waiting_for_event);
+	    assert(cur->is_scheduled == 0);
 	    cur->waiting_for_event = 0;
+	    cur->is_scheduled = 1;
+	    cur->wait_next = head;
+	    head = cur;
       }
 
-      schedule_vthread(thr, 0);
+      schedule_vthread_list(head);
 }
 
 vvp_context_t vthread_get_wt_context()
@@ -1406,6 +1559,120 @@ bool of_BREAKPOINT(vthread_t, vvp_code_t)
       return true;
 }
 
+/*
+ * A leaf function is one whose body runs straight through to its
+ * %end. It does not fork, join, disable or call other functions, and
+ * every jump stays within the body. The scan gives up on very large
+ * functions, which gain little from being leaves anyway.
+ */
+static bool is_leaf_function(vvp_code_t pc)
+{
+      set<vvp_code_t> body;
+      vector<vvp_code_t> jumps;
+
+      for (;;) {
+	    vvp_code_fun op = pc->opcode;
+	    if (op == &of_CHUNK_LINK) {
+		  pc = pc->cptr;
+		  continue;
+	    }
+
+	    body.insert(pc);
+	    if (op == &of_END)
+		  break;
+	    if (body.size() > 1024)
+		  return false;
+
+	    if (op == &of_FORK || op == &of_JOIN || op == &of_JOIN_DETACH
+		|| op == &of_WAIT || op == &of_WAIT_FORK
+		|| op == &of_DELAY || op == &of_DELAYX
+		|| op == &of_DISABLE || op == &of_DISABLE_FORK
+		|| op == &of_CALLF_OBJ || op == &of_CALLF_REAL
+		|| op == &of_CALLF_STR || op == &of_CALLF_VEC4
+		|| op == &of_CALLF_VOID || op == &of_EXEC_UFUNC_REAL
+		|| op == &of_EXEC_UFUNC_VEC4 || op == &of_ZOMBIE)
+		  return false;
+
+	    if (op == &of_JMP || op == &of_JMP0 || op == &of_JMP0XZ
+		|| op == &of_JMP1 || op == &of_JMP1XZ)
+		  jumps.push_back(pc->cptr);
+
+	    pc += 1;
+      }
+
+      for (size_t idx = 0 ; idx < jumps.size() ; idx += 1) {
+	    if (body.find(jumps[idx]) == body.end())
+		  return false;
+      }
+
+      return true;
+}
+
+/*
+ * Make the thread for a %callf instruction. A leaf function cannot
+ * be the target of a %disable while it runs, so its thread is not
+ * linked into the function scope. The profiler needs the function to
+ * run through vthread_run(), so it does not use leaf calls.
+ */
+static vthread_t callf_thread_new(vvp_code_t cp)
+{
+      assert(cp->scope->get_type_code() == vpiFunction);
+      vpiScopeFunction*scope_func = static_cast<vpiScopeFunction*>(cp->scope);
+      if (scope_func->get_leaf_state() == 0)
+	    scope_func->set_leaf_state(is_leaf_function(cp->cptr2)? 1 : -1);
+
+      vthread_t child = vthread_init(cp->cptr2, cp->scope);
+      if (scope_func->get_leaf_state() > 0 && ! sim_profile_flag)
+	    child->i_am_leaf_call = 1;
+      else
+	    scope_add_thread(cp->scope, child);
+
+      return child;
+}
+
+/*
+ * Run a leaf function call to its %end directly, without the fork and
+ * join bookkeeping. If an instruction pauses the function, which can
+ * happen with a $stop, the call is turned into an ordinary call that
+ * the caller joins when the function finishes.
+ */
+static bool do_callf_leaf(vthread_t thr, vthread_t child)
+{
+      count_vthread_leaf_calls += 1;
+      child->parent = thr;
+      child->i_am_in_function = 1;
+      running_thread = child;
+
+      for (;;) {
+	    vvp_code_t cp = child->pc;
+	    if (cp->opcode == &of_END)
+		  break;
+
+	    child->pc += 1;
+	    if (! (cp->opcode)(child, cp)) {
+		  running_thread = thr;
+		  child->i_am_leaf_call = 0;
+		  scope_add_thread(child->parent_scope, child);
+		  thr->children.insert(child);
+		  thr->i_am_joining = 1;
+		  return false;
+	    }
+      }
+
+      running_thread = thr;
+      child->i_have_ended = 1;
+      child->pc = codespace_null();
+      pop_child_context(thr, child);
+
+      child->parent = 0;
+      if (child->delay_delete)
+	    schedule_del_thr(child);
+      else
+	    vthread_delete(child);
+
+      return true;
+}
+
 /*
  * %callf/void <code-label>, <scope-label>
  * Combine the %fork and %join steps for invoking a function.
@@ -1420,6 +1687,9 @@ static bool do_callf_void(vthread_t thr, vthread_t child)
 	    child->rd_context = thr->wt_context;
       }
 
+      if (child->i_am_leaf_call)
+	    return do_callf_leaf(thr, child);
+
         // Mark the function thread as a direct child of the current thread.
       child->parent = thr;
       thr->children.insert(child);
@@ -1445,7 +1715,7 @@ static bool do_callf_void(vthread_t thr, vthread_t child)
 
 bool of_CALLF_OBJ(vthread_t thr, vvp_code_t cp)
 {
-      vthread_t child = vthread_new(cp->cptr2, cp->scope);
+      vthread_t child = callf_thread_new(cp);
       return do_callf_void(thr, child);
 
       // XXXX NOT IMPLEMENTED
@@ -1453,7 +1723,7 @@ bool of_CALLF_OBJ(vthread_t thr, vvp_code_t cp)
 
 bool of_CALLF_REAL(vthread_t thr, vvp_code_t cp)
 {
-      vthread_t child = vthread_new(cp->cptr2, cp->scope);
+      vthread_t child = callf_thread_new(cp);
 
 	// This is the return value. Push a place-holder value. The function
 	// will replace this with the actual value using a %ret/real instruction.
@@ -1465,7 +1735,7 @@ bool of_CALLF_REAL(vthread_t thr, vvp_code_t cp)
 
 bool of_CALLF_STR(vthread_t thr, vvp_code_t cp)
 {
-      vthread_t child = vthread_new(cp->cptr2, cp->scope);
+      vthread_t child = callf_thread_new(cp);
 
       thr->push_str("");
       child->args_str.push_back(0);
@@ -1475,7 +1745,7 @@ bool of_CALLF_STR(vthread_t thr, vvp_code_t cp)
 
 bool of_CALLF_VEC4(vthread_t thr, vvp_code_t cp)
 {
-      vthread_t child = vthread_new(cp->cptr2, cp->scope);
+      vthread_t child = callf_thread_new(cp);
 
       vpiScopeFunction*scope_func = dynamic_cast<vpiScopeFunction*>(cp->scope);
       assert(scope_func);
@@ -1490,7 +1760,7 @@ bool of_CALLF_VEC4(vthread_t thr, vvp_code_t cp)
 
 bool of_CALLF_VOID(vthread_t thr, vvp_code_t cp)
 {
-      vthread_t child = vthread_new(cp->cptr2, cp->scope);
+      vthread_t child = callf_thread_new(cp);
       return do_callf_void(thr, child);
 }
 
@@ -1759,6 +2029,46 @@ static void do_CMPE(vthread_t thr, const vvp_vector4_t&lval, const vvp_vector4_t
       }
 }
 
+/*
+ * %clog2 <wid>
+ *
+ * Pop a vec4 value and push the ceiling of its base 2 logarithm as a
+ * <wid> bit value. The popped value is treated as unsigned, and an X
+ * or Z anywhere in it gives an all X result, as with $clog2.
+ */
+bool of_CLOG2(vthread_t thr, vvp_code_t cp)
+{
+      unsigned wid = cp->bit_idx[0];
+      vvp_vector4_t val = thr->pop_vec4();
+
+      if (val.has_xz()) {
+	    thr->push_vec4(vvp_vector4_t(wid, BIT4_X));
+	    return true;
+      }
+
+	// Find the most significant 1 bit. The result is its position,
+	// plus 1 if there are any other 1 bits, or 0 for 0 and 1.
+      unsigned msb = val.size();
+      while (msb > 0 && val.value(msb-1) == BIT4_0)
+	    msb -= 1;
+
+      unsigned long res = 0;
+      if (msb > 1) {
+	    res = msb - 1;
+	    for (unsigned idx = 0 ;  idx < msb-1 ;  idx += 1) {
+		  if (val.value(idx) == BIT4_1) {
+			res += 1;
+			break;
+		  }
+	    }
+      }
+
+      vvp_vector4_t tmp (wid, BIT4_0);
+      tmp.setarray(0, wid < 8*sizeof(res)? wid : 8*sizeof(res), &res);
+      thr->push_vec4(tmp);
+      return true;
+}
+
 /*
  *  %cmp/e
  *
@@ -2602,7 +2912,7 @@ static bool do_disable(vthread_t thr, vthread_t match)
       bool flag = false;
 
 	/* Pull the target thread out of its scope if needed. */
-      thr->parent_scope->threads.erase(thr);
+      scope_remove_thread(thr->parent_scope, thr);
 
 	/* Turn the thread off by setting is program counter to
 	   zero and setting an OFF bit. */
@@ -2662,10 +2972,8 @@ bool of_DISABLE(vthread_t thr, vvp_code_t cp)
 
       bool disabled_myself_flag = false;
 
-      while (! scope->threads.empty()) {
-	    set<vthread_t>::iterator cur = scope->threads.begin();
-
-	    if (do_disable(*cur, thr))
+      while (scope->threads) {
+	    if (do_disable(scope->threads, thr))
 		  disabled_myself_flag = true;
       }
 
@@ -3687,10 +3995,8 @@ bool of_JMP1XZ(vthread_t thr, vvp_code_t cp)
  * children know to wake me when they finish.
  */
 
-static void do_join(vthread_t thr, vthread_t child)
+static void pop_child_context(vthread_t thr, vthread_t child)
 {
-      assert(child->parent == thr);
-
         /* If the immediate child thread is in an automatic scope... */
       if (child->wt_context) {
               /* and is the top level task/function thread... */
@@ -3704,7 +4010,12 @@ static void do_join(vthread_t thr, vthread_t child)
                   thr->rd_context = child_context;
             }
       }
+}
 
+static void do_join(vthread_t thr, vthread_t child)
+{
+      assert(child->parent == thr);
+      pop_child_context(thr, child);
       vthread_reap(child);
 }
 
@@ -4864,6 +5175,28 @@ bool of_POW_WR(vthread_t thr, vvp_code_t)
       return true;
 }
 
+/*
+ * %product/dar <var-label>, <wid>
+ *
+ * Push the product of the elements of the dynamic array or queue as a
+ * <wid> bit vector. A nil array is empty, and has a product of 1.
+ */
+bool of_PRODUCT_DAR(vthread_t thr, vvp_code_t cp)
+{
+      unsigned wid = cp->bit_idx[0];
+
+      vvp_darray*darray = get_darray_object(cp->net);
+      if (darray) {
+	    thr->push_vec4(darray->product(wid));
+      } else {
+	    vvp_vector4_t val (wid, BIT4_0);
+	    val.set_bit(0, BIT4_1);
+	    thr->push_vec4(val);
+      }
+
+      return true;
+}
+
 /*
  * %prop/obj <pid>, <idx>
  *
@@ -5059,6 +5392,49 @@ bool of_PUSHI_VEC4(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+/*
+ * %pushtime/real <time-handle>
+ *
+ * Push the current time as $realtime does, scaled to the units of the
+ * scope bound to the handle at compile time.
+ */
+bool of_PUSHTIME_REAL(vthread_t thr, vvp_code_t cp)
+{
+      __vpiSystemTime*rfp = static_cast<__vpiSystemTime*>(cp->handle);
+      thr->push_real(vpip_time_to_scaled_real(schedule_simtime(), rfp->scope));
+      return true;
+}
+
+/*
+ * %pushtime/vec4 <time-handle>, <wid>
+ *
+ * Push the current time as $time, $stime or $simtime does. The handle
+ * is the one for the same name in the vpi_call argument list, and
+ * carries the scope whose units the time is rounded to. The result is
+ * the low <wid> bits of the scaled time.
+ */
+bool of_PUSHTIME_VEC4(vthread_t thr, vvp_code_t cp)
+{
+      __vpiSystemTime*rfp = static_cast<__vpiSystemTime*>(cp->handle);
+      unsigned wid = cp->bit_idx[0];
+      vvp_time64_t now = vpip_time_to_scaled_time(schedule_simtime(),
+                                                  rfp->scope);
+
+	// The time is 64 bits, which may be one or two unsigned longs.
+      unsigned long words[2];
+      words[0] = (unsigned long) now;
+      words[1] = 0;
+      if (sizeof(unsigned long) < 8) {
+	    words[0] = now & 0xffffffffUL;
+	    words[1] = now >> 32;
+      }
+
+      vvp_vector4_t val (wid, BIT4_0);
+      val.setarray(0, wid < 64? wid : 64, words);
+      thr->push_vec4(val);
+      return true;
+}
+
 /*
  * %pushv/str
  *   Pops a vec4 value, and pushes a string.
@@ -5596,6 +5972,20 @@ bool of_RETLOAD_VEC4(vthread_t thr, vvp_code_t cp)
       return retload<vvp_vector4_t>(thr, cp);
 }
 
+/*
+ * %reverse/dar <var-label>
+ *
+ * Reverse the order of the elements of the dynamic array or queue.
+ */
+bool of_REVERSE_DAR(vthread_t, vvp_code_t cp)
+{
+      vvp_darray*darray = get_darray_object(cp->net);
+      if (darray)
+	    darray->reverse();
+
+      return true;
+}
+
 bool of_SCOPY(vthread_t thr, vvp_code_t)
 {
       vvp_object_t tmp;
@@ -5755,6 +6145,24 @@ bool of_SHIFTR_S(vthread_t thr, vvp_code_t cp)
       return true;
 }
 
+/*
+ * %sort/dar <var-label>, <flags>
+ *
+ * Sort the elements of the dynamic array or queue in place. Bit 0 of
+ * the flags selects descending order (rsort) and bit 1 compares vector
+ * elements as signed values.
+ */
+bool of_SORT_DAR(vthread_t, vvp_code_t cp)
+{
+      unsigned flags = cp->bit_idx[0];
+
+      vvp_darray*darray = get_darray_object(cp->net);
+      if (darray)
+	    darray->sort(flags & 1, flags & 2);
+
+      return true;
+}
+
 /*
  * %split/vec4 <wid>
  *   Pop 1 value,
@@ -6464,6 +6872,28 @@ bool of_FILE_LINE(vthread_t thr, vvp_code_t cp)
 	    cerr << thr->get_fileline()
 	         << vpi_get_str(_vpiDescription, handle) << endl;
 
+      if (coverage_flag)
+	    vpip_count_file_line(handle);
+
+      return true;
+}
+
+/*
+ * %sum/dar <var-label>, <wid>
+ *
+ * Push the sum of the elements of the dynamic array or queue as a
+ * <wid> bit vector. A nil array is empty, and has a sum of 0.
+ */
+bool of_SUM_DAR(vthread_t thr, vvp_code_t cp)
+{
+      unsigned wid = cp->bit_idx[0];
+
+      vvp_darray*darray = get_darray_object(cp->net);
+      if (darray)
+	    thr->push_vec4(darray->sum(wid));
+      else
+	    thr->push_vec4(vvp_vector4_t(wid, BIT4_0));
+
       return true;
 }
 
@@ -6570,10 +7000,17 @@ bool of_WAIT(vthread_t thr, vvp_code_t cp)
       assert(! thr->waiting_for_event);
       thr->waiting_for_event = 1;
 
-	/* Add this thread to the list in the event. */
-      waitable_hooks_s*ep = dynamic_cast<waitable_hooks_s*> (cp->net->fun);
-      assert(ep);
-      thr->wait_next = ep->add_waiting_thread(thr);
+	/* Add this thread to the waiting threads of the event. The
+	   event is looked up the first time and then kept in the
+	   instruction, as an always block waits on the same event
+	   over and over. */
+      waitable_hooks_s*ep = cp->waitable;
+      if (ep == 0) {
+	    ep = dynamic_cast<waitable_hooks_s*> (cp->net->fun);
+	    assert(ep);
+	    cp->waitable = ep;
+      }
+      ep->add_waiting_thread(thr);
 
 	/* Return false to suspend this thread. */
       return false;
@@ -66,12 +66,12 @@ extern void vthread_delay_delete();
 extern void vthread_run(vthread_t thr);
 
 /*
- * This function schedules all the threads in the list to be scheduled
- * for execution with delay 0. The thr pointer is taken to be the head
- * of a list, and all the threads in the list are presumably placed in
- * the list by the %wait instruction.
+ * This function schedules all the threads in the array for execution
+ * with delay 0. The threads are presumably placed in the array by the
+ * %wait instruction. They are linked into a single list that is run
+ * by a single event, last waiting thread first.
  */
-extern void vthread_schedule_list(vthread_t thr);
+extern void vthread_schedule_list(vthread_t*list, unsigned count);
 
 extern __vpiScope*vthread_scope(vthread_t thr);
 
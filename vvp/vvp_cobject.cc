@@ -24,9 +24,34 @@
 
 using namespace std;
 
+/*
+ * The free list is threaded through the first word of the freed
+ * objects. All the objects are the same size, so any free block can
+ * be reused for a new object.
+ */
+static void*cobject_free_list = 0;
+
+void* vvp_cobject::operator new(size_t size)
+{
+      assert(size == sizeof(vvp_cobject));
+      if (void*ptr = cobject_free_list) {
+	    cobject_free_list = *reinterpret_cast<void**>(ptr);
+	    return ptr;
+      }
+      return ::operator new(size);
+}
+
+void vvp_cobject::operator delete(void*ptr)
+{
+      *reinterpret_cast<void**>(ptr) = cobject_free_list;
+      cobject_free_list = ptr;
+}
+
 vvp_cobject::vvp_cobject(const class_type*defn)
 : defn_(defn), properties_(defn->instance_new())
 {
+      if (defn_->has_object_properties())
+	    set_may_cycle();
 }
 
 vvp_cobject::~vvp_cobject()
@@ -75,6 +100,16 @@ void vvp_cobject::get_object(size_t pid, vvp_object_t&val, size_t idx)
       return defn_->get_object(properties_, pid, val, idx);
 }
 
+void vvp_cobject::get_references(vector<vvp_object*>&list) const
+{
+      defn_->get_object_references(properties_, list);
+}
+
+void vvp_cobject::clear_references(void)
+{
+      defn_->clear_object_references(properties_);
+}
+
 void vvp_cobject::shallow_copy(const vvp_object*obj)
 {
       const vvp_cobject*that = dynamic_cast<const vvp_cobject*>(obj);
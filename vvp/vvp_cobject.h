@@ -46,6 +46,15 @@ class vvp_cobject : public vvp_object {
 
       void shallow_copy(const vvp_object*that);
 
+	// Class objects are created and destroyed often, so the
+	// memory for them is kept on a free list and reused.
+      static void* operator new(std::size_t size);
+      static void operator delete(void*ptr);
+
+    protected:
+      void get_references(std::vector<vvp_object*>&list) const;
+      void clear_references(void);
+
     private:
       const class_type* defn_;
 	// For now, only support 32bit bool signed properties.
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+/*
+ * The vvp-cov program merges the coverage databases written by vvp
+ * -coverage runs and reports on the result. For example:
+ *
+ *    vvp-cov -o all.cov run1.cov run2.cov run3.cov
+ *
+ * merges three runs into all.cov and prints a summary of the merged
+ * coverage. The -l flag adds a list of the statements that were never
+ * hit and the nets that never fully toggled.
+ */
+
+# include  "config.h"
+# include  "coverage_db.h"
+# include  <cstdio>
+# include  <cstdlib>
+# include  <unistd.h>
+
+#if defined(HAVE_GETOPT_H)
+# include  <getopt.h>
+#endif
+
+#if defined(__MINGW32__) && !defined(HAVE_GETOPT_H)
+extern "C" int getopt(int argc, char*argv[], const char*fmt);
+extern "C" int optind;
+extern "C" const char*optarg;
+#endif
+
+static void usage(const char*name)
+{
+      fprintf(stderr, "Usage: %s [-l] [-q] [-o <output>] <database>...\n"
+	      "   -l           List the statements not hit and the nets\n"
+	      "                not fully toggled.\n"
+	      "   -o <output>  Write the merged database to <output>.\n"
+	      "   -q           Do not print the coverage report.\n",
+	      name);
+}
+
+int main(int argc, char*argv[])
+{
+      const char*output = 0;
+      bool list_missing = false;
+      bool quiet = false;
+
+      int opt;
+      while ((opt = getopt(argc, argv, "hlo:q")) != EOF) switch (opt) {
+	  case 'l':
+	    list_missing = true;
+	    break;
+	  case 'o':
+	    output = optarg;
+	    break;
+	  case 'q':
+	    quiet = true;
+	    break;
+	  case 'h':
+	    usage(argv[0]);
+	    return 0;
+	  default:
+	    usage(argv[0]);
+	    return 1;
+      }
+
+      if (optind == argc) {
+	    usage(argv[0]);
+	    return 1;
+      }
+
+      coverage_db db;
+      int rc = 0;
+      for (int idx = optind ;  idx < argc ;  idx += 1) {
+	    if (! db.read(argv[idx]))
+		  rc = 1;
+      }
+
+	// Do not write a merged database that is missing some runs.
+      if (output && rc == 0 && ! db.write(output))
+	    rc = 1;
+
+      if (! quiet)
+	    db.report(stdout, list_missing);
+
+      return rc;
+}
@@ -18,11 +18,376 @@
  */
 
 # include  "vvp_darray.h"
+# include  <algorithm>
+# include  <functional>
 # include  <iostream>
 # include  <typeinfo>
 
 using namespace std;
 
+/*
+ * Sort a container of numbers or strings by their natural order.
+ */
+template <class CONT> static void sort_elements(CONT&array, bool descending)
+{
+      typedef typename CONT::value_type ELEM;
+      if (descending)
+	    std::sort(array.begin(), array.end(), greater<ELEM>());
+      else
+	    std::sort(array.begin(), array.end());
+}
+
+/*
+ * Order vec4 values as unsigned or signed numbers. An X or Z bit
+ * orders after a 1 bit. That choice is arbitrary, but it keeps this a
+ * strict weak ordering so values with X or Z bits can still be sorted.
+ */
+struct vec4_less {
+      explicit vec4_less(bool flag) : signed_flag(flag) { }
+      bool operator() (const vvp_vector4_t&a, const vvp_vector4_t&b) const;
+      bool signed_flag;
+};
+
+bool vec4_less::operator() (const vvp_vector4_t&a, const vvp_vector4_t&b) const
+{
+      assert(a.size() == b.size());
+      unsigned idx = a.size();
+      while (idx > 0) {
+	    idx -= 1;
+	    vvp_bit4_t abit = a.value(idx);
+	    vvp_bit4_t bbit = b.value(idx);
+	    if (abit == bbit)
+		  continue;
+	      // A set sign bit makes a signed value the smaller one.
+	    if (signed_flag && (idx+1 == a.size()))
+		  return abit > bbit;
+	    return abit < bbit;
+      }
+      return false;
+}
+
+static const unsigned PACKED_BPW = 8*sizeof(unsigned long);
+
+vvp_packed_vectors::vvp_packed_vectors(bool two_state, unsigned wid, size_t count)
+: two_state_(two_state), wid_(wid)
+{
+      words_ = wid_ > PACKED_BPW? (wid_ + PACKED_BPW - 1) / PACKED_BPW : 1;
+      stride_ = two_state_? words_ : 2*words_;
+
+	// New elements are X in four state storage and 0 in two state
+	// storage, and all ones is the X encoding.
+      buf_.assign(count * stride_, two_state_? 0UL : ~0UL);
+      cap_ = count;
+      head_ = 0;
+      count_ = count;
+}
+
+unsigned long* vvp_packed_vectors::cell_(size_t idx)
+{
+      size_t slot = head_ + idx;
+      if (slot >= cap_) slot -= cap_;
+      return &buf_[slot * stride_];
+}
+
+const unsigned long* vvp_packed_vectors::cell_(size_t idx) const
+{
+      size_t slot = head_ + idx;
+      if (slot >= cap_) slot -= cap_;
+      return &buf_[slot * stride_];
+}
+
+void vvp_packed_vectors::move_(size_t dst, size_t src)
+{
+      const unsigned long*from = cell_(src);
+      copy(from, from + stride_, cell_(dst));
+}
+
+/*
+ * Double the capacity of the ring. The elements are copied out in
+ * order, so the head of the new ring is at the start of the buffer.
+ */
+void vvp_packed_vectors::grow_(void)
+{
+      size_t new_cap = cap_ < 8? 16 : 2*cap_;
+      vector<unsigned long> new_buf (new_cap * stride_);
+      for (size_t idx = 0 ; idx < count_ ; idx += 1) {
+	    const unsigned long*from = cell_(idx);
+	    copy(from, from + stride_, &new_buf[idx * stride_]);
+      }
+      buf_.swap(new_buf);
+      cap_ = new_cap;
+      head_ = 0;
+}
+
+/*
+ * A queue does not know the width of its elements until one is
+ * stored. A value of another width stored later is resized by set().
+ */
+void vvp_packed_vectors::check_width_(const vvp_vector4_t&value)
+{
+      if (value.size() == wid_ || count_ != 0)
+	    return;
+
+      buf_.clear();
+      cap_ = 0;
+      head_ = 0;
+      wid_ = value.size();
+      words_ = wid_ > PACKED_BPW? (wid_ + PACKED_BPW - 1) / PACKED_BPW : 1;
+      stride_ = two_state_? words_ : 2*words_;
+}
+
+void vvp_packed_vectors::get(size_t idx, vvp_vector4_t&value) const
+{
+      assert(idx < count_);
+      if (value.size_ != wid_)
+	    value = vvp_vector4_t(wid_, BIT4_X);
+      if (wid_ == 0)
+	    return;
+
+      const unsigned long*cell = cell_(idx);
+      if (wid_ <= PACKED_BPW) {
+	    value.abits_val_ = cell[0];
+	    value.bbits_val_ = two_state_? 0 : cell[1];
+      } else {
+	    copy(cell, cell + words_, value.abits_ptr_);
+	    if (two_state_)
+		  fill(value.bbits_ptr_, value.bbits_ptr_ + words_, 0UL);
+	    else
+		  copy(cell + words_, cell + 2*words_, value.bbits_ptr_);
+      }
+}
+
+void vvp_packed_vectors::set(size_t idx, const vvp_vector4_t&value)
+{
+      assert(idx < count_);
+      if (value.size() != wid_) {
+	    vvp_vector4_t tmp (value);
+	    tmp.resize(wid_);
+	    set(idx, tmp);
+	    return;
+      }
+      if (wid_ == 0)
+	    return;
+
+      const unsigned long*abits;
+      const unsigned long*bbits;
+      if (wid_ <= PACKED_BPW) {
+	    abits = &value.abits_val_;
+	    bbits = &value.bbits_val_;
+      } else {
+	    abits = value.abits_ptr_;
+	    bbits = value.bbits_ptr_;
+      }
+
+      unsigned long*cell = cell_(idx);
+      for (unsigned wdx = 0 ; wdx < words_ ; wdx += 1) {
+	    if (two_state_) {
+		    // X and Z bits are stored as 0.
+		  cell[wdx] = abits[wdx] & ~bbits[wdx];
+	    } else {
+		  cell[wdx] = abits[wdx];
+		  cell[words_+wdx] = bbits[wdx];
+	    }
+      }
+
+	// Keep the unused bits of the top word clear so that the words
+	// can be compared directly.
+      unsigned tail = wid_ % PACKED_BPW;
+      if (tail != 0) {
+	    unsigned long mask = (1UL << tail) - 1;
+	    cell[words_-1] &= mask;
+	    if (! two_state_)
+		  cell[2*words_-1] &= mask;
+      }
+}
+
+void vvp_packed_vectors::push_back(const vvp_vector4_t&value)
+{
+      check_width_(value);
+      if (count_ == cap_)
+	    grow_();
+      count_ += 1;
+      set(count_-1, value);
+}
+
+void vvp_packed_vectors::push_front(const vvp_vector4_t&value)
+{
+      check_width_(value);
+      if (count_ == cap_)
+	    grow_();
+      head_ = head_ == 0? cap_-1 : head_-1;
+      count_ += 1;
+      set(0, value);
+}
+
+void vvp_packed_vectors::pop_back(void)
+{
+      assert(count_ > 0);
+      count_ -= 1;
+}
+
+void vvp_packed_vectors::pop_front(void)
+{
+      assert(count_ > 0);
+      head_ += 1;
+      if (head_ == cap_) head_ = 0;
+      count_ -= 1;
+}
+
+/*
+ * Insert and erase shift the elements between idx and the nearer end
+ * of the sequence.
+ */
+void vvp_packed_vectors::insert(size_t idx, const vvp_vector4_t&value)
+{
+      assert(idx <= count_);
+      check_width_(value);
+      if (count_ == cap_)
+	    grow_();
+
+      if (idx < count_/2) {
+	    head_ = head_ == 0? cap_-1 : head_-1;
+	    count_ += 1;
+	    for (size_t cur = 0 ; cur < idx ; cur += 1)
+		  move_(cur, cur+1);
+      } else {
+	    count_ += 1;
+	    for (size_t cur = count_-1 ; cur > idx ; cur -= 1)
+		  move_(cur, cur-1);
+      }
+      set(idx, value);
+}
+
+void vvp_packed_vectors::erase(size_t idx)
+{
+      assert(idx < count_);
+      if (idx < count_/2) {
+	    for (size_t cur = idx ; cur > 0 ; cur -= 1)
+		  move_(cur, cur-1);
+	    pop_front();
+      } else {
+	    for (size_t cur = idx ; cur+1 < count_ ; cur += 1)
+		  move_(cur, cur+1);
+	    pop_back();
+      }
+}
+
+void vvp_packed_vectors::truncate(size_t count)
+{
+      assert(count <= count_);
+      count_ = count;
+}
+
+void vvp_packed_vectors::copy_from(const vvp_packed_vectors&that, size_t count)
+{
+      assert(count <= count_ && count <= that.count_);
+      assert(wid_ == that.wid_ && two_state_ == that.two_state_);
+      for (size_t idx = 0 ; idx < count ; idx += 1) {
+	    const unsigned long*from = that.cell_(idx);
+	    copy(from, from + stride_, cell_(idx));
+      }
+}
+
+void vvp_packed_vectors::reverse(void)
+{
+      if (count_ < 2)
+	    return;
+      for (size_t lo = 0, hi = count_-1 ; lo < hi ; lo += 1, hi -= 1) {
+	    unsigned long*lcell = cell_(lo);
+	    swap_ranges(lcell, lcell + stride_, cell_(hi));
+      }
+}
+
+/*
+ * When the elements fit in a word and have no X or Z bits, as is
+ * usual, they are sorted as integer keys instead of bit by bit.
+ * Flipping the sign bit makes the unsigned order of the keys match
+ * the signed order of the values.
+ */
+void vvp_packed_vectors::sort(bool descending, bool signed_flag)
+{
+      if (count_ < 2 || wid_ == 0)
+	    return;
+
+      if (wid_ <= PACKED_BPW) {
+	    unsigned long sign = signed_flag? 1UL << (wid_-1) : 0;
+	    vector<unsigned long> keys (count_);
+	    size_t idx;
+	    for (idx = 0 ; idx < count_ ; idx += 1) {
+		  const unsigned long*cell = cell_(idx);
+		  if (! two_state_ && cell[1] != 0)
+			break;
+		  keys[idx] = cell[0] ^ sign;
+	    }
+
+	    if (idx == count_) {
+		  sort_elements(keys, descending);
+		  for (idx = 0 ; idx < count_ ; idx += 1) {
+			unsigned long*cell = cell_(idx);
+			cell[0] = keys[idx] ^ sign;
+		  }
+		  return;
+	    }
+      }
+
+      vector<vvp_vector4_t> values (count_);
+      for (size_t idx = 0 ; idx < count_ ; idx += 1)
+	    get(idx, values[idx]);
+
+      std::sort(values.begin(), values.end(), vec4_less(signed_flag));
+      if (descending)
+	    std::reverse(values.begin(), values.end());
+
+      for (size_t idx = 0 ; idx < count_ ; idx += 1)
+	    set(idx, values[idx]);
+}
+
+/*
+ * The sum() and product() methods. Values that fit in an unsigned
+ * long accumulate in one, and wider values use vvp_vector2_t
+ * arithmetic. Either way the result wraps at <wid> bits.
+ */
+static vvp_vector4_t reduce_elements(vvp_darray*array, unsigned wid,
+                                     bool product)
+{
+      size_t count = array->get_size();
+      vvp_vector4_t word;
+
+      if (wid <= 8*sizeof(unsigned long)) {
+	    unsigned long acc = product? 1 : 0;
+	    for (size_t idx = 0 ; idx < count ; idx += 1) {
+		  unsigned long val;
+		  array->get_word(idx, word);
+		  if (! word.get_ulong(val))
+			return vvp_vector4_t(wid, BIT4_X);
+		  if (product)
+			acc *= val;
+		  else
+			acc += val;
+	    }
+
+	    vvp_vector4_t res (wid, BIT4_0);
+	    res.setarray(0, wid, &acc);
+	    return res;
+      }
+
+      vvp_vector2_t acc (product? 1 : 0, wid);
+      for (size_t idx = 0 ; idx < count ; idx += 1) {
+	    array->get_word(idx, word);
+	    if (word.has_xz())
+		  return vvp_vector4_t(wid, BIT4_X);
+	    if (word.size() != wid)
+		  word.resize(wid, BIT4_0);
+	    vvp_vector2_t val (word);
+	    if (product)
+		  acc = acc * val;
+	    else
+		  acc += val;
+      }
+
+      return vector2_to_vector4(acc, wid);
+}
+
 vvp_darray::~vvp_darray()
 {
 }
@@ -78,6 +443,26 @@ vvp_vector4_t vvp_darray::get_bitstream(bool)
       return vvp_vector4_t();
 }
 
+void vvp_darray::sort(bool, bool)
+{
+      cerr << "XXXX sort() not implemented for " << typeid(*this).name() << endl;
+}
+
+void vvp_darray::reverse(void)
+{
+      cerr << "XXXX reverse() not implemented for " << typeid(*this).name() << endl;
+}
+
+vvp_vector4_t vvp_darray::sum(unsigned wid)
+{
+      return reduce_elements(this, wid, false);
+}
+
+vvp_vector4_t vvp_darray::product(unsigned wid)
+{
+      return reduce_elements(this, wid, true);
+}
+
 template <class TYPE> vvp_darray_atom<TYPE>::~vvp_darray_atom()
 {
 }
@@ -143,6 +528,48 @@ template <class TYPE> vvp_vector4_t vvp_darray_atom<TYPE>::get_bitstream(bool)
       return vec;
 }
 
+template <class TYPE> void vvp_darray_atom<TYPE>::sort(bool descending, bool)
+{
+      sort_elements(array_, descending);
+}
+
+template <class TYPE> void vvp_darray_atom<TYPE>::reverse(void)
+{
+      std::reverse(array_.begin(), array_.end());
+}
+
+/*
+ * The atom types are at most 64 bits, so they can accumulate directly
+ * in an unsigned long unless that is narrower.
+ */
+template <class TYPE> vvp_vector4_t vvp_darray_atom<TYPE>::sum(unsigned wid)
+{
+      if (sizeof(TYPE) > sizeof(unsigned long))
+	    return vvp_darray::sum(wid);
+
+      unsigned long acc = 0;
+      for (size_t idx = 0 ; idx < array_.size() ; idx += 1)
+	    acc += (unsigned long) array_[idx];
+
+      vvp_vector4_t res (wid, BIT4_0);
+      res.setarray(0, min(wid, (unsigned) (8*sizeof(acc))), &acc);
+      return res;
+}
+
+template <class TYPE> vvp_vector4_t vvp_darray_atom<TYPE>::product(unsigned wid)
+{
+      if (sizeof(TYPE) > sizeof(unsigned long))
+	    return vvp_darray::product(wid);
+
+      unsigned long acc = 1;
+      for (size_t idx = 0 ; idx < array_.size() ; idx += 1)
+	    acc *= (unsigned long) array_[idx];
+
+      vvp_vector4_t res (wid, BIT4_0);
+      res.setarray(0, min(wid, (unsigned) (8*sizeof(acc))), &acc);
+      return res;
+}
+
 template class vvp_darray_atom<uint8_t>;
 template class vvp_darray_atom<uint16_t>;
 template class vvp_darray_atom<uint32_t>;
@@ -165,21 +592,20 @@ void vvp_darray_vec4::set_word(unsigned adr, const vvp_vector4_t&value)
 {
       if (adr >= array_.size()) return;
       assert(value.size() == word_wid_);
-      array_[adr] = value;
+      array_.set(adr, value);
 }
 
 void vvp_darray_vec4::get_word(unsigned adr, vvp_vector4_t&value)
 {
 	/*
-	 * Return an undefined value for an out of range address or if the
-	 * value has not been written yet (has a size of zero).
+	 * Return an undefined value for an out of range address. Words
+	 * that have not been written yet are undefined in the array.
 	 */
-      if ((adr >= array_.size()) || (array_[adr].size() == 0)) {
+      if (adr >= array_.size()) {
 	    value = vvp_vector4_t(word_wid_, BIT4_X);
 	    return;
       }
-      value = array_[adr];
-      assert(value.size() == word_wid_);
+      array_.get(adr, value);
 }
 
 void vvp_darray_vec4::shallow_copy(const vvp_object*obj)
@@ -187,23 +613,27 @@ void vvp_darray_vec4::shallow_copy(const vvp_object*obj)
       const vvp_darray_vec4*that = dynamic_cast<const vvp_darray_vec4*>(obj);
       assert(that);
 
-      unsigned num_items = min(array_.size(), that->array_.size());
-      for (unsigned idx = 0 ; idx < num_items ; idx += 1)
-	    array_[idx] = that->array_[idx];
+      size_t num_items = min(array_.size(), that->array_.size());
+      array_.copy_from(that->array_, num_items);
 }
 
 vvp_vector4_t vvp_darray_vec4::get_bitstream(bool as_vec4)
 {
       vvp_vector4_t vec(array_.size() * word_wid_, BIT4_0);
+      vvp_vector4_t word;
 
       unsigned adx = 0;
       unsigned vdx = vec.size();
       while (vdx > 0) {
             vdx -= word_wid_;
-            for (unsigned bdx = 0; bdx < word_wid_; bdx += 1) {
-                  vvp_bit4_t bit = array_[adx].value(bdx);
-                  if (as_vec4 || (bit == BIT4_1))
-                        vec.set_bit(vdx+bdx, bit);
+            array_.get(adx, word);
+            if (as_vec4) {
+                  vec.set_vec(vdx, word);
+            } else {
+                  for (unsigned bdx = 0; bdx < word_wid_; bdx += 1) {
+                        if (word.value(bdx) == BIT4_1)
+                              vec.set_bit(vdx+bdx, BIT4_1);
+                  }
             }
             adx++;
       }
@@ -211,6 +641,16 @@ vvp_vector4_t vvp_darray_vec4::get_bitstream(bool as_vec4)
       return vec;
 }
 
+void vvp_darray_vec4::sort(bool descending, bool signed_flag)
+{
+      array_.sort(descending, signed_flag);
+}
+
+void vvp_darray_vec4::reverse(void)
+{
+      array_.reverse();
+}
+
 vvp_darray_vec2::~vvp_darray_vec2()
 {
 }
@@ -224,24 +664,20 @@ void vvp_darray_vec2::set_word(unsigned adr, const vvp_vector4_t&value)
 {
       if (adr >= array_.size()) return;
       assert(value.size() == word_wid_);
-      array_[adr] = value;
+      array_.set(adr, value);
 }
 
 void vvp_darray_vec2::get_word(unsigned adr, vvp_vector4_t&value)
 {
 	/*
-	 * Return a zero value for an out of range address or if the
-	 * value has not been written yet (has a size of zero).
+	 * Return a zero value for an out of range address. Words that
+	 * have not been written yet are zero in the array.
 	 */
-      if ((adr >= array_.size()) || (array_[adr].size() == 0)) {
+      if (adr >= array_.size()) {
 	    value = vvp_vector4_t(word_wid_, BIT4_0);
 	    return;
       }
-      assert(array_[adr].size() == word_wid_);
-      value.resize(word_wid_);
-      for (unsigned idx = 0; idx < word_wid_; idx += 1) {
-	    value.set_bit(idx, array_[adr].value4(idx));
-      }
+      array_.get(adr, value);
 }
 
 void vvp_darray_vec2::shallow_copy(const vvp_object*obj)
@@ -249,29 +685,37 @@ void vvp_darray_vec2::shallow_copy(const vvp_object*obj)
       const vvp_darray_vec2*that = dynamic_cast<const vvp_darray_vec2*>(obj);
       assert(that);
 
-      unsigned num_items = min(array_.size(), that->array_.size());
-      for (unsigned idx = 0 ; idx < num_items ; idx += 1)
-	    array_[idx] = that->array_[idx];
+      size_t num_items = min(array_.size(), that->array_.size());
+      array_.copy_from(that->array_, num_items);
 }
 
 vvp_vector4_t vvp_darray_vec2::get_bitstream(bool)
 {
       vvp_vector4_t vec(array_.size() * word_wid_, BIT4_0);
+      vvp_vector4_t word;
 
       unsigned adx = 0;
       unsigned vdx = vec.size();
       while (vdx > 0) {
             vdx -= word_wid_;
-            for (unsigned bdx = 0; bdx < word_wid_; bdx += 1) {
-                  if (array_[adx].value(bdx))
-                        vec.set_bit(vdx+bdx, BIT4_1);
-            }
+            array_.get(adx, word);
+            vec.set_vec(vdx, word);
             adx++;
       }
 
       return vec;
 }
 
+void vvp_darray_vec2::sort(bool descending, bool signed_flag)
+{
+      array_.sort(descending, signed_flag);
+}
+
+void vvp_darray_vec2::reverse(void)
+{
+      array_.reverse();
+}
+
 vvp_darray_object::~vvp_darray_object()
 {
 }
@@ -308,6 +752,25 @@ void vvp_darray_object::shallow_copy(const vvp_object*obj)
 	    array_[idx] = that->array_[idx];
 }
 
+void vvp_darray_object::reverse(void)
+{
+      std::reverse(array_.begin(), array_.end());
+}
+
+void vvp_darray_object::get_references(vector<vvp_object*>&list) const
+{
+      for (size_t idx = 0 ; idx < array_.size() ; idx += 1) {
+	    if (vvp_object*tmp = array_[idx].peek<vvp_object>())
+		  list.push_back(tmp);
+      }
+}
+
+void vvp_darray_object::clear_references(void)
+{
+      for (size_t idx = 0 ; idx < array_.size() ; idx += 1)
+	    array_[idx].reset();
+}
+
 vvp_darray_real::~vvp_darray_real()
 {
 }
@@ -370,6 +833,16 @@ vvp_vector4_t vvp_darray_real::get_bitstream(bool)
       return vec;
 }
 
+void vvp_darray_real::sort(bool descending, bool)
+{
+      sort_elements(array_, descending);
+}
+
+void vvp_darray_real::reverse(void)
+{
+      std::reverse(array_.begin(), array_.end());
+}
+
 vvp_darray_string::~vvp_darray_string()
 {
 }
@@ -406,6 +879,16 @@ void vvp_darray_string::shallow_copy(const vvp_object*obj)
 	    array_[idx] = that->array_[idx];
 }
 
+void vvp_darray_string::sort(bool descending, bool)
+{
+      sort_elements(array_, descending);
+}
+
+void vvp_darray_string::reverse(void)
+{
+      std::reverse(array_.begin(), array_.end());
+}
+
 vvp_queue::~vvp_queue()
 {
 }
@@ -655,6 +1138,16 @@ void vvp_queue_real::erase_tail(unsigned idx)
 	    queue.resize(idx);
 }
 
+void vvp_queue_real::sort(bool descending, bool)
+{
+      sort_elements(queue, descending);
+}
+
+void vvp_queue_real::reverse(void)
+{
+      std::reverse(queue.begin(), queue.end());
+}
+
 vvp_queue_string::~vvp_queue_string()
 {
 }
@@ -791,6 +1284,16 @@ void vvp_queue_string::erase_tail(unsigned idx)
 	    queue.resize(idx);
 }
 
+void vvp_queue_string::sort(bool descending, bool)
+{
+      sort_elements(queue, descending);
+}
+
+void vvp_queue_string::reverse(void)
+{
+      std::reverse(queue.begin(), queue.end());
+}
+
 vvp_queue_vec4::~vvp_queue_vec4()
 {
 }
@@ -822,7 +1325,7 @@ void vvp_queue_vec4::set_word_max(unsigned adr, const vvp_vector4_t&value, unsig
 void vvp_queue_vec4::set_word(unsigned adr, const vvp_vector4_t&value)
 {
       if (adr < queue.size())
-	    queue[adr] = value;
+	    queue.set(adr, value);
       else
 	    cerr << get_fileline()
 	         << "Warning: assigning to queue<vector>[" << adr << "] is outside "
@@ -833,9 +1336,9 @@ void vvp_queue_vec4::set_word(unsigned adr, const vvp_vector4_t&value)
 void vvp_queue_vec4::get_word(unsigned adr, vvp_vector4_t&value)
 {
       if (adr >= queue.size())
-	    value = vvp_vector4_t(queue[0].size());
+	    value = vvp_vector4_t(queue.width());
       else
-	    value = queue[adr];
+	    queue.get(adr, value);
 }
 
 void vvp_queue_vec4::insert(unsigned idx, const vvp_vector4_t&value, unsigned max_size)
@@ -857,28 +1360,15 @@ void vvp_queue_vec4::insert(unsigned idx, const vvp_vector4_t&value, unsigned ma
 		       << "). " << value << " was not added." << endl;
       else  {
 	    if (max_size && (queue.size() == max_size)) {
+		  vvp_vector4_t back;
+		  queue.get(queue.size()-1, back);
 		  cerr << get_fileline()
 		       << "Warning: insert("<< idx << ", " << value << ") removed "
-		       << queue.back() << " from already full bounded queue<vector["
+		       << back << " from already full bounded queue<vector["
 		       << value.size() << "]> [" << max_size << "]." << endl;
 		  queue.pop_back();
 	    }
-	      // Inserting at the beginning
-	    if (idx == 0)
-		  queue.push_front(value);
-	      // Inserting in the middle
-	    else {
-		  std::deque<vvp_vector4_t>::iterator pos;
-		  unsigned middle = queue.size()/2;
-		  if (idx < middle) {
-			pos = queue.begin();
-			for (unsigned count = 0; count < idx; ++count) ++pos;
-		  } else {
-			pos = queue.end();
-			for (unsigned count = queue.size(); count > idx; --count) --pos;
-		  }
-		  queue.insert(pos, value);
-	    }
+	    queue.insert(idx, value);
       }
 }
 
@@ -896,9 +1386,11 @@ void vvp_queue_vec4::push_back(const vvp_vector4_t&value, unsigned max_size)
 void vvp_queue_vec4::push_front(const vvp_vector4_t&value, unsigned max_size)
 {
       if (max_size && (queue.size() == max_size)) {
+	    vvp_vector4_t back;
+	    queue.get(queue.size()-1, back);
 	    cerr << get_fileline()
 	         << "Warning: push_front(" << value << ") removed "
-	         << queue.back() << " from already full bounded queue<vector["
+	         << back << " from already full bounded queue<vector["
 	         << value.size() << "]> [" << max_size << "]." << endl;
 	    queue.pop_back();
       }
@@ -907,22 +1399,21 @@ void vvp_queue_vec4::push_front(const vvp_vector4_t&value, unsigned max_size)
 
 void vvp_queue_vec4::erase(unsigned idx)
 {
-      std::deque<vvp_vector4_t>::iterator pos;
-      unsigned middle = queue.size()/2;
-      if (idx < middle) {
-	    pos = queue.begin();
-	    for (unsigned count = 0; count < idx; ++count) ++pos;
-      } else {
-	    pos = queue.end();
-	    for (unsigned count = queue.size(); count > idx; --count) --pos;
-      }
-
-      queue.erase(pos);
+      queue.erase(idx);
 }
 
 void vvp_queue_vec4::erase_tail(unsigned idx)
 {
       assert(queue.size() >= idx);
-      if (queue.size() > idx)
-	    queue.resize(idx);
+      queue.truncate(idx);
+}
+
+void vvp_queue_vec4::sort(bool descending, bool signed_flag)
+{
+      queue.sort(descending, signed_flag);
+}
+
+void vvp_queue_vec4::reverse(void)
+{
+      queue.reverse();
 }
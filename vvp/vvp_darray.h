@@ -48,6 +48,74 @@ class vvp_darray : public vvp_object {
       virtual void shallow_copy(const vvp_object*obj);
 
       virtual vvp_vector4_t get_bitstream(bool as_vec4);
+
+	// The sort(), rsort() and reverse() array methods. Vector
+	// elements do not carry their signedness, so sort() is told
+	// how to compare them.
+      virtual void sort(bool descending, bool signed_flag);
+      virtual void reverse(void);
+
+	// The sum() and product() array methods for integral elements.
+	// The result is <wid> bits, or all X if any element has X or Z
+	// bits. The default works through get_word().
+      virtual vvp_vector4_t sum(unsigned wid);
+      virtual vvp_vector4_t product(unsigned wid);
+};
+
+/*
+ * Packed storage for a sequence of vectors that all have the same
+ * width. Each element is a fixed run of words in one buffer: the abits
+ * words and, unless the storage is two state, the bbits words, in the
+ * vvp_vector4_t encoding. The buffer is used as a ring so that queues
+ * can add and remove elements at either end in amortized constant
+ * time. The width of a queue is not known when it is created, so it
+ * may be left as zero until the first element is stored.
+ */
+class vvp_packed_vectors {
+
+    public:
+      explicit vvp_packed_vectors(bool two_state, unsigned wid =0,
+                                  size_t count =0);
+
+      size_t size() const { return count_; }
+      unsigned width() const { return wid_; }
+
+      void get(size_t idx, vvp_vector4_t&value) const;
+      void set(size_t idx, const vvp_vector4_t&value);
+
+      void push_back(const vvp_vector4_t&value);
+      void push_front(const vvp_vector4_t&value);
+      void pop_back(void);
+      void pop_front(void);
+      void insert(size_t idx, const vvp_vector4_t&value);
+      void erase(size_t idx);
+      void truncate(size_t count);
+
+	// Copy the first count elements of that, which has the same
+	// width, over the first count elements of this.
+      void copy_from(const vvp_packed_vectors&that, size_t count);
+
+      void reverse(void);
+      void sort(bool descending, bool signed_flag);
+
+    private:
+      unsigned long*cell_(size_t idx);
+      const unsigned long*cell_(size_t idx) const;
+      void move_(size_t dst, size_t src);
+      void grow_(void);
+      void check_width_(const vvp_vector4_t&value);
+
+      bool two_state_;
+      unsigned wid_;
+	// The number of abits (or bbits) words per element, and the
+	// total number of words per element.
+      unsigned words_;
+      unsigned stride_;
+
+      std::vector<unsigned long> buf_;
+      size_t cap_;
+      size_t head_;
+      size_t count_;
 };
 
 template <class TYPE> class vvp_darray_atom : public vvp_darray {
@@ -61,6 +129,10 @@ template <class TYPE> class vvp_darray_atom : public vvp_darray {
       void get_word(unsigned adr, vvp_vector4_t&value);
       void shallow_copy(const vvp_object*obj);
       vvp_vector4_t get_bitstream(bool as_vec4);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
+      vvp_vector4_t sum(unsigned wid);
+      vvp_vector4_t product(unsigned wid);
 
     private:
       std::vector<TYPE> array_;
@@ -70,7 +142,7 @@ class vvp_darray_vec4 : public vvp_darray {
 
     public:
       inline vvp_darray_vec4(size_t siz, unsigned word_wid) :
-                             array_(siz), word_wid_(word_wid) { }
+                             array_(false, word_wid, siz), word_wid_(word_wid) { }
       ~vvp_darray_vec4();
 
       size_t get_size(void) const;
@@ -78,9 +150,11 @@ class vvp_darray_vec4 : public vvp_darray {
       void get_word(unsigned adr, vvp_vector4_t&value);
       void shallow_copy(const vvp_object*obj);
       vvp_vector4_t get_bitstream(bool as_vec4);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
-      std::vector<vvp_vector4_t> array_;
+      vvp_packed_vectors array_;
       unsigned word_wid_;
 };
 
@@ -88,7 +162,7 @@ class vvp_darray_vec2 : public vvp_darray {
 
     public:
       inline vvp_darray_vec2(size_t siz, unsigned word_wid) :
-                             array_(siz), word_wid_(word_wid) { }
+                             array_(true, word_wid, siz), word_wid_(word_wid) { }
       ~vvp_darray_vec2();
 
       size_t get_size(void) const;
@@ -96,9 +170,11 @@ class vvp_darray_vec2 : public vvp_darray {
       void get_word(unsigned adr, vvp_vector4_t&value);
       void shallow_copy(const vvp_object*obj);
       vvp_vector4_t get_bitstream(bool as_vec4);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
-      std::vector<vvp_vector2_t> array_;
+      vvp_packed_vectors array_;
       unsigned word_wid_;
 };
 
@@ -113,6 +189,8 @@ class vvp_darray_real : public vvp_darray {
       void get_word(unsigned adr, double&value);
       void shallow_copy(const vvp_object*obj);
       vvp_vector4_t get_bitstream(bool as_vec4);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
       std::vector<double> array_;
@@ -128,6 +206,8 @@ class vvp_darray_string : public vvp_darray {
       void set_word(unsigned adr, const std::string&value);
       void get_word(unsigned adr, std::string&value);
       void shallow_copy(const vvp_object*obj);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
       std::vector<std::string> array_;
@@ -136,13 +216,19 @@ class vvp_darray_string : public vvp_darray {
 class vvp_darray_object : public vvp_darray {
 
     public:
-      explicit inline vvp_darray_object(size_t siz) : array_(siz) { }
+      explicit inline vvp_darray_object(size_t siz) : array_(siz)
+      { set_may_cycle(); }
       ~vvp_darray_object();
 
       size_t get_size(void) const;
       void set_word(unsigned adr, const vvp_object_t&value);
       void get_word(unsigned adr, vvp_object_t&value);
       void shallow_copy(const vvp_object*obj);
+      void reverse(void);
+
+    protected:
+      void get_references(std::vector<vvp_object*>&list) const;
+      void clear_references(void);
 
     private:
       std::vector<vvp_object_t> array_;
@@ -195,6 +281,8 @@ class vvp_queue_real : public vvp_queue {
       void pop_front(void) { queue.pop_front(); };
       void erase(unsigned idx);
       void erase_tail(unsigned idx);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
       std::deque<double> queue;
@@ -217,6 +305,8 @@ class vvp_queue_string : public vvp_queue {
       void pop_front(void) { queue.pop_front(); };
       void erase(unsigned idx);
       void erase_tail(unsigned idx);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
       std::deque<std::string> queue;
@@ -225,6 +315,7 @@ class vvp_queue_string : public vvp_queue {
 class vvp_queue_vec4 : public vvp_queue {
 
     public:
+      inline vvp_queue_vec4(void) : queue(false) { }
       ~vvp_queue_vec4();
 
       size_t get_size(void) const { return queue.size(); };
@@ -239,9 +330,11 @@ class vvp_queue_vec4 : public vvp_queue {
       void pop_front(void) { queue.pop_front(); };
       void erase(unsigned idx);
       void erase_tail(unsigned idx);
+      void sort(bool descending, bool signed_flag);
+      void reverse(void);
 
     private:
-      std::deque<vvp_vector4_t> queue;
+      vvp_packed_vectors queue;
 };
 
 extern string get_fileline();
@@ -25,6 +25,7 @@
 # include  "resolv.h"
 # include  "schedule.h"
 # include  "statistics.h"
+# include  "sim_profile.h"
 # include  <cstdio>
 # include  <cstring>
 # include  <cstdlib>
@@ -49,6 +50,29 @@
 permaheap vvp_net_fun_t::heap_;
 permaheap vvp_net_fil_t::heap_;
 
+static permaheap context_heap;
+static size_t context_big_total = 0;
+
+void* vvp_context_alloc(size_t size)
+{
+      size = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+	// The arena works in chunks, so very large items (big automatic
+	// arrays) are allocated on their own. They are never freed
+	// either.
+      if (size > 16*1024) {
+	    context_big_total += size;
+	    return ::operator new(size);
+      }
+
+      return context_heap.alloc(size);
+}
+
+size_t vvp_context_heap_total(void)
+{
+      return context_heap.heap_total() + context_big_total;
+}
+
 // Allocate around 1Megabyte/chunk.
 static const size_t VVP_NET_CHUNK = 1024*1024/sizeof(vvp_net_t);
 static vvp_net_t*vvp_net_alloc_table = NULL;
@@ -192,6 +216,7 @@ vvp_net_t::vvp_net_t()
 {
       fun = 0;
       fil = 0;
+      prof_entry = sim_profile_flag? sim_profile_net() : 0;
 }
 
 void vvp_net_t::link(vvp_net_ptr_t port_to_link)
@@ -277,6 +302,8 @@ vvp_net_fil_t::vvp_net_fil_t()
 {
       force_link_ = 0;
       force_propagate_ = false;
+      activity_id_ = 0;
+      toggle_id_ = 0;
       count_filters += 1;
 }
 
@@ -563,8 +590,10 @@ void vvp_send_vec8(vvp_net_ptr_t ptr, const vvp_vector8_t&val)
       while (vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_vec8(ptr, val);
+	    }
 
 	    ptr = next;
       }
@@ -575,8 +604,10 @@ void vvp_send_real(vvp_net_ptr_t ptr, double val, vvp_context_t context)
       while (vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_real(ptr, val, context);
+	    }
 
 	    ptr = next;
       }
@@ -587,8 +618,10 @@ void vvp_send_long(vvp_net_ptr_t ptr, long val)
       while (vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_long(ptr, val);
+	    }
 
 	    ptr = next;
       }
@@ -600,8 +633,10 @@ void vvp_send_long_pv(vvp_net_ptr_t ptr, long val,
       while (vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_long_pv(ptr, val, base, wid);
+	    }
 
 	    ptr = next;
       }
@@ -1779,6 +1814,63 @@ bool vvp_vector4_t::eq_xz(const vvp_vector4_t&that) const
       return true;
 }
 
+void vvp_vector4_t::get_vecval(s_vpi_vecval*vec) const
+{
+      unsigned nvec = (size_ + 31) / 32;
+      for (unsigned idx = 0 ; idx < nvec ; idx += 1) {
+	    unsigned adr = idx * 32;
+	    unsigned long atmp, btmp;
+	    if (size_ <= BITS_PER_WORD) {
+		  atmp = abits_val_ >> adr;
+		  btmp = bbits_val_ >> adr;
+	    } else {
+		  atmp = abits_ptr_[adr/BITS_PER_WORD] >> (adr%BITS_PER_WORD);
+		  btmp = bbits_ptr_[adr/BITS_PER_WORD] >> (adr%BITS_PER_WORD);
+	    }
+	      // Clear any bits past the end of the vector.
+	    if (size_ - adr < 32) {
+		  unsigned long mask = (1UL << (size_ - adr)) - 1UL;
+		  atmp &= mask;
+		  btmp &= mask;
+	    }
+	    vec[idx].aval = (PLI_INT32) (atmp & 0xffffffffUL);
+	    vec[idx].bval = (PLI_INT32) (btmp & 0xffffffffUL);
+      }
+}
+
+void vvp_vector4_t::set_vecval(const s_vpi_vecval*vec)
+{
+      if (size_ <= BITS_PER_WORD) {
+	    abits_val_ = 0;
+	    bbits_val_ = 0;
+      } else {
+	    unsigned words = (size_ + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	    for (unsigned idx = 0 ; idx < words ; idx += 1) {
+		  abits_ptr_[idx] = 0;
+		  bbits_ptr_[idx] = 0;
+	    }
+      }
+
+      unsigned nvec = (size_ + 31) / 32;
+      for (unsigned idx = 0 ; idx < nvec ; idx += 1) {
+	    unsigned adr = idx * 32;
+	    unsigned long atmp = (PLI_UINT32) vec[idx].aval;
+	    unsigned long btmp = (PLI_UINT32) vec[idx].bval;
+	    if (size_ - adr < 32) {
+		  unsigned long mask = (1UL << (size_ - adr)) - 1UL;
+		  atmp &= mask;
+		  btmp &= mask;
+	    }
+	    if (size_ <= BITS_PER_WORD) {
+		  abits_val_ |= atmp << adr;
+		  bbits_val_ |= btmp << adr;
+	    } else {
+		  abits_ptr_[adr/BITS_PER_WORD] |= atmp << (adr%BITS_PER_WORD);
+		  bbits_ptr_[adr/BITS_PER_WORD] |= btmp << (adr%BITS_PER_WORD);
+	    }
+      }
+}
+
 bool vvp_vector4_t::has_xz() const
 {
       if (size_ < BITS_PER_WORD) {
@@ -2263,7 +2355,8 @@ vvp_vector4array_aa::~vvp_vector4array_aa()
 
 void vvp_vector4array_aa::alloc_instance(vvp_context_t context)
 {
-      v4cell*array = new v4cell[words_];
+      v4cell*array = static_cast<v4cell*>
+	    (vvp_context_alloc(words_ * sizeof(v4cell)));
 
       if (width_ <= vvp_vector4_t::BITS_PER_WORD) {
 	    for (unsigned idx = 0 ; idx < words_ ; idx += 1) {
@@ -2310,7 +2403,10 @@ void vvp_vector4array_aa::free_instance(vvp_context_t context)
 {
       v4cell*cell = static_cast<v4cell*>
             (vvp_get_context_item(context, context_idx_));
-      delete [] cell;
+      if (width_ > vvp_vector4_t::BITS_PER_WORD) {
+	    for (unsigned idx = 0 ; idx < words_ ; idx += 1)
+		  delete [] cell[idx].abits_ptr_;
+      }
 }
 #endif
 
@@ -3350,6 +3446,39 @@ void vvp_net_fun_t::force_flag(bool)
 {
 }
 
+/* **** vvp_output_cache4 methods **** */
+
+unsigned long count_cached_sends = 0;
+unsigned long count_cached_sends_suppressed = 0;
+
+vvp_output_cache4::vvp_output_cache4()
+: out_valid_(false)
+{
+      __vpiScope*scope = vpip_peek_current_scope();
+      enabled_ = scope == 0 || ! scope->is_automatic();
+}
+
+void vvp_output_cache4::send_vec4_cached(vvp_net_t*net, const vvp_vector4_t&val)
+{
+      if (! enabled_) {
+	    net->send_vec4(val, 0);
+	    return;
+      }
+
+      count_cached_sends += 1;
+      if (out_valid_ && out_.eeq(val)) {
+	    count_cached_sends_suppressed += 1;
+	    return;
+      }
+
+	// Save the value before sending it, as the send may find its
+	// way back to this functor. Send the caller's value and not
+	// the copy, as a send that comes back will replace the copy.
+      out_ = val;
+      out_valid_ = true;
+      net->send_vec4(val, 0);
+}
+
 /* **** vvp_fun_drive methods **** */
 
 vvp_fun_drive::vvp_fun_drive(unsigned str0, unsigned str1)
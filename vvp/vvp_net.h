@@ -63,17 +63,41 @@ class  vvp_delay_t;
 
 /*
  * Storage for items declared in automatically allocated scopes (i.e. automatic
- * tasks and functions). The first two slots in each context are reserved for
+ * tasks and functions). The first three slots in each context are reserved for
  * linking to other contexts. The function that adds items to a context knows
  * this, and allocates context indices accordingly.
+ *
+ * A context is never returned to the heap. When it is no longer in use it
+ * goes on the free list of its scope to be reused, so the contexts and the
+ * instance storage of their items are carved out of an arena instead of
+ * being allocated one at a time. Objects placed in the arena with
+ * vvp_context_new() are destroyed with vvp_context_delete().
  */
 typedef void**vvp_context_t;
 
 typedef void*vvp_context_item_t;
 
+extern void* vvp_context_alloc(size_t size);
+extern size_t vvp_context_heap_total(void);
+
+template <class T> inline T* vvp_context_new(void)
+{
+      return new (vvp_context_alloc(sizeof(T))) T;
+}
+
+template <class T, class A> inline T* vvp_context_new(const A&arg)
+{
+      return new (vvp_context_alloc(sizeof(T))) T(arg);
+}
+
+template <class T> inline void vvp_context_delete(T*item)
+{
+      item->~T();
+}
+
 inline vvp_context_t vvp_allocate_context(unsigned nitem)
 {
-      return (vvp_context_t)malloc((2 + nitem) * sizeof(void*));
+      return (vvp_context_t)vvp_context_alloc((3 + nitem) * sizeof(void*));
 }
 
 inline vvp_context_t vvp_get_next_context(vvp_context_t context)
@@ -96,6 +120,16 @@ inline void vvp_set_stacked_context(vvp_context_t context, vvp_context_t stack)
       context[1] = stack;
 }
 
+inline vvp_context_t vvp_get_prev_context(vvp_context_t context)
+{
+      return (vvp_context_t)context[2];
+}
+
+inline void vvp_set_prev_context(vvp_context_t context, vvp_context_t prev)
+{
+      context[2] = prev;
+}
+
 inline vvp_context_item_t vvp_get_context_item(vvp_context_t context,
                                                unsigned item_idx)
 {
@@ -247,6 +281,7 @@ class vvp_vector4_t {
       friend class vvp_vector4array_t;
       friend class vvp_vector4array_sa;
       friend class vvp_vector4array_aa;
+      friend class vvp_packed_vectors;
 
     public:
       static const vvp_vector4_t nil;
@@ -283,6 +318,13 @@ class vvp_vector4_t {
       unsigned long*subarray(unsigned idx, unsigned size, bool xz_to_0 =false) const;
       void setarray(unsigned idx, unsigned size, const unsigned long*val);
 
+	// Get/set the entire 4-value vector as an array of VPI vecval
+	// words. The vecval aval/bval encoding is the same as the
+	// abits/bbits encoding, so these are simple word copies. The
+	// array must have (size()+31)/32 entries.
+      void get_vecval(s_vpi_vecval*vec) const;
+      void set_vecval(const s_vpi_vecval*vec);
+
 	// Set a 4-value bit or subvector into the vector. Return true
 	// if any bits of the vector change as a result of this operation.
       void set_bit(unsigned idx, vvp_bit4_t val);
@@ -312,6 +354,11 @@ class vvp_vector4_t {
 	// Return true if there is an X or Z anywhere in the vector.
       bool has_xz() const;
 
+	// If the vector fits in an unsigned long and has no X or Z
+	// bits, return true with its value in val. This is a cheap
+	// alternative to vector4_to_value for small vectors.
+      bool get_ulong(unsigned long&val) const;
+
 	// Change all Z bits to X bits.
       void change_z2x();
 
@@ -469,6 +516,19 @@ inline vvp_bit4_t vvp_vector4_t::value(unsigned idx) const
       return (vvp_bit4_t)tmp;
 }
 
+inline bool vvp_vector4_t::get_ulong(unsigned long&val) const
+{
+      if (size_ > BITS_PER_WORD)
+	    return false;
+
+      unsigned long mask = (size_ < BITS_PER_WORD)? (1UL << size_) - 1UL : -1UL;
+      if (bbits_val_ & mask)
+	    return false;
+
+      val = abits_val_ & mask;
+      return true;
+}
+
 inline vvp_vector4_t vvp_vector4_t::subvalue(unsigned adr, unsigned wid) const
 {
       return vvp_vector4_t(*this, adr, wid);
@@ -1126,6 +1186,9 @@ class vvp_net_t {
       vvp_net_ptr_t port[4];
       vvp_net_fun_t*fun;
       vvp_net_fil_t*fil;
+	// The simulation profiler entry of the scope that this net
+	// was compiled in. This is only set when profiling.
+      struct sim_profile_entry*prof_entry;
 
     public:
 	// Connect the port to the output from this net.
@@ -1272,6 +1335,10 @@ class vvp_net_fun_t {
  * The filter object also provides an implementation hooks for
  * force/release.
  */
+extern void net_activity_count(unsigned id, bool changed);
+extern void coverage_toggle(unsigned id, const vvp_vector4_t&old,
+                            const vvp_vector4_t&val, unsigned base);
+
 class vvp_net_fil_t  : public vvp_vpi_callback {
 
     public:
@@ -1311,6 +1378,24 @@ class vvp_net_fil_t  : public vvp_vpi_callback {
 
       virtual unsigned filter_size() const =0;
 
+	// Net activity counting (see net_activity.h). A non-zero
+	// activity id marks this filter as counted. The filter, or
+	// the functor that feeds it, calls count_activity() for each
+	// value written to the net.
+      unsigned get_activity_id() const { return activity_id_; }
+      void set_activity_id(unsigned id) { activity_id_ = id; }
+      inline void count_activity(bool changed) const
+      { if (activity_id_) net_activity_count(activity_id_, changed); }
+
+	// Toggle coverage (see coverage.h). A non-zero toggle id marks
+	// this filter as covered. The filter calls count_toggles()
+	// with the old value before it takes a changed value.
+      unsigned get_toggle_id() const { return toggle_id_; }
+      void set_toggle_id(unsigned id) { toggle_id_ = id; }
+      inline void count_toggles(const vvp_vector4_t&old,
+                                const vvp_vector4_t&val, unsigned base) const
+      { if (toggle_id_) coverage_toggle(toggle_id_, old, val, base); }
+
     public:
 	// Support for force methods. These are called by the
 	// vvp_net_t::force_* methods to set the force value and mask
@@ -1369,10 +1454,42 @@ class vvp_net_fil_t  : public vvp_vpi_callback {
       bool force_propagate_;
 	// force link back.
       class vvp_net_t*force_link_;
+	// Index of the activity counters, or 0.
+      unsigned activity_id_;
+	// Index of the toggle coverage record, or 0.
+      unsigned toggle_id_;
 };
 
 /* **** Some core net functions **** */
 
+/*
+ * Functors that compute their output from scratch each time an input
+ * changes often compute the same output again, for example when an
+ * input bit that is masked by another input changes. Such functors
+ * can derive from this class and send their output with the
+ * send_vec4_cached() method instead of the send_vec4() method of the
+ * net. The output is compared with the previous output, and is not
+ * sent if it is bit-for-bit the same. This saves the receivers from
+ * evaluating (and scheduling) the same value again.
+ *
+ * A functor in an automatically allocated scope serves all the
+ * contexts of the scope, so there is no single previous output to
+ * compare with. The cache is disabled for those functors.
+ */
+class vvp_output_cache4 {
+
+    public:
+      vvp_output_cache4();
+
+    protected:
+      void send_vec4_cached(vvp_net_t*net, const vvp_vector4_t&val);
+
+    private:
+      vvp_vector4_t out_;
+      bool out_valid_;
+      bool enabled_;
+};
+
 /* vvp_fun_concat
  * This node function creates vectors (vvp_vector4_t) from the
  * concatenation of the inputs. The inputs (4) may be vector or
@@ -1384,7 +1501,7 @@ class vvp_net_fil_t  : public vvp_vpi_callback {
  * output vector) can be worked out. The input vectors must match the
  * expected width.
  */
-class vvp_fun_concat  : public vvp_net_fun_t {
+class vvp_fun_concat  : public vvp_net_fun_t, private vvp_output_cache4 {
 
     public:
       vvp_fun_concat(unsigned w0, unsigned w1,
@@ -1451,7 +1568,7 @@ class vvp_fun_force : public vvp_net_fun_t {
  * times to repeat the input. The width of the input vector is
  * implicit from these values.
  */
-class vvp_fun_repeat  : public vvp_net_fun_t {
+class vvp_fun_repeat  : public vvp_net_fun_t, private vvp_output_cache4 {
 
     public:
       vvp_fun_repeat(unsigned width, unsigned repeat);
@@ -1500,7 +1617,7 @@ class vvp_fun_drive  : public vvp_net_fun_t {
  * input is already wider than the desired output, then it is passed
  * unmodified.
  */
-class vvp_fun_extend_signed  : public vvp_net_fun_t {
+class vvp_fun_extend_signed  : public vvp_net_fun_t, private vvp_output_cache4 {
 
     public:
       explicit vvp_fun_extend_signed(unsigned wid);
@@ -1602,14 +1719,23 @@ class vvp_wide_fun_t : public vvp_net_fun_t {
       unsigned port_base_;
 };
 
+/*
+ * When the simulation profiler is enabled (see sim_profile.h) each
+ * delivery of a value to a functor is counted against the scope that
+ * the functor was compiled in.
+ */
+extern bool sim_profile_flag;
+extern void sim_profile_functor(vvp_net_t*net);
 
 inline void vvp_send_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&val, vvp_context_t context)
 {
       while (class vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_vec4(ptr, val, context);
+	    }
 
 	    ptr = next;
       }
@@ -1627,8 +1753,10 @@ inline void vvp_send_string(vvp_net_ptr_t ptr, const std::string&val, vvp_contex
       while (vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_string(ptr, val, context);
+	    }
 
 	    ptr = next;
       }
@@ -1639,8 +1767,10 @@ inline void vvp_send_object(vvp_net_ptr_t ptr, vvp_object_t val, vvp_context_t c
       while (vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_object(ptr, val, context);
+	    }
 
 	    ptr = next;
       }
@@ -1672,8 +1802,10 @@ inline void vvp_send_vec4_pv(vvp_net_ptr_t ptr, const vvp_vector4_t&val,
       while (class vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_vec4_pv(ptr, val, base, wid, vwid, context);
+	    }
 
 	    ptr = next;
       }
@@ -1685,8 +1817,10 @@ inline void vvp_send_vec8_pv(vvp_net_ptr_t ptr, const vvp_vector8_t&val,
       while (class vvp_net_t*cur = ptr.ptr()) {
 	    vvp_net_ptr_t next = cur->port[ptr.port()];
 
-	    if (cur->fun)
+	    if (cur->fun) {
+		  if (sim_profile_flag) sim_profile_functor(cur);
 		  cur->fun->recv_vec8_pv(ptr, val, base, wid, vwid);
+	    }
 
 	    ptr = next;
       }
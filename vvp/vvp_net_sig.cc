@@ -182,6 +182,10 @@ void vvp_fun_signal4_sa::recv_vec4(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
 			bits4_ = bit;
 			needs_init_ = false;
 			ptr.ptr()->send_vec4(bits4_, 0);
+		  } else if (vvp_net_fil_t*fil = ptr.ptr()->fil) {
+			  // A write of the same value stops here, so
+			  // the filter does not see it.
+			fil->count_activity(false);
 		  }
 	    } else {
 		  bool changed = false;
@@ -349,7 +353,7 @@ vvp_fun_signal4_aa::~vvp_fun_signal4_aa()
 
 void vvp_fun_signal4_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new vvp_vector4_t(size_));
+      vvp_set_context_item(context, context_idx_, vvp_context_new<vvp_vector4_t>(size_));
 }
 
 void vvp_fun_signal4_aa::reset_instance(vvp_context_t context)
@@ -365,7 +369,7 @@ void vvp_fun_signal4_aa::free_instance(vvp_context_t context)
 {
       vvp_vector4_t*bits = static_cast<vvp_vector4_t*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      vvp_context_delete(bits);
 }
 #endif
 
@@ -508,7 +512,7 @@ vvp_fun_signal_real_aa::~vvp_fun_signal_real_aa()
 
 void vvp_fun_signal_real_aa::alloc_instance(vvp_context_t context)
 {
-      double*bits = new double;
+      double*bits = vvp_context_new<double>();
       vvp_set_context_item(context, context_idx_, bits);
 
       *bits = 0.0;
@@ -527,7 +531,7 @@ void vvp_fun_signal_real_aa::free_instance(vvp_context_t context)
 {
       double*bits = static_cast<double*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      vvp_context_delete(bits);
 }
 #endif
 
@@ -627,7 +631,7 @@ vvp_fun_signal_string_aa::~vvp_fun_signal_string_aa()
 
 void vvp_fun_signal_string_aa::alloc_instance(vvp_context_t context)
 {
-      string*bits = new std::string;
+      string*bits = vvp_context_new<std::string>();
       vvp_set_context_item(context, context_idx_, bits);
       *bits = "";
 }
@@ -644,7 +648,7 @@ void vvp_fun_signal_string_aa::free_instance(vvp_context_t context)
 {
       string*bits = static_cast<std::string*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      vvp_context_delete(bits);
 }
 #endif
 
@@ -721,7 +725,7 @@ void vvp_fun_signal_object_aa::free_instance(vvp_context_t context)
 {
       vvp_object_t*bits = static_cast<vvp_object_t*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      vvp_context_delete(bits);
 }
 #endif
 
@@ -756,7 +760,7 @@ vvp_fun_signal_object_aa::~vvp_fun_signal_object_aa()
 
 void vvp_fun_signal_object_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_object_t*bits = new vvp_object_t;
+      vvp_object_t*bits = vvp_context_new<vvp_object_t>();
       vvp_set_context_item(context, context_idx_, bits);
       bits->reset();
 }
@@ -904,13 +908,22 @@ vvp_net_fil_t::prop_t vvp_wire_vec4::filter_vec4(const vvp_vector4_t&bit, vvp_ve
 	// Keep track of the value being driven from this net, even if
 	// it is not ultimately what survives the force filter.
       if (base==0 && bit.size()==vwid) {
-	    if (bits4_ .eeq( bit ) && !needs_init_) return STOP;
+	    if (bits4_ .eeq( bit ) && !needs_init_) {
+		  count_activity(false);
+		  return STOP;
+	    }
+	    count_toggles(bits4_, bit, 0);
 	    bits4_ = bit;
       } else {
+	    count_toggles(bits4_, bit, base);
 	    bool rc = bits4_.set_vec(base, bit);
-	    if (rc == false && !needs_init_) return STOP;
+	    if (rc == false && !needs_init_) {
+		  count_activity(false);
+		  return STOP;
+	    }
       }
 
+      count_activity(true);
       needs_init_ = false;
       return filter_mask_(bit, force4_, rep, base);
 }
@@ -926,13 +939,22 @@ vvp_net_fil_t::prop_t vvp_wire_vec4::filter_vec8(const vvp_vector8_t&bit,
 	// it is not ultimately what survives the force filter.
       vvp_vector4_t bit4 (reduce4(bit));
       if (base==0 && bit4.size()==vwid) {
-	    if (bits4_ .eeq( bit4 ) && !needs_init_) return STOP;
+	    if (bits4_ .eeq( bit4 ) && !needs_init_) {
+		  count_activity(false);
+		  return STOP;
+	    }
+	    count_toggles(bits4_, bit4, 0);
 	    bits4_ = bit4;
       } else {
+	    count_toggles(bits4_, bit4, base);
 	    bool rc = bits4_.set_vec(base, bit4);
-	    if (rc == false && !needs_init_) return STOP;
+	    if (rc == false && !needs_init_) {
+		  count_activity(false);
+		  return STOP;
+	    }
       }
 
+      count_activity(true);
       needs_init_ = false;
       return filter_mask_(bit, vvp_vector8_t(force4_,6,6), rep, base);
 }
@@ -1086,6 +1108,19 @@ vvp_net_fil_t::prop_t vvp_wire_vec8::filter_vec4(const vvp_vector4_t&bit,
 vvp_net_fil_t::prop_t vvp_wire_vec8::filter_vec8(const vvp_vector8_t&bit, vvp_vector8_t&rep, unsigned base, unsigned vwid)
 {
       assert(vwid == bits8_.size());
+	// The value is always propagated, so the activity counting
+	// needs to compare the old and new values itself.
+      if (get_activity_id()) {
+	    if (needs_init_)
+		  count_activity(true);
+	    else if (base==0 && bit.size()==vwid)
+		  count_activity(! bits8_.eeq(bit));
+	    else
+		  count_activity(! bits8_.subvalue(base, bit.size()).eeq(bit));
+      }
+      if (get_toggle_id())
+	    count_toggles(reduce4(bits8_), reduce4(bit), base);
+
 	// Keep track of the value being driven from this net, even if
 	// it is not ultimately what survives the force filter.
       if (base==0 && bit.size()==vwid) {
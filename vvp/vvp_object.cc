@@ -19,20 +19,295 @@
 
 # include  "vvp_object.h"
 # include  "vvp_net.h"
+# include  "statistics.h"
 # include  <iostream>
 # include  <typeinfo>
+# include  <climits>
+# include  <cstring>
+# include  <cstdio>
 
 using namespace std;
 
 int vvp_object::total_active_cnt_ = 0;
+bool vvp_object::cycle_collect_flag_ = false;
+bool vvp_object::cycle_pending_ = false;
+
+unsigned long count_cycle_collections = 0;
+unsigned long count_cycle_reclaimed = 0;
+
+/*
+ * The cycle collector is the synchronous trial deletion algorithm of
+ * Bacon and Rajan. The candidates are the objects whose reference
+ * count was decremented but did not reach zero, so they may be kept
+ * alive only by a cycle. There is no need to find the roots (the
+ * signals, thread stacks and automatic contexts) because any
+ * reference from outside the objects traced from the candidates
+ * shows up as a reference count that is not accounted for by the
+ * traced references.
+ *
+ * The candidates are kept on a doubly linked list so that an object
+ * that is deleted normally can quickly remove itself.
+ */
+enum { CYCLE_BLACK = 0, CYCLE_GRAY, CYCLE_WHITE };
+
+static const unsigned long CYCLE_THRESHOLD_DEFAULT = 10000;
+static unsigned long cycle_threshold_base = CYCLE_THRESHOLD_DEFAULT;
+static unsigned long cycle_threshold = CYCLE_THRESHOLD_DEFAULT;
+
+static vvp_object*cycle_candidates = 0;
+static unsigned long cycle_candidate_cnt = 0;
+
+  // Work lists for the traversals. These are kept between
+  // collections so that they do not need to be reallocated.
+static vector<vvp_object*> cycle_work;
+static vector<vvp_object*> cycle_refs;
 
 void vvp_object::cleanup(void)
 {
+      cycle_work = vector<vvp_object*>();
+      cycle_refs = vector<vvp_object*>();
 }
 
 vvp_object::~vvp_object()
 {
       total_active_cnt_ -= 1;
+      if (cycle_candidate_)
+	    remove_candidate_();
+}
+
+void vvp_object::get_references(vector<vvp_object*>&) const
+{
+}
+
+void vvp_object::clear_references(void)
+{
+}
+
+void vvp_object::cycle_collector_args(int argc, char*argv[])
+{
+      for (int idx = 0 ;  idx < argc ;  idx += 1) {
+	    const char*arg = argv[idx];
+	    if (strcmp(arg, "-collect-cycles") == 0) {
+		  cycle_collect_flag_ = true;
+
+	    } else if (strncmp(arg, "-collect-cycles=", 16) == 0) {
+		  char*ep;
+		  unsigned long val = strtoul(arg+16, &ep, 10);
+		  if (*ep || val == 0) {
+			fprintf(stderr, "Warning: Invalid cycle collection "
+			        "threshold \"%s\".\n", arg+16);
+		  } else {
+			cycle_threshold_base = val;
+			cycle_threshold = val;
+		  }
+		  cycle_collect_flag_ = true;
+	    }
+      }
+}
+
+void vvp_object::possible_cycle_(void)
+{
+      if (cycle_candidate_)
+	    return;
+
+      cycle_candidate_ = true;
+      cycle_prev_ = 0;
+      cycle_next_ = cycle_candidates;
+      if (cycle_candidates)
+	    cycle_candidates->cycle_prev_ = this;
+      cycle_candidates = this;
+
+      cycle_candidate_cnt += 1;
+      if (cycle_candidate_cnt >= cycle_threshold)
+	    cycle_pending_ = true;
+}
+
+void vvp_object::remove_candidate_(void)
+{
+      assert(cycle_candidate_);
+      if (cycle_prev_)
+	    cycle_prev_->cycle_next_ = cycle_next_;
+      else
+	    cycle_candidates = cycle_next_;
+      if (cycle_next_)
+	    cycle_next_->cycle_prev_ = cycle_prev_;
+
+      cycle_prev_ = 0;
+      cycle_next_ = 0;
+      cycle_candidate_ = false;
+      cycle_candidate_cnt -= 1;
+}
+
+/*
+ * Subtract the references from the objects reachable from the root,
+ * marking them gray as they are visited. What is left in the count
+ * of a gray object is the references from outside the gray objects.
+ */
+void vvp_object::mark_gray_(vvp_object*root)
+{
+      if (root->cycle_color_ == CYCLE_GRAY)
+	    return;
+
+      root->cycle_color_ = CYCLE_GRAY;
+      cycle_work.push_back(root);
+      while (! cycle_work.empty()) {
+	    vvp_object*cur = cycle_work.back();
+	    cycle_work.pop_back();
+
+	    cycle_refs.clear();
+	    cur->get_references(cycle_refs);
+	    for (size_t idx = 0 ; idx < cycle_refs.size() ; idx += 1) {
+		  vvp_object*tmp = cycle_refs[idx];
+		  tmp->ref_cnt_ -= 1;
+		  if (tmp->cycle_color_ != CYCLE_GRAY) {
+			tmp->cycle_color_ = CYCLE_GRAY;
+			cycle_work.push_back(tmp);
+		  }
+	    }
+      }
+}
+
+/*
+ * A gray object that still has references is alive, and so is
+ * everything it refers to. The others are marked white, as garbage,
+ * unless they are later found to be reachable from a live object.
+ */
+void vvp_object::scan_(vvp_object*root)
+{
+      cycle_work.push_back(root);
+      while (! cycle_work.empty()) {
+	    vvp_object*cur = cycle_work.back();
+	    cycle_work.pop_back();
+
+	    if (cur->cycle_color_ != CYCLE_GRAY)
+		  continue;
+
+	    if (cur->ref_cnt_ > 0) {
+		  scan_black_(cur);
+		  continue;
+	    }
+
+	    cur->cycle_color_ = CYCLE_WHITE;
+	    cycle_refs.clear();
+	    cur->get_references(cycle_refs);
+	    cycle_work.insert(cycle_work.end(), cycle_refs.begin(), cycle_refs.end());
+      }
+}
+
+/*
+ * Restore the references from the objects reachable from a live
+ * object, and mark them black. This uses its own work list because
+ * it is called from within scan_().
+ */
+void vvp_object::scan_black_(vvp_object*root)
+{
+      vector<vvp_object*> work;
+
+      root->cycle_color_ = CYCLE_BLACK;
+      work.push_back(root);
+      while (! work.empty()) {
+	    vvp_object*cur = work.back();
+	    work.pop_back();
+
+	    cycle_refs.clear();
+	    cur->get_references(cycle_refs);
+	    for (size_t idx = 0 ; idx < cycle_refs.size() ; idx += 1) {
+		  vvp_object*tmp = cycle_refs[idx];
+		  tmp->ref_cnt_ += 1;
+		  if (tmp->cycle_color_ != CYCLE_BLACK) {
+			tmp->cycle_color_ = CYCLE_BLACK;
+			work.push_back(tmp);
+		  }
+	    }
+      }
+}
+
+void vvp_object::collect_white_(vvp_object*root, vector<vvp_object*>&garbage)
+{
+      if (root->cycle_color_ != CYCLE_WHITE)
+	    return;
+
+      root->cycle_color_ = CYCLE_BLACK;
+      garbage.push_back(root);
+      cycle_work.push_back(root);
+      while (! cycle_work.empty()) {
+	    vvp_object*cur = cycle_work.back();
+	    cycle_work.pop_back();
+
+	    cycle_refs.clear();
+	    cur->get_references(cycle_refs);
+	    for (size_t idx = 0 ; idx < cycle_refs.size() ; idx += 1) {
+		  vvp_object*tmp = cycle_refs[idx];
+		  if (tmp->cycle_color_ == CYCLE_WHITE) {
+			tmp->cycle_color_ = CYCLE_BLACK;
+			garbage.push_back(tmp);
+			cycle_work.push_back(tmp);
+		  }
+	    }
+      }
+}
+
+/*
+ * This must only be called when no object is referenced by a bare
+ * pointer, which is the case between scheduled events.
+ */
+void vvp_object::collect_cycles(void)
+{
+      cycle_pending_ = false;
+      count_cycle_collections += 1;
+
+      vector<vvp_object*> roots;
+      roots.reserve(cycle_candidate_cnt);
+      while (cycle_candidates) {
+	    vvp_object*cur = cycle_candidates;
+	    cur->remove_candidate_();
+	    roots.push_back(cur);
+      }
+
+      for (size_t idx = 0 ; idx < roots.size() ; idx += 1)
+	    mark_gray_(roots[idx]);
+      for (size_t idx = 0 ; idx < roots.size() ; idx += 1)
+	    scan_(roots[idx]);
+
+      vector<vvp_object*> garbage;
+      for (size_t idx = 0 ; idx < roots.size() ; idx += 1)
+	    collect_white_(roots[idx], garbage);
+
+	// The trial deletion left the references from the garbage
+	// subtracted, so put them back. The references to the live
+	// objects are then released normally by clear_references().
+	// The garbage objects are given a count that cannot reach
+	// zero so that they are only deleted here.
+      for (size_t idx = 0 ; idx < garbage.size() ; idx += 1) {
+	    cycle_refs.clear();
+	    garbage[idx]->get_references(cycle_refs);
+	    for (size_t ref = 0 ; ref < cycle_refs.size() ; ref += 1)
+		  cycle_refs[ref]->ref_cnt_ += 1;
+      }
+      for (size_t idx = 0 ; idx < garbage.size() ; idx += 1) {
+	    garbage[idx]->ref_cnt_ = INT_MAX;
+	    garbage[idx]->may_cycle_ = false;
+      }
+
+      size_t live = 0;
+      for (size_t idx = 0 ; idx < roots.size() ; idx += 1) {
+	    if (roots[idx]->ref_cnt_ != INT_MAX)
+		  live += 1;
+      }
+
+      for (size_t idx = 0 ; idx < garbage.size() ; idx += 1)
+	    garbage[idx]->clear_references();
+      for (size_t idx = 0 ; idx < garbage.size() ; idx += 1)
+	    delete garbage[idx];
+
+      count_cycle_reclaimed += garbage.size();
+
+	// If most of the candidates were live, wait for more of them
+	// before collecting again so that the live objects are not
+	// traced over and over.
+      cycle_threshold = cycle_threshold_base;
+      if (2*live > cycle_threshold)
+	    cycle_threshold = 2*live;
 }
 
 void vvp_object::shallow_copy(const vvp_object*)
@@ -20,27 +20,75 @@
  */
 
 # include  <stdlib.h>
+# include  <vector>
+
+class vvp_object_t;
 
 /*
  * A vvp_object is a garbage collected object such as a darray or
  * class object. The vvp_object class is a virtual base class and not
  * generally used directly. Instead, use the vvp_object_t object as a
  * smart pointer. This makes garbage collection automatic.
+ *
+ * Reference counting alone cannot reclaim objects that refer to each
+ * other in a cycle, so there is also an optional cycle collector
+ * (enabled by the -collect-cycles extended argument). Objects that
+ * can hold references to other objects are noted as possible cycle
+ * members when a reference to them is released but they remain
+ * alive. When enough of these candidates have collected, the
+ * collector runs between scheduled events and reclaims any of them
+ * that are only kept alive by references from other candidates.
  */
 class vvp_object {
     public:
-      inline vvp_object() { ref_cnt_ = 0; total_active_cnt_ += 1; }
+      inline vvp_object()
+      : ref_cnt_(0), may_cycle_(false), cycle_candidate_(false),
+        cycle_color_(0), cycle_prev_(0), cycle_next_(0)
+      { total_active_cnt_ += 1; }
       virtual ~vvp_object() =0;
 
       virtual void shallow_copy(const vvp_object*that);
 
       static void cleanup(void);
 
+	// Look for the -collect-cycles[=<threshold>] extended argument.
+      static void cycle_collector_args(int argc, char*argv[]);
+	// True if enough candidates have collected that the cycle
+	// collector should be run at the next safe point.
+      static inline bool cycle_collect_pending(void)
+      { return cycle_pending_; }
+      static void collect_cycles(void);
+
+    protected:
+	// Classes that can hold references to other objects call this
+	// from their constructor to take part in cycle collection.
+      inline void set_may_cycle(void) { may_cycle_ = cycle_collect_flag_; }
+
+	// Add to the list the objects that this object refers to.
+      virtual void get_references(std::vector<vvp_object*>&list) const;
+	// Drop all the references that this object holds.
+      virtual void clear_references(void);
+
     private:
       friend class vvp_object_t;
+      void possible_cycle_(void);
+      void remove_candidate_(void);
+
+      static void mark_gray_(vvp_object*root);
+      static void scan_(vvp_object*root);
+      static void scan_black_(vvp_object*root);
+      static void collect_white_(vvp_object*root, std::vector<vvp_object*>&garbage);
+
       int ref_cnt_;
+      bool may_cycle_;
+      bool cycle_candidate_;
+      unsigned char cycle_color_;
+      vvp_object*cycle_prev_;
+      vvp_object*cycle_next_;
 
       static int total_active_cnt_;
+      static bool cycle_collect_flag_;
+      static bool cycle_pending_;
 };
 
 class vvp_object_t {
@@ -96,6 +144,7 @@ inline void vvp_object_t::reset(class vvp_object*tgt)
       if (ref_) {
 	    ref_->ref_cnt_ -= 1;
 	    if (ref_->ref_cnt_ <= 0) delete ref_;
+	    else if (ref_->may_cycle_) ref_->possible_cycle_();
 	    ref_ = 0;
       }
       ref_ = tgt;
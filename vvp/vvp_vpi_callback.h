@@ -41,6 +41,11 @@ class vvp_vpi_callback {
       void attach_as_word(struct __vpiArray* arr, unsigned long addr);
 
       void add_vpi_callback(value_callback*);
+
+	// Native value change tracing (see vpip_trace_add). A non-zero
+	// trace id is the first trace entry of this object.
+      unsigned get_trace_id() const { return trace_id_; }
+      void set_trace_id(unsigned id) { trace_id_ = id; }
 #ifdef CHECK_WITH_VALGRIND
 	/* This has only been tested at EOS. */
       void clear_all_callbacks(void);
@@ -58,6 +63,7 @@ class vvp_vpi_callback {
     private:
       value_callback*vpi_callbacks_;
       struct __vpi_array_word*array_words_;
+      unsigned trace_id_;
 };
 
 